@@ -1,9 +1,11 @@
 ﻿#include "core/Application.h"
+#include "core/CommandLine.h"
 #include <cstring>
 
 int main(int argc, char** argv)
 {
     Application app;
+    app.SetLaunchOptions(CommandLine::Parse(argc, argv));
 
     if (!app.Initialize())
         return -1;
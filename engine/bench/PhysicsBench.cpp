@@ -0,0 +1,596 @@
+#include "../core/FrameArena.h"
+#include "../core/JobSystem.h"
+#include "../ecs/World.h"
+#include "../ecs/components/ColliderComponent.h"
+#include "../ecs/components/RigidbodyComponent.h"
+#include "../ecs/components/TransformComponent.h"
+#include "../ecs/systems/PhysicsSystem.h"
+#include "../physics/NarrowphaseKernels.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless physics scenarios: each one builds a procedural scene, runs
+// PhysicsSystem::Update for a fixed number of ticks per job thread count and
+// reports ms per step by phase, pairs, contacts and how much the bodies drift
+// and jitter. Sleeping is disabled unless --sleep is given, so every timed tick
+// solves the full contact graph; --adaptive lets each island pick its own
+// substep count and --lod turns on distance LOD around the origin. --json
+// writes the same numbers for comparing two builds; the position hash shows
+// whether results match across thread counts.
+
+namespace
+{
+using ecs::Vec3;
+
+constexpr float kTickDt = 1.0f / 60.0f;
+
+struct BenchOptions
+{
+    int boxes = 4000;
+    int warmupTicks = 60;
+    int ticks = 240;
+    bool sleep = false;
+    bool adaptiveSubsteps = false;
+    bool lod = false;
+    std::vector<std::string> scenarios;
+    std::vector<std::uint32_t> threadCounts;
+    std::string jsonPath;
+};
+
+struct Random
+{
+    std::uint32_t state = 0x9E3779B9u;
+
+    // Uniform in [min, max).
+    float Range(float min, float max)
+    {
+        state = state * 1664525u + 1013904223u;
+        return min + (max - min) * (static_cast<float>(state >> 8) / 16777216.0f);
+    }
+};
+
+struct SceneBuilder
+{
+    ecs::World& world;
+    // Dynamic bodies the scene is built from; drift and jitter are measured on these.
+    std::vector<ecs::Entity> bodies;
+    // Bodies spawned while the scenario runs; hashed, but not part of the stability metrics.
+    std::vector<ecs::Entity> spawned;
+    Random random;
+
+    ecs::Entity AddStaticBox(const Vec3& position, const Vec3& halfExtents, const Vec3& rotation = Vec3{})
+    {
+        const ecs::Entity entity = world.CreateEntity();
+        auto& transform = world.AddComponent<ecs::TransformComponent>(entity);
+        transform.position = position;
+        transform.rotation = rotation;
+        world.AddComponent<ecs::ColliderComponent>(entity).halfExtents = halfExtents;
+        world.AddComponent<ecs::RigidbodyComponent>(entity).isStatic = true;
+        return entity;
+    }
+
+    ecs::Entity AddBox(const Vec3& position, const Vec3& halfExtents)
+    {
+        const ecs::Entity entity = AddDynamic(position);
+        world.AddComponent<ecs::ColliderComponent>(entity).halfExtents = halfExtents;
+        return entity;
+    }
+
+    ecs::Entity AddSphere(const Vec3& position, float radius)
+    {
+        const ecs::Entity entity = AddDynamic(position);
+        auto& collider = world.AddComponent<ecs::ColliderComponent>(entity);
+        collider.type = ecs::ColliderType::Sphere;
+        collider.halfExtents = Vec3{ radius, radius, radius };
+        return entity;
+    }
+
+private:
+    ecs::Entity AddDynamic(const Vec3& position)
+    {
+        const ecs::Entity entity = world.CreateEntity();
+        world.AddComponent<ecs::TransformComponent>(entity).position = position;
+        world.AddComponent<ecs::RigidbodyComponent>(entity).mass = 1.0f;
+        return entity;
+    }
+};
+
+struct Scenario
+{
+    const char* name;
+    const char* description;
+    void (*build)(SceneBuilder& scene, const BenchOptions& options);
+    // Called before every tick, warmup included; null for scenes that only settle.
+    void (*tick)(SceneBuilder& scene, int tick);
+};
+
+// Columns of loosely stacked boxes with a small jitter, so the pile topples
+// into a dense, irregular contact graph.
+void BuildBoxPile(SceneBuilder& scene, const BenchOptions& options)
+{
+    scene.AddStaticBox(Vec3{}, Vec3{ 60.0f, 0.5f, 60.0f });
+    const int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(options.boxes / 8.0))));
+    for (int i = 0; i < options.boxes; ++i)
+    {
+        const int column = i % (columns * columns);
+        const int layer = i / (columns * columns);
+        const float x = (column % columns) * 0.6f - columns * 0.3f + scene.random.Range(-0.05f, 0.05f);
+        const float z = (column / columns) * 0.6f - columns * 0.3f + scene.random.Range(-0.05f, 0.05f);
+        scene.bodies.push_back(scene.AddBox(Vec3{ x, 0.75f + layer * 0.55f, z }, Vec3{ 0.25f, 0.25f, 0.25f }));
+    }
+}
+
+// Aligned towers that should come to rest and stay there; drift shows the solver creeping.
+void BuildBoxStacks(SceneBuilder& scene, const BenchOptions&)
+{
+    constexpr int kSide = 12;
+    constexpr int kHeight = 8;
+    scene.AddStaticBox(Vec3{}, Vec3{ 30.0f, 0.5f, 30.0f });
+    for (int row = 0; row < kSide; ++row)
+    {
+        for (int column = 0; column < kSide; ++column)
+        {
+            for (int level = 0; level < kHeight; ++level)
+            {
+                const Vec3 position{ (column - kSide / 2) * 2.0f, 1.01f + level * 1.01f, (row - kSide / 2) * 2.0f };
+                scene.bodies.push_back(scene.AddBox(position, Vec3{ 0.5f, 0.5f, 0.5f }));
+            }
+        }
+    }
+}
+
+// Layers of spheres dropped on a tilted ramp; they roll down and pile up against a wall.
+void BuildSphereRamp(SceneBuilder& scene, const BenchOptions&)
+{
+    scene.AddStaticBox(Vec3{}, Vec3{ 40.0f, 0.5f, 40.0f });
+    scene.AddStaticBox(Vec3{ 0.0f, 6.0f, 0.0f }, Vec3{ 12.0f, 0.25f, 20.0f }, Vec3{ 0.0f, 0.0f, 0.3f });
+    scene.AddStaticBox(Vec3{ -17.0f, 3.0f, 0.0f }, Vec3{ 0.5f, 3.0f, 22.0f });
+    scene.AddStaticBox(Vec3{ 17.0f, 3.0f, 0.0f }, Vec3{ 0.5f, 3.0f, 22.0f });
+    for (int layer = 0; layer < 4; ++layer)
+    {
+        for (int row = 0; row < 20; ++row)
+        {
+            for (int column = 0; column < 15; ++column)
+            {
+                const Vec3 position{
+                    (column - 7) * 1.0f + scene.random.Range(-0.1f, 0.1f),
+                    12.0f + layer * 1.0f,
+                    (row - 10) * 1.6f + scene.random.Range(-0.1f, 0.1f) };
+                scene.bodies.push_back(scene.AddSphere(position, 0.3f));
+            }
+        }
+    }
+}
+
+// Ten thousand boxes and spheres of mixed sizes spread over a wide ground: a broadphase load
+// with few contacts per body.
+void BuildScattered(SceneBuilder& scene, const BenchOptions&)
+{
+    constexpr int kSide = 100;
+    constexpr float kSpacing = 1.8f;
+    scene.AddStaticBox(Vec3{}, Vec3{ 100.0f, 0.5f, 100.0f });
+    for (int row = 0; row < kSide; ++row)
+    {
+        for (int column = 0; column < kSide; ++column)
+        {
+            const Vec3 position{
+                (column - kSide / 2) * kSpacing + scene.random.Range(-0.3f, 0.3f),
+                scene.random.Range(1.0f, 6.0f),
+                (row - kSide / 2) * kSpacing + scene.random.Range(-0.3f, 0.3f) };
+            if ((row * kSide + column) % 3 == 0)
+            {
+                scene.bodies.push_back(scene.AddSphere(position, scene.random.Range(0.2f, 0.5f)));
+                continue;
+            }
+            const Vec3 half{ scene.random.Range(0.2f, 0.6f), scene.random.Range(0.2f, 0.6f), scene.random.Range(0.2f, 0.6f) };
+            scene.bodies.push_back(scene.AddBox(position, half));
+        }
+    }
+}
+
+constexpr int kWallCount = 3;
+constexpr int kWallWidth = 12;
+constexpr int kWallHeight = 16;
+constexpr float kWallSpacing = 15.0f;
+
+// Brick walls, staggered every other row, that BuildProjectiles fires into.
+void BuildProjectileWalls(SceneBuilder& scene, const BenchOptions&)
+{
+    scene.AddStaticBox(Vec3{}, Vec3{ 60.0f, 0.5f, 60.0f });
+    for (int wall = 0; wall < kWallCount; ++wall)
+    {
+        const float centerX = (wall - kWallCount / 2) * kWallSpacing;
+        for (int row = 0; row < kWallHeight; ++row)
+        {
+            const float stagger = (row % 2) * 0.5f;
+            for (int brick = 0; brick < kWallWidth; ++brick)
+            {
+                const Vec3 position{ centerX + (brick - kWallWidth / 2) * 1.0f + stagger, 0.76f + row * 0.51f, 0.0f };
+                scene.bodies.push_back(scene.AddBox(position, Vec3{ 0.49f, 0.25f, 0.25f }));
+            }
+        }
+    }
+}
+
+// A fast sphere every few ticks, aimed at the walls in turn; CCD keeps them from tunneling.
+void FireProjectile(SceneBuilder& scene, int tick)
+{
+    constexpr int kInterval = 4;
+    if (tick % kInterval != 0)
+        return;
+    const int shot = tick / kInterval;
+    const float x = (shot % kWallCount - kWallCount / 2) * kWallSpacing + scene.random.Range(-4.0f, 4.0f);
+    const float y = scene.random.Range(1.0f, kWallHeight * 0.5f);
+    const ecs::Entity projectile = scene.AddSphere(Vec3{ x, y, -25.0f }, 0.15f);
+    auto* rb = scene.world.GetComponent<ecs::RigidbodyComponent>(projectile);
+    rb->mass = 4.0f;
+    rb->velocity = Vec3{ 0.0f, 2.0f, 45.0f };
+    rb->continuousCollision = true;
+    scene.spawned.push_back(projectile);
+}
+
+constexpr Scenario kScenarios[] = {
+    { "box_pile", "toppling pile of --boxes small boxes", BuildBoxPile, nullptr },
+    { "box_stacks", "12x12 towers of 8 resting boxes", BuildBoxStacks, nullptr },
+    { "sphere_ramp", "1200 spheres rolling down a ramp into a wall", BuildSphereRamp, nullptr },
+    { "scattered_10k", "10000 boxes and spheres scattered over a wide ground", BuildScattered, nullptr },
+    { "projectile_wall", "CCD spheres fired into three brick walls", BuildProjectileWalls, FireProjectile },
+};
+
+struct RunResult
+{
+    std::uint32_t threads = 1;
+    std::size_t bodies = 0;
+    double averageStepMs = 0.0;
+    double maxStepMs = 0.0;
+    std::array<double, ecs::kPhysicsPhaseCount> phaseMs{};
+    double pairsPerStep = 0.0;
+    double contactsPerStep = 0.0;
+    double warmStartedPerStep = 0.0;
+    double bodyStepsPerStep = 0.0;
+    double duplicatePairsPerStep = 0.0;
+    double contactSolvesPerStep = 0.0;
+    std::array<double, physics::kContactTypeCount> testsPerStep{};
+    std::uint64_t ccdSweeps = 0;
+    std::uint64_t ccdHits = 0;
+    // Displacement of the scene bodies over the timed ticks.
+    double meanDrift = 0.0;
+    double maxDrift = 0.0;
+    // Root mean square speed of the scene bodies over the timed ticks.
+    double jitterRms = 0.0;
+    std::uint64_t positionHash = 0;
+};
+
+std::vector<std::string> SplitList(const char* text)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* cursor = text;; ++cursor)
+    {
+        if (*cursor == ',' || *cursor == '\0')
+        {
+            if (!item.empty())
+                items.push_back(item);
+            item.clear();
+            if (*cursor == '\0')
+                break;
+            continue;
+        }
+        item.push_back(*cursor);
+    }
+    return items;
+}
+
+std::vector<std::uint32_t> ParseThreadList(const char* text)
+{
+    std::vector<std::uint32_t> counts;
+    for (const std::string& item : SplitList(text))
+    {
+        const unsigned long value = std::strtoul(item.c_str(), nullptr, 10);
+        if (value > 0)
+            counts.push_back(static_cast<std::uint32_t>(value));
+    }
+    return counts;
+}
+
+const Scenario* FindScenario(const std::string& name)
+{
+    for (const Scenario& scenario : kScenarios)
+    {
+        if (name == scenario.name)
+            return &scenario;
+    }
+    return nullptr;
+}
+
+BenchOptions ParseOptions(int argc, char** argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--boxes") == 0 && hasValue)
+            options.boxes = std::max(1, std::atoi(argv[++i]));
+        else if ((std::strcmp(argv[i], "--ticks") == 0 || std::strcmp(argv[i], "--frames") == 0) && hasValue)
+            options.ticks = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue)
+            options.warmupTicks = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+            options.threadCounts = ParseThreadList(argv[++i]);
+        else if (std::strcmp(argv[i], "--scenario") == 0 && hasValue)
+            options.scenarios = SplitList(argv[++i]);
+        else if (std::strcmp(argv[i], "--json") == 0 && hasValue)
+            options.jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--sleep") == 0)
+            options.sleep = true;
+        else if (std::strcmp(argv[i], "--adaptive") == 0)
+            options.adaptiveSubsteps = true;
+        else if (std::strcmp(argv[i], "--lod") == 0)
+            options.lod = true;
+    }
+
+    if (options.scenarios.empty() || (options.scenarios.size() == 1 && options.scenarios.front() == "all"))
+    {
+        options.scenarios.clear();
+        for (const Scenario& scenario : kScenarios)
+            options.scenarios.emplace_back(scenario.name);
+    }
+    if (options.threadCounts.empty())
+    {
+        const std::uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (std::uint32_t count = 1; count < hardware; count *= 2)
+            options.threadCounts.push_back(count);
+        options.threadCounts.push_back(hardware);
+    }
+    return options;
+}
+
+void HashEntities(ecs::World& world, const std::vector<ecs::Entity>& entities, std::uint64_t& hash)
+{
+    for (const ecs::Entity entity : entities)
+    {
+        const auto* transform = world.GetComponent<ecs::TransformComponent>(entity);
+        unsigned char bytes[sizeof(transform->position)];
+        std::memcpy(bytes, &transform->position, sizeof(bytes));
+        for (const unsigned char byte : bytes)
+        {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+    }
+}
+
+RunResult RunScenario(const Scenario& scenario, const BenchOptions& options, std::uint32_t threads)
+{
+    JobSystem::Get().SetWorkerCount(threads - 1);
+
+    ecs::World world;
+    ecs::PhysicsSystem physics(nullptr, 9.81f, 0.985f, 4, 0.05f, 0.85f, 2);
+    if (!options.sleep)
+        physics.SetSleepThresholds(0.0f, 0.0f);
+    physics.SetAdaptiveSubsteps(options.adaptiveSubsteps);
+    physics::LodSettings lod;
+    lod.enabled = options.lod;
+    physics.SetLodSettings(lod);
+    SceneBuilder scene{ world, {}, {}, {} };
+    scenario.build(scene, options);
+
+    int tick = 0;
+    const auto step = [&]()
+    {
+        if (scenario.tick)
+            scenario.tick(scene, tick);
+        ++tick;
+        physics.Update(world, kTickDt);
+        FrameArena::ResetAll();
+    };
+    for (int warmup = 0; warmup < options.warmupTicks; ++warmup)
+        step();
+
+    std::vector<Vec3> startPositions;
+    startPositions.reserve(scene.bodies.size());
+    for (const ecs::Entity body : scene.bodies)
+        startPositions.push_back(world.GetComponent<ecs::TransformComponent>(body)->position);
+
+    RunResult result;
+    result.threads = threads;
+    double speedSqSum = 0.0;
+    std::uint64_t pairs = 0;
+    std::uint64_t contacts = 0;
+    std::uint64_t warmStarted = 0;
+    std::uint64_t bodySteps = 0;
+    std::uint64_t duplicatePairs = 0;
+    std::uint64_t contactSolves = 0;
+    for (int timed = 0; timed < options.ticks; ++timed)
+    {
+        step();
+        const ecs::PhysicsStepStats& stats = physics.GetStepStats();
+        result.averageStepMs += stats.totalMs;
+        result.maxStepMs = std::max(result.maxStepMs, stats.totalMs);
+        for (std::size_t phase = 0; phase < ecs::kPhysicsPhaseCount; ++phase)
+            result.phaseMs[phase] += stats.phaseMs[phase];
+        pairs += stats.pairsTested;
+        contacts += stats.contacts;
+        warmStarted += stats.warmStartedContacts;
+        bodySteps += stats.bodySteps;
+        duplicatePairs += stats.duplicatePairs;
+        contactSolves += stats.contactSolves;
+        for (std::size_t type = 0; type < physics::kContactTypeCount; ++type)
+            result.testsPerStep[type] += static_cast<double>(stats.narrowphaseTests[type]);
+        result.ccdSweeps += stats.ccdSweeps;
+        result.ccdHits += stats.ccdHits;
+        for (const ecs::Entity body : scene.bodies)
+        {
+            const Vec3& velocity = world.GetComponent<ecs::RigidbodyComponent>(body)->velocity;
+            speedSqSum += velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z;
+        }
+    }
+
+    const double ticks = static_cast<double>(options.ticks);
+    result.bodies = scene.bodies.size() + scene.spawned.size();
+    result.averageStepMs /= ticks;
+    for (double& phaseMs : result.phaseMs)
+        phaseMs /= ticks;
+    result.pairsPerStep = static_cast<double>(pairs) / ticks;
+    result.contactsPerStep = static_cast<double>(contacts) / ticks;
+    result.warmStartedPerStep = static_cast<double>(warmStarted) / ticks;
+    result.bodyStepsPerStep = static_cast<double>(bodySteps) / ticks;
+    result.duplicatePairsPerStep = static_cast<double>(duplicatePairs) / ticks;
+    result.contactSolvesPerStep = static_cast<double>(contactSolves) / ticks;
+    for (double& tests : result.testsPerStep)
+        tests /= ticks;
+
+    for (std::size_t i = 0; i < scene.bodies.size(); ++i)
+    {
+        const Vec3& position = world.GetComponent<ecs::TransformComponent>(scene.bodies[i])->position;
+        const Vec3& start = startPositions[i];
+        const double dx = position.x - start.x;
+        const double dy = position.y - start.y;
+        const double dz = position.z - start.z;
+        const double drift = std::sqrt(dx * dx + dy * dy + dz * dz);
+        result.meanDrift += drift;
+        result.maxDrift = std::max(result.maxDrift, drift);
+    }
+    if (!scene.bodies.empty())
+    {
+        result.meanDrift /= static_cast<double>(scene.bodies.size());
+        result.jitterRms = std::sqrt(speedSqSum / (ticks * static_cast<double>(scene.bodies.size())));
+    }
+
+    result.positionHash = 1469598103934665603ull;
+    HashEntities(world, scene.bodies, result.positionHash);
+    HashEntities(world, scene.spawned, result.positionHash);
+    return result;
+}
+
+std::string HashString(std::uint64_t hash)
+{
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+    return text;
+}
+
+nlohmann::ordered_json RunToJson(const RunResult& result)
+{
+    nlohmann::ordered_json run;
+    run["threads"] = result.threads;
+    run["stepMs"] = { { "average", result.averageStepMs }, { "max", result.maxStepMs } };
+    nlohmann::ordered_json phases = nlohmann::ordered_json::object();
+    for (std::size_t phase = 0; phase < ecs::kPhysicsPhaseCount; ++phase)
+        phases[ecs::PhysicsSystem::PhaseName(static_cast<ecs::PhysicsPhase>(phase))] = result.phaseMs[phase];
+    run["phaseMs"] = phases;
+    run["pairsPerStep"] = result.pairsPerStep;
+    run["contactsPerStep"] = result.contactsPerStep;
+    run["warmStartedPerStep"] = result.warmStartedPerStep;
+    run["bodyStepsPerStep"] = result.bodyStepsPerStep;
+    run["duplicatePairsPerStep"] = result.duplicatePairsPerStep;
+    nlohmann::ordered_json tests = nlohmann::ordered_json::object();
+    for (std::size_t type = 1; type < physics::kContactTypeCount; ++type)
+        tests[physics::ContactTypeName(static_cast<physics::ContactType>(type))] = result.testsPerStep[type];
+    run["narrowphaseTestsPerStep"] = tests;
+    run["contactSolvesPerStep"] = result.contactSolvesPerStep;
+    run["ccdSweeps"] = result.ccdSweeps;
+    run["ccdHits"] = result.ccdHits;
+    run["drift"] = { { "mean", result.meanDrift }, { "max", result.maxDrift } };
+    run["jitterRms"] = result.jitterRms;
+    run["positionHash"] = HashString(result.positionHash);
+    return run;
+}
+}
+
+int main(int argc, char** argv)
+{
+    const BenchOptions options = ParseOptions(argc, argv);
+    std::printf("PhysicsBench: %d warmup + %d timed ticks, sleep %s, %s substeps, lod %s\n",
+        options.warmupTicks, options.ticks, options.sleep ? "on" : "off", options.adaptiveSubsteps ? "adaptive" : "fixed",
+        options.lod ? "on" : "off");
+    const std::size_t kernelMismatches = physics::VerifyNarrowphaseKernels(4096);
+    std::printf("narrowphase kernels: %s, %zu mismatches against scalar\n",
+        physics::GetNarrowphaseKernelName(), kernelMismatches);
+
+    nlohmann::ordered_json report;
+    report["ticks"] = options.ticks;
+    report["warmupTicks"] = options.warmupTicks;
+    report["tickDt"] = kTickDt;
+    report["sleep"] = options.sleep;
+    report["adaptiveSubsteps"] = options.adaptiveSubsteps;
+    report["lod"] = options.lod;
+    report["kernels"] = physics::GetNarrowphaseKernelName();
+    report["kernelMismatches"] = kernelMismatches;
+    report["scenarios"] = nlohmann::ordered_json::array();
+
+    bool allDeterministic = true;
+    for (const std::string& name : options.scenarios)
+    {
+        const Scenario* scenario = FindScenario(name);
+        if (!scenario)
+        {
+            std::printf("\nunknown scenario '%s'\n", name.c_str());
+            allDeterministic = false;
+            continue;
+        }
+
+        std::printf("\n%s: %s\n", scenario->name, scenario->description);
+        std::printf("%8s %10s %10s %9s %10s %10s %10s %10s %18s\n",
+            "threads", "ms/step", "max ms", "speedup", "pairs", "contacts", "drift", "jitter", "position hash");
+        std::vector<RunResult> results;
+        for (const std::uint32_t threads : options.threadCounts)
+        {
+            const RunResult result = RunScenario(*scenario, options, threads);
+            const double baseline = results.empty() ? result.averageStepMs : results.front().averageStepMs;
+            std::printf("%8u %10.3f %10.3f %8.2fx %10.0f %10.0f %10.4f %10.4f   %s\n",
+                result.threads,
+                result.averageStepMs,
+                result.maxStepMs,
+                result.averageStepMs > 0.0 ? baseline / result.averageStepMs : 0.0,
+                result.pairsPerStep,
+                result.contactsPerStep,
+                result.meanDrift,
+                result.jitterRms,
+                HashString(result.positionHash).c_str());
+            std::printf("        ");
+            for (std::size_t phase = 0; phase < ecs::kPhysicsPhaseCount; ++phase)
+                std::printf(" %s %.3f", ecs::PhysicsSystem::PhaseName(static_cast<ecs::PhysicsPhase>(phase)), result.phaseMs[phase]);
+            std::printf("\n");
+            results.push_back(result);
+        }
+
+        const bool deterministic = std::all_of(results.begin(), results.end(), [&](const RunResult& result)
+        {
+            return result.positionHash == results.front().positionHash;
+        });
+        std::printf("deterministic across thread counts: %s\n", deterministic ? "yes" : "no");
+        allDeterministic = allDeterministic && deterministic;
+
+        nlohmann::ordered_json entry;
+        entry["name"] = scenario->name;
+        entry["bodies"] = results.empty() ? 0 : results.front().bodies;
+        entry["deterministic"] = deterministic;
+        entry["runs"] = nlohmann::ordered_json::array();
+        for (const RunResult& result : results)
+            entry["runs"].push_back(RunToJson(result));
+        report["scenarios"].push_back(entry);
+    }
+
+    if (!options.jsonPath.empty())
+    {
+        std::ofstream file(options.jsonPath);
+        file << report.dump(2) << '\n';
+        std::printf("\nreport written to %s%s\n", options.jsonPath.c_str(), file ? "" : " (failed)");
+    }
+
+    JobSystem::Get().SetWorkerCount(0);
+    return allDeterministic ? 0 : 1;
+}
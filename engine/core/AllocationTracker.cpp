@@ -0,0 +1,384 @@
+#include "AllocationTracker.h"
+#include "Logger.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+thread_local AllocationTag t_CurrentTag = AllocationTag::Untagged;
+thread_local const char* t_CurrentSite = nullptr;
+
+struct FrameState
+{
+    AllocationTracker::FrameReport lastFrame;
+    std::array<std::uint64_t, kAllocationTagCount> maxFrameAllocations{};
+    std::uint64_t frameIndex = 0;
+    std::uint64_t budget = 0;
+    std::uint64_t warmupFrames = 0;
+    std::uint64_t budgetViolations = 0;
+    std::uint64_t worstFrameAllocations = 0;
+};
+
+FrameState& GetFrameState()
+{
+    static FrameState state;
+    return state;
+}
+
+#if defined(WHISP_TRACK_ALLOCATIONS)
+constexpr std::size_t kHeaderSize = 16;
+constexpr std::size_t kSiteCapacity = 256;
+constexpr std::uint8_t kHeaderMagic = 0xA7;
+
+struct AllocationHeader
+{
+    std::uint64_t size;
+    std::uint32_t offset;
+    std::uint16_t site;
+    std::uint8_t tag;
+    std::uint8_t magic;
+};
+static_assert(sizeof(AllocationHeader) == kHeaderSize);
+
+struct TagCounters
+{
+    std::atomic<std::uint64_t> frameAllocations{ 0 };
+    std::atomic<std::uint64_t> frameBytes{ 0 };
+    std::atomic<std::uint64_t> liveBytes{ 0 };
+    std::atomic<std::uint64_t> peakLiveBytes{ 0 };
+    std::atomic<std::uint64_t> totalAllocations{ 0 };
+};
+
+struct SiteSlot
+{
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<std::uint8_t> tag{ 0 };
+    std::atomic<std::uint64_t> allocations{ 0 };
+    std::atomic<std::uint64_t> frees{ 0 };
+    std::atomic<std::uint64_t> bytes{ 0 };
+};
+
+// Constant-initialized so operator new can use it before any static constructor runs.
+struct TrackerCounters
+{
+    std::array<TagCounters, kAllocationTagCount> tags;
+    std::array<SiteSlot, kSiteCapacity> sites;
+    std::atomic<std::uint64_t> liveBytes{ 0 };
+    std::atomic<std::uint64_t> peakLiveBytes{ 0 };
+};
+
+constinit TrackerCounters g_Counters;
+
+void UpdatePeak(std::atomic<std::uint64_t>& peak, std::uint64_t value)
+{
+    std::uint64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+std::uint16_t FindOrInsertSite(const char* name, AllocationTag tag)
+{
+    const auto hash = static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(name)) * 11400714819323198485ull) >> 56);
+    for (std::size_t probe = 0; probe < kSiteCapacity; ++probe)
+    {
+        const std::size_t index = (hash + probe) & (kSiteCapacity - 1);
+        SiteSlot& slot = g_Counters.sites[index];
+        const char* current = slot.name.load(std::memory_order_acquire);
+        if (current == nullptr)
+        {
+            if (slot.name.compare_exchange_strong(current, name, std::memory_order_acq_rel))
+            {
+                slot.tag.store(static_cast<std::uint8_t>(tag), std::memory_order_relaxed);
+                return static_cast<std::uint16_t>(index + 1);
+            }
+        }
+        if (current == name)
+            return static_cast<std::uint16_t>(index + 1);
+    }
+    return 0;
+}
+
+void* TrackedAllocate(std::size_t size, std::size_t alignment)
+{
+    alignment = std::max(alignment, kHeaderSize);
+    const std::size_t total = size + kHeaderSize + (alignment > kHeaderSize ? alignment : 0);
+    auto* raw = static_cast<unsigned char*>(std::malloc(total));
+    if (raw == nullptr)
+        return nullptr;
+
+    const auto rawAddress = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t userAddress = (rawAddress + kHeaderSize + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    auto* user = reinterpret_cast<unsigned char*>(userAddress);
+
+    const AllocationTag tag = t_CurrentTag;
+    const char* site = t_CurrentSite != nullptr ? t_CurrentSite : AllocationTracker::TagName(tag);
+    const std::uint16_t siteIndex = FindOrInsertSite(site, tag);
+
+    auto* header = reinterpret_cast<AllocationHeader*>(user - kHeaderSize);
+    header->size = size;
+    header->offset = static_cast<std::uint32_t>(userAddress - rawAddress);
+    header->site = siteIndex;
+    header->tag = static_cast<std::uint8_t>(tag);
+    header->magic = kHeaderMagic;
+
+    TagCounters& counters = g_Counters.tags[static_cast<std::size_t>(tag)];
+    counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameBytes.fetch_add(size, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    UpdatePeak(counters.peakLiveBytes, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    UpdatePeak(g_Counters.peakLiveBytes, g_Counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+
+    if (siteIndex != 0)
+    {
+        SiteSlot& slot = g_Counters.sites[siteIndex - 1];
+        slot.allocations.fetch_add(1, std::memory_order_relaxed);
+        slot.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    return user;
+}
+
+void TrackedFree(void* pointer)
+{
+    if (pointer == nullptr)
+        return;
+
+    auto* user = static_cast<unsigned char*>(pointer);
+    const auto* header = reinterpret_cast<const AllocationHeader*>(user - kHeaderSize);
+    if (header->magic != kHeaderMagic)
+    {
+        std::free(pointer);
+        return;
+    }
+
+    const std::size_t tagIndex = std::min<std::size_t>(header->tag, kAllocationTagCount - 1);
+    g_Counters.tags[tagIndex].liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    g_Counters.liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    if (header->site != 0)
+        g_Counters.sites[header->site - 1].frees.fetch_add(1, std::memory_order_relaxed);
+
+    std::free(user - header->offset);
+}
+
+void* TrackedAllocateOrThrow(std::size_t size, std::size_t alignment)
+{
+    if (void* pointer = TrackedAllocate(size, alignment))
+        return pointer;
+    throw std::bad_alloc();
+}
+#endif
+}
+
+void AllocationTracker::EndFrame()
+{
+    FrameState& state = GetFrameState();
+    FrameReport report;
+    report.frameIndex = state.frameIndex;
+
+#if defined(WHISP_TRACK_ALLOCATIONS)
+    for (std::size_t i = 0; i < kAllocationTagCount; ++i)
+    {
+        TagCounters& counters = g_Counters.tags[i];
+        TagStats& stats = report.tags[i];
+        stats.frameAllocations = counters.frameAllocations.exchange(0, std::memory_order_relaxed);
+        stats.frameBytes = counters.frameBytes.exchange(0, std::memory_order_relaxed);
+        stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+        stats.peakLiveBytes = counters.peakLiveBytes.load(std::memory_order_relaxed);
+        stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+        state.maxFrameAllocations[i] = std::max(state.maxFrameAllocations[i], stats.frameAllocations);
+        stats.maxFrameAllocations = state.maxFrameAllocations[i];
+        report.frameAllocations += stats.frameAllocations;
+        report.frameBytes += stats.frameBytes;
+    }
+    report.liveBytes = g_Counters.liveBytes.load(std::memory_order_relaxed);
+    report.peakLiveBytes = g_Counters.peakLiveBytes.load(std::memory_order_relaxed);
+#endif
+
+    if (state.frameIndex >= state.warmupFrames)
+    {
+        state.worstFrameAllocations = std::max(state.worstFrameAllocations, report.frameAllocations);
+        if (state.budget > 0 && report.frameAllocations > state.budget)
+        {
+            if (state.budgetViolations == 0)
+            {
+                Logger::Get().Warn(
+                    "AllocationTracker: frame " + std::to_string(state.frameIndex) +
+                    " made " + std::to_string(report.frameAllocations) +
+                    " allocations, budget is " + std::to_string(state.budget));
+            }
+            ++state.budgetViolations;
+        }
+    }
+
+    state.lastFrame = report;
+    ++state.frameIndex;
+}
+
+const AllocationTracker::FrameReport& AllocationTracker::GetLastFrame()
+{
+    return GetFrameState().lastFrame;
+}
+
+std::vector<AllocationTracker::SiteStats> AllocationTracker::GetTopSites(std::size_t maxCount)
+{
+    std::vector<SiteStats> sites;
+#if defined(WHISP_TRACK_ALLOCATIONS)
+    for (const SiteSlot& slot : g_Counters.sites)
+    {
+        const char* name = slot.name.load(std::memory_order_acquire);
+        if (name == nullptr)
+            continue;
+
+        SiteStats stats;
+        stats.name = name;
+        stats.tag = static_cast<AllocationTag>(slot.tag.load(std::memory_order_relaxed));
+        stats.allocations = slot.allocations.load(std::memory_order_relaxed);
+        stats.frees = slot.frees.load(std::memory_order_relaxed);
+        stats.bytes = slot.bytes.load(std::memory_order_relaxed);
+        sites.push_back(stats);
+    }
+
+    std::sort(sites.begin(), sites.end(), [](const SiteStats& lhs, const SiteStats& rhs)
+    {
+        return lhs.allocations + lhs.frees > rhs.allocations + rhs.frees;
+    });
+    if (sites.size() > maxCount)
+        sites.resize(maxCount);
+#else
+    (void)maxCount;
+#endif
+    return sites;
+}
+
+void AllocationTracker::SetFrameBudget(std::uint64_t maxAllocationsPerFrame, std::uint64_t warmupFrames)
+{
+    FrameState& state = GetFrameState();
+    state.budget = maxAllocationsPerFrame;
+    state.warmupFrames = warmupFrames;
+}
+
+std::uint64_t AllocationTracker::GetBudgetViolationCount()
+{
+    return GetFrameState().budgetViolations;
+}
+
+bool AllocationTracker::WriteReport(const std::filesystem::path& path, std::string* outError)
+{
+    const FrameState& state = GetFrameState();
+    const FrameReport& last = state.lastFrame;
+
+    nlohmann::json report;
+    report["enabled"] = IsEnabled();
+    report["frames"] = state.frameIndex;
+    report["warmupFrames"] = state.warmupFrames;
+    report["budget"] = state.budget;
+    report["budgetViolations"] = state.budgetViolations;
+    report["worstFrameAllocations"] = state.worstFrameAllocations;
+    report["liveBytes"] = last.liveBytes;
+    report["peakLiveBytes"] = last.peakLiveBytes;
+
+    nlohmann::json tags = nlohmann::json::object();
+    for (std::size_t i = 0; i < kAllocationTagCount; ++i)
+    {
+        const TagStats& stats = last.tags[i];
+        tags[TagName(static_cast<AllocationTag>(i))] = {
+            { "totalAllocations", stats.totalAllocations },
+            { "maxFrameAllocations", stats.maxFrameAllocations },
+            { "lastFrameAllocations", stats.frameAllocations },
+            { "lastFrameBytes", stats.frameBytes },
+            { "liveBytes", stats.liveBytes },
+            { "peakLiveBytes", stats.peakLiveBytes }
+        };
+    }
+    report["tags"] = std::move(tags);
+
+    nlohmann::json sites = nlohmann::json::array();
+    for (const SiteStats& site : GetTopSites(16))
+    {
+        sites.push_back({
+            { "site", site.name },
+            { "tag", TagName(site.tag) },
+            { "allocations", site.allocations },
+            { "frees", site.frees },
+            { "bytes", site.bytes }
+        });
+    }
+    report["topSites"] = std::move(sites);
+
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        if (outError != nullptr)
+            *outError = "AllocationTracker: cannot write report " + path.string();
+        return false;
+    }
+
+    file << report.dump(2) << '\n';
+    Logger::Get().Info("AllocationTracker: wrote report " + path.string());
+    return true;
+}
+
+const char* AllocationTracker::TagName(AllocationTag tag)
+{
+    switch (tag)
+    {
+    case AllocationTag::Untagged:  return "Untagged";
+    case AllocationTag::ECS:       return "ECS";
+    case AllocationTag::Physics:   return "Physics";
+    case AllocationTag::Resources: return "Resources";
+    case AllocationTag::Render:    return "Render";
+    case AllocationTag::Editor:    return "Editor";
+    default:                       return "Unknown";
+    }
+}
+
+AllocationTag AllocationTracker::GetCurrentTag()
+{
+    return t_CurrentTag;
+}
+
+const char* AllocationTracker::GetCurrentSite()
+{
+    return t_CurrentSite;
+}
+
+void AllocationTracker::SetCurrent(AllocationTag tag, const char* site)
+{
+    t_CurrentTag = tag;
+    t_CurrentSite = site;
+}
+
+#if defined(WHISP_TRACK_ALLOCATIONS)
+void* operator new(std::size_t size) { return TrackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size) { return TrackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return TrackedAllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return TrackedAllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+#endif
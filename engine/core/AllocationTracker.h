@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <vector>
+
+enum class AllocationTag : std::uint8_t
+{
+    Untagged,
+    ECS,
+    Physics,
+    Resources,
+    Render,
+    Editor,
+    Count
+};
+
+inline constexpr std::size_t kAllocationTagCount = static_cast<std::size_t>(AllocationTag::Count);
+
+// Heap tracking is compiled in only with WHISP_TRACK_ALLOCATIONS (CMake option of the
+// same name). Without it the API stays available but records nothing.
+class AllocationTracker
+{
+public:
+    struct TagStats
+    {
+        std::uint64_t frameAllocations = 0;
+        std::uint64_t frameBytes = 0;
+        std::uint64_t liveBytes = 0;
+        std::uint64_t peakLiveBytes = 0;
+        std::uint64_t totalAllocations = 0;
+        std::uint64_t maxFrameAllocations = 0;
+    };
+
+    struct SiteStats
+    {
+        const char* name = nullptr;
+        AllocationTag tag = AllocationTag::Untagged;
+        std::uint64_t allocations = 0;
+        std::uint64_t frees = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    struct FrameReport
+    {
+        std::array<TagStats, kAllocationTagCount> tags{};
+        std::uint64_t frameAllocations = 0;
+        std::uint64_t frameBytes = 0;
+        std::uint64_t liveBytes = 0;
+        std::uint64_t peakLiveBytes = 0;
+        std::uint64_t frameIndex = 0;
+    };
+
+    static constexpr bool IsEnabled()
+    {
+#if defined(WHISP_TRACK_ALLOCATIONS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Closes the current frame: per-frame counters move into the last frame report.
+    static void EndFrame();
+    static const FrameReport& GetLastFrame();
+    static std::vector<SiteStats> GetTopSites(std::size_t maxCount);
+
+    static void SetFrameBudget(std::uint64_t maxAllocationsPerFrame, std::uint64_t warmupFrames);
+    static std::uint64_t GetBudgetViolationCount();
+    static bool WriteReport(const std::filesystem::path& path, std::string* outError = nullptr);
+
+    static const char* TagName(AllocationTag tag);
+
+    static AllocationTag GetCurrentTag();
+    static const char* GetCurrentSite();
+    static void SetCurrent(AllocationTag tag, const char* site);
+};
+
+class AllocationScope
+{
+public:
+    AllocationScope(AllocationTag tag, const char* site)
+        : m_PreviousTag(AllocationTracker::GetCurrentTag())
+        , m_PreviousSite(AllocationTracker::GetCurrentSite())
+    {
+        AllocationTracker::SetCurrent(tag, site);
+    }
+
+    ~AllocationScope()
+    {
+        AllocationTracker::SetCurrent(m_PreviousTag, m_PreviousSite);
+    }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    AllocationTag m_PreviousTag;
+    const char* m_PreviousSite;
+};
+
+// Standard allocator that attributes every allocation of a container to one tag.
+template <typename T, AllocationTag Tag>
+class TaggedAllocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = TaggedAllocator<U, Tag>;
+    };
+
+    TaggedAllocator() noexcept = default;
+
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        AllocationScope scope(Tag, AllocationTracker::GetCurrentSite());
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+        else
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept
+    {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(pointer, count * sizeof(T), std::align_val_t(alignof(T)));
+        else
+            ::operator delete(pointer, count * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const TaggedAllocator<U, Tag>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const TaggedAllocator<U, Tag>&) const noexcept { return false; }
+};
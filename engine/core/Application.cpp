@@ -1,8 +1,11 @@
 #include "Application.h"
+#include "AllocationTracker.h"
 #include "AssetDependencyValidation.h"
 #include "AssetPaths.h"
 #include "Logger.h"
 #include "ConfigLoader.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
 
 #include "../ecs/components/BoundsBounceComponent.h"
 #include "../ecs/components/ColliderComponent.h"
@@ -13,7 +16,9 @@
 #include "../ecs/components/TransformComponent.h"
 #include "../ecs/components/VelocityComponent.h"
 #include "../ecs/systems/BoundsBounceSystem.h"
+#include "../ecs/systems/AsyncPhysicsSystem.h"
 #include "../ecs/systems/PhysicsSystem.h"
+#include "../physics/NarrowphaseKernels.h"
 #include "../platform/GlfwWindow.h"
 #include "../render/IRenderAdapter.h"
 #include "../resources/ResourceManager.h"
@@ -24,9 +29,12 @@
 #include "../game/states/LoadingState.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <ctime>
 #include <filesystem>
 #include <array>
+#include <memory_resource>
 #include <sstream>
 #include <unordered_set>
 
@@ -105,50 +113,67 @@ static std::uint64_t BuildCollisionPairKey(std::size_t a, std::size_t b)
     return (hi << 32) ^ lo;
 }
 
-static bool TryBuildMeshCollider(
-    ResourceManager* resourceManager,
-    const std::string& meshPath,
+// Colliders that take their size or their shape from the mesh renderer's mesh.
+static bool NeedsMeshFit(const ecs::ColliderComponent& collider)
+{
+    return collider.autoFitFromMesh || ecs::IsMeshCollider(collider.type);
+}
+
+// Fits the collider to the scaled bounds the mesh computed at load and, for mesh colliders, binds
+// the collision shape the mesh baked at import. Meshes still loading are skipped; their load
+// notification queues the fit again.
+static bool FitColliderToMeshBounds(
+    const ResourceHandle<MeshResource>& meshResource,
     const ecs::Vec3& scale,
-    ecs::Vec3& outHalfExtents,
-    ecs::Vec3& outOffset)
+    ecs::ColliderComponent& collider)
 {
-    if (resourceManager == nullptr)
-        return false;
-    const std::string meshKey = AssetPaths::NormalizeAssetKey(meshPath);
-    if (meshKey.empty())
-        return false;
-    const auto meshResource = resourceManager->Load<MeshResource>(meshKey);
-    if (meshResource == nullptr || !meshResource->IsUsable())
-        return false;
-    const auto& vertices = meshResource->GetData().meshData.vertices;
-    if (vertices.empty())
+    if (meshResource == nullptr || !meshResource->IsLoaded() || meshResource->UsesFallback())
         return false;
+    const MeshResource& mesh = meshResource->GetData();
 
-    ecs::Vec3 minV{ vertices[0].position[0], vertices[0].position[1], vertices[0].position[2] };
-    ecs::Vec3 maxV = minV;
-    for (const auto& v : vertices)
+    if (collider.autoFitFromMesh && collider.type == ecs::ColliderType::Sphere)
     {
-        if (v.position[0] < minV.x) minV.x = v.position[0];
-        if (v.position[1] < minV.y) minV.y = v.position[1];
-        if (v.position[2] < minV.z) minV.z = v.position[2];
-        if (v.position[0] > maxV.x) maxV.x = v.position[0];
-        if (v.position[1] > maxV.y) maxV.y = v.position[1];
-        if (v.position[2] > maxV.z) maxV.z = v.position[2];
+        const float radius = mesh.bounds.sphereRadius * std::max(scale.x, std::max(scale.y, scale.z));
+        collider.halfExtents = ecs::Vec3{ radius, radius, radius };
+        collider.offset = ecs::Vec3{
+            mesh.bounds.sphereCenter.x * scale.x,
+            mesh.bounds.sphereCenter.y * scale.y,
+            mesh.bounds.sphereCenter.z * scale.z
+        };
+    }
+    else if (collider.autoFitFromMesh)
+    {
+        const physics::Aabb& box = mesh.bounds.box;
+        collider.halfExtents = ecs::Vec3{
+            (box.max.x - box.min.x) * 0.5f * scale.x,
+            (box.max.y - box.min.y) * 0.5f * scale.y,
+            (box.max.z - box.min.z) * 0.5f * scale.z
+        };
+        collider.offset = ecs::Vec3{
+            (box.max.x + box.min.x) * 0.5f * scale.x,
+            (box.max.y + box.min.y) * 0.5f * scale.y,
+            (box.max.z + box.min.z) * 0.5f * scale.z
+        };
+    }
+    if (ecs::IsMeshCollider(collider.type))
+    {
+        const bool hasShape = mesh.collisionShape != nullptr && mesh.collisionShape->triangles.IsValid();
+        collider.meshShape = hasShape ? mesh.collisionShape : nullptr;
     }
-
-    outHalfExtents = ecs::Vec3{
-        (maxV.x - minV.x) * 0.5f * scale.x,
-        (maxV.y - minV.y) * 0.5f * scale.y,
-        (maxV.z - minV.z) * 0.5f * scale.z
-    };
-    outOffset = ecs::Vec3{
-        (maxV.x + minV.x) * 0.5f * scale.x,
-        (maxV.y + minV.y) * 0.5f * scale.y,
-        (maxV.z + minV.z) * 0.5f * scale.z
-    };
     return true;
 }
 
+static ecs::ColliderType ParseColliderType(const std::string& name)
+{
+    if (name == "sphere" || name == "Sphere")
+        return ecs::ColliderType::Sphere;
+    if (name == "mesh" || name == "Mesh")
+        return ecs::ColliderType::TriangleMesh;
+    if (name == "hull" || name == "Hull")
+        return ecs::ColliderType::ConvexHull;
+    return ecs::ColliderType::Box;
+}
+
 static float Dot(const ecs::Vec3& lhs, const ecs::Vec3& rhs)
 {
     return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
@@ -198,6 +223,17 @@ static ecs::Vec3 BuildCameraForward(float yaw, float pitch)
     });
 }
 
+static std::uint64_t HashBytes(std::uint64_t hash, const void* data, std::size_t size)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 constexpr float kMaxCameraPitch = 1.55334306f;
 constexpr float kFallbackAspectRatio = 16.0f / 9.0f;
 
@@ -296,6 +332,7 @@ std::vector<EcsDemoEntityConfig> Application::BuildDefaultEcsDemoEntities()
     entities[1].tag = "AfricanHead_Center";
     entities[1].meshPath = "models/african_head.obj";
     entities[1].materialPath = "materials/african_head.material.json";
+    entities[1].colliderType = "mesh";
     entities[1].position = ecs::Vec3{ 0.0f, 1.1f, 0.0f };
     entities[1].rotation = ecs::Vec3{ 0.0f, 3.1415926f, 0.0f };
     entities[1].scale = ecs::Vec3{ 0.68f, 0.68f, 0.68f };
@@ -304,6 +341,7 @@ std::vector<EcsDemoEntityConfig> Application::BuildDefaultEcsDemoEntities()
     entities[2].tag = "AfricanHead_Left";
     entities[2].meshPath = "models/african_head.obj";
     entities[2].materialPath = "materials/african_head.material.json";
+    entities[2].colliderType = "mesh";
     entities[2].materialTint = { 0.80f, 0.88f, 1.0f, 1.0f };
     entities[2].position = ecs::Vec3{ -0.60f, 0.9f, 0.0f };
     entities[2].rotation = ecs::Vec3{ 0.0f, 2.72f, 0.0f };
@@ -313,6 +351,7 @@ std::vector<EcsDemoEntityConfig> Application::BuildDefaultEcsDemoEntities()
     entities[3].tag = "AfricanHead_Right";
     entities[3].meshPath = "models/african_head.obj";
     entities[3].materialPath = "materials/african_head.material.json";
+    entities[3].colliderType = "mesh";
     entities[3].materialTint = { 1.0f, 0.90f, 0.82f, 1.0f };
     entities[3].position = ecs::Vec3{ 0.60f, 0.9f, 0.0f };
     entities[3].rotation = ecs::Vec3{ 0.0f, 3.56f, 0.0f };
@@ -409,8 +448,23 @@ void Application::RunEcsBootstrapCheck()
 void Application::SetupEcsRuntimeDemo()
 {
     m_World.ClearSystems();
-    m_PhysicsSystem = &m_World.AddSystem<ecs::PhysicsSystem>(
-        &m_EventBus,
+    m_PhysicsSystem = nullptr;
+    m_AsyncPhysicsSystem = nullptr;
+    // The physics thread ticks on wall-clock time, so recorded, replayed and headless runs step
+    // physics inline to keep the per-frame tick count, and with it the replay hash, reproducible.
+    const bool deterministicRun =
+        m_LaunchOptions.headless || !m_LaunchOptions.recordInputPath.empty() || !m_LaunchOptions.replayInputPath.empty();
+    const bool asyncPhysics = m_Config.physics.asyncThread && !deterministicRun;
+    if (asyncPhysics)
+        Logger::Get().Info("Physics: running on a dedicated thread at " + std::to_string(m_Config.physics.tickRate) + " Hz");
+    else if (m_Config.physics.asyncThread)
+        Logger::Get().Info("Physics: physics.asyncThread ignored for recorded, replayed or headless run; stepping inline");
+    else
+        Logger::Get().Info("Physics: stepping inline on the main thread");
+
+    // On its own thread, physics publishes contacts through the async front end instead.
+    auto physicsSystem = std::make_unique<ecs::PhysicsSystem>(
+        asyncPhysics ? nullptr : &m_EventBus,
         m_Config.physics.gravity,
         m_Config.physics.linearDamping,
         m_Config.physics.substeps,
@@ -421,10 +475,23 @@ void Application::SetupEcsRuntimeDemo()
         m_Config.physics.spherePenetrationEpsilon,
         m_Config.physics.sphereVelocityEpsilon,
         m_Config.physics.dynamicBoxSphereCorrectionPercent);
-    m_PhysicsSystem->SetEnabled(m_EditorPlayMode);
+    physicsSystem->SetAdaptiveSubsteps(m_Config.physics.adaptiveSubsteps, m_Config.physics.maxSubsteps);
+    physicsSystem->SetLodSettings(m_Config.physics.lod);
+    physicsSystem->SetLodFocus(m_Camera.position);
+    physicsSystem->SetEnabled(m_EditorPlayMode);
+    if (asyncPhysics)
+    {
+        m_AsyncPhysicsSystem = &m_World.AddSystem<ecs::AsyncPhysicsSystem>(std::move(physicsSystem), &m_EventBus, m_Config.physics.tickRate);
+        m_AsyncPhysicsSystem->SetEnabled(m_EditorPlayMode);
+    }
+    else
+    {
+        m_PhysicsSystem = &m_World.AddSystem(std::move(physicsSystem));
+    }
     m_RenderSystem = &m_World.AddSystem<ecs::RenderSystem>();
     m_RenderSystem->SetResourceManager(m_ResourceManager.get());
     m_RenderSystem->SetDebugCollidersEnabled(m_DebugCollidersEnabled);
+    m_RenderSystem->SetPhysicsInterpolation(m_AsyncPhysicsSystem);
 
     m_EcsDebugEntities.clear();
     const std::vector<EcsDemoEntityConfig> entities =
@@ -580,12 +647,11 @@ bool Application::LoadCurrentScene(std::string* outError)
 
 void Application::ConfigureInputBindings()
 {
-    auto* primary = dynamic_cast<GlfwWindow*>(GetWindow());
-    if (primary == nullptr)
-        return;
+    if (auto* primary = dynamic_cast<GlfwWindow*>(GetWindow()))
+        m_InputManager.SetWindow(primary->GetGlfwHandle());
 
-    m_InputManager.SetWindow(primary->GetGlfwHandle());
     m_InputManager.BindAction("EnterGameplay", GLFW_KEY_ENTER);
+    m_InputManager.BindAction("EnterGameplayKeypad", GLFW_KEY_KP_ENTER);
     m_InputManager.BindAction("MoveForward", GLFW_KEY_W);
     m_InputManager.BindAction("MoveBackward", GLFW_KEY_S);
     m_InputManager.BindAction("MoveLeft", GLFW_KEY_A);
@@ -599,6 +665,73 @@ void Application::ConfigureInputBindings()
     m_InputManager.BindAction("ToggleDebugColliders", GLFW_KEY_F3);
 }
 
+void Application::RegisterFrameTasks()
+{
+    // Tasks remove each other from inside their steps (scene reloads clear the list); a Run
+    // that cannot finish such a frame would hang the main loop.
+    if (!FrameTaskScheduler::VerifyRemovalDuringRun())
+        Logger::Get().Error("Application: FrameTaskScheduler did not finish a frame with tasks removed mid-run");
+
+    m_FrameTasks.Clear();
+    m_ColliderAutoFitQueue.clear();
+
+    m_FrameTasks.Add("resources.hot_reload", [this]()
+    {
+        if (m_ResourceManager == nullptr)
+            return FrameTaskResult::Yield;
+        const auto watchesPerStep = static_cast<std::size_t>(std::max(1, m_Config.frameTasks.hotReloadWatchesPerStep));
+        return m_ResourceManager->PollHotReload(watchesPerStep) ? FrameTaskResult::Yield : FrameTaskResult::Continue;
+    });
+    m_FrameTasks.Add("physics.collider_autofit", [this]()
+    {
+        return StepColliderAutoFit();
+    });
+    m_FrameTasks.Add("config.hot_reload", [this]()
+    {
+        PollConfigHotReload();
+        return FrameTaskResult::Yield;
+    });
+}
+
+FrameTaskResult Application::StepColliderAutoFit()
+{
+    // Fits are queued by mesh load notifications and by edits to an entity's scale, mesh or
+    // collider. The bounds are precomputed per mesh, so one step drains the queue.
+    for (const ecs::Entity entity : m_ColliderAutoFitQueue)
+        (void)TryFitColliderToMesh(entity);
+    m_ColliderAutoFitQueue.clear();
+    return FrameTaskResult::Yield;
+}
+
+void Application::RequestColliderAutoFit(ecs::Entity entity)
+{
+    m_ColliderAutoFitQueue.push_back(entity);
+}
+
+void Application::QueueColliderAutoFitForMesh(const std::string& meshKey)
+{
+    m_World.ForEach<ecs::ColliderComponent, ecs::MeshRendererComponent>(
+        [&](ecs::Entity entity, ecs::ColliderComponent& collider, ecs::MeshRendererComponent& meshRenderer)
+        {
+            if (NeedsMeshFit(collider) && AssetPaths::NormalizeAssetKey(meshRenderer.meshPath) == meshKey)
+                m_ColliderAutoFitQueue.push_back(entity);
+        });
+}
+
+bool Application::TryFitColliderToMesh(ecs::Entity entity)
+{
+    if (m_ResourceManager == nullptr || !m_World.IsAlive(entity))
+        return false;
+    auto* collider = m_World.GetComponent<ecs::ColliderComponent>(entity);
+    const auto* meshRenderer = m_World.GetComponent<ecs::MeshRendererComponent>(entity);
+    const auto* transform = m_World.GetComponent<ecs::TransformComponent>(entity);
+    if (collider == nullptr || meshRenderer == nullptr || transform == nullptr || !NeedsMeshFit(*collider))
+        return false;
+
+    // Get never loads or logs; a mesh that is not cached yet is fitted by its load notification.
+    return FitColliderToMeshBounds(m_ResourceManager->Get<MeshResource>(meshRenderer->meshPath), transform->scale, *collider);
+}
+
 void Application::PollConfigHotReload()
 {
     std::error_code ec;
@@ -708,35 +841,24 @@ ecs::Entity Application::SpawnEcsDemoEntity(const EcsDemoEntityConfig& entityCfg
     rigidbody.isStatic = entityCfg.isStatic || tag.name == "GroundPlane";
     rigidbody.simulatePhysics = entityCfg.simulatePhysics;
     rigidbody.velocity = entityCfg.linearVelocity;
+    rigidbody.continuousCollision = entityCfg.continuousCollision;
     auto& collider = m_World.AddComponent<ecs::ColliderComponent>(entity);
-    collider.type = (entityCfg.colliderType == "sphere" || entityCfg.colliderType == "Sphere")
-        ? ecs::ColliderType::Sphere
-        : ecs::ColliderType::Box;
+    collider.type = ParseColliderType(entityCfg.colliderType);
     collider.autoFitFromMesh = !entityCfg.colliderManual;
+    collider.layer = entityCfg.collisionLayer;
+    collider.mask = entityCfg.collisionMask;
     collider.halfExtents = ecs::Vec3{ entityCfg.scale.x * 0.5f, entityCfg.scale.y * 0.5f, entityCfg.scale.z * 0.5f };
     collider.offset = ecs::Vec3{};
-    if (!entityCfg.colliderManual)
-    {
-        ecs::Vec3 halfExtents{};
-        ecs::Vec3 offset{};
-        if (TryBuildMeshCollider(m_ResourceManager.get(), meshRenderer.meshPath, entityCfg.scale, halfExtents, offset))
-        {
-            collider.halfExtents = halfExtents;
-            collider.offset = offset;
-            if (meshRenderer.meshPath.find("african_head") != std::string::npos)
-            {
-                collider.halfExtents.x *= 1.08f;
-                collider.halfExtents.y *= 1.10f;
-                collider.halfExtents.z *= 1.18f;
-                collider.offset.y += collider.halfExtents.y * 0.04f;
-            }
-        }
-    }
     if (entityCfg.colliderManual)
     {
         collider.halfExtents = entityCfg.colliderHalfExtents;
         collider.offset = entityCfg.colliderOffset;
-        collider.autoFitFromMesh = false;
+    }
+    if (m_ResourceManager != nullptr && NeedsMeshFit(collider))
+    {
+        const std::string meshKey = AssetPaths::NormalizeAssetKey(meshRenderer.meshPath);
+        if (!meshKey.empty())
+            (void)FitColliderToMeshBounds(m_ResourceManager->Load<MeshResource>(meshKey), entityCfg.scale, collider);
     }
 
     if (tag.name == "RollingSphere")
@@ -779,6 +901,7 @@ ecs::Entity Application::SpawnPhysicsProjectile()
     {
         rb->velocity = projectileCfg.linearVelocity;
         rb->mass = 2.0f;
+        rb->continuousCollision = true;
     }
     if (auto* collider = m_World.GetComponent<ecs::ColliderComponent>(projectile))
     {
@@ -800,8 +923,10 @@ void Application::ExitGameplayScene()
     Logger::Get().Info("Application: exit gameplay scene");
 }
 
-void Application::UpdateCameraController(float dt)
+void Application::GatherCameraInput(InputFrame& frame)
 {
+    frame.SetFlag(InputFrame::CameraControlsActive, false);
+
     auto* primary = dynamic_cast<GlfwWindow*>(GetWindow());
     if (primary == nullptr)
         return;
@@ -855,62 +980,76 @@ void Application::UpdateCameraController(float dt)
     }
 
     m_Camera.previousRightMouseDown = rightMouseDown;
+    frame.SetFlag(InputFrame::CameraControlsActive, m_Camera.controlsActive);
 
     if (!m_Camera.controlsActive)
         return;
 
-    if (std::abs(scrollDeltaY) > 0.001)
-    {
-        const float speedMultiplier =
-            std::pow(m_Camera.scrollSpeedStepMultiplier, static_cast<float>(scrollDeltaY));
-        m_Camera.moveSpeed = std::clamp(
-            m_Camera.moveSpeed * speedMultiplier,
-            m_Camera.minMoveSpeed,
-            m_Camera.maxMoveSpeed);
-    }
+    frame.cameraScroll = static_cast<float>(scrollDeltaY);
 
     glfwGetCursorPos(window, &cursorX, &cursorY);
-
-    const float deltaX = static_cast<float>(cursorX - m_Camera.lastMouseX);
-    const float deltaY = static_cast<float>(cursorY - m_Camera.lastMouseY);
+    frame.cameraLookX = static_cast<float>(cursorX - m_Camera.lastMouseX);
+    frame.cameraLookY = static_cast<float>(cursorY - m_Camera.lastMouseY);
     m_Camera.lastMouseX = cursorX;
     m_Camera.lastMouseY = cursorY;
 
-    m_Camera.yaw += deltaX * m_Camera.mouseSensitivity;
-    m_Camera.pitch = std::clamp(
-        m_Camera.pitch - deltaY * m_Camera.mouseSensitivity,
-        -kMaxCameraPitch,
-        kMaxCameraPitch);
-
-    const ecs::Vec3 worldUp{ 0.0f, 1.0f, 0.0f };
-    const ecs::Vec3 forward = BuildCameraForward(m_Camera.yaw, m_Camera.pitch);
-    const ecs::Vec3 right = Normalize(Cross(worldUp, forward));
-
-    ecs::Vec3 movement{};
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        movement = Add(movement, forward);
+        frame.cameraMove.z += 1.0f;
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        movement = Add(movement, Scale(forward, -1.0f));
+        frame.cameraMove.z -= 1.0f;
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        movement = Add(movement, right);
+        frame.cameraMove.x += 1.0f;
     if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        movement = Add(movement, Scale(right, -1.0f));
+        frame.cameraMove.x -= 1.0f;
     if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS ||
         glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
-        movement = Add(movement, worldUp);
+        frame.cameraMove.y += 1.0f;
 
     const bool downPressed =
         glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS ||
         glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS ||
         glfwGetKey(window, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS;
     if (downPressed)
-        movement = Add(movement, Scale(worldUp, -1.0f));
+        frame.cameraMove.y -= 1.0f;
+
+    frame.SetFlag(InputFrame::CameraBoost, glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS);
+}
+
+void Application::ApplyCameraInput(const InputFrame& frame, float dt)
+{
+    m_Camera.controlsActive = frame.HasFlag(InputFrame::CameraControlsActive);
+    if (!m_Camera.controlsActive)
+        return;
+
+    if (std::abs(frame.cameraScroll) > 0.001f)
+    {
+        const float speedMultiplier =
+            std::pow(m_Camera.scrollSpeedStepMultiplier, frame.cameraScroll);
+        m_Camera.moveSpeed = std::clamp(
+            m_Camera.moveSpeed * speedMultiplier,
+            m_Camera.minMoveSpeed,
+            m_Camera.maxMoveSpeed);
+    }
+
+    m_Camera.yaw += frame.cameraLookX * m_Camera.mouseSensitivity;
+    m_Camera.pitch = std::clamp(
+        m_Camera.pitch - frame.cameraLookY * m_Camera.mouseSensitivity,
+        -kMaxCameraPitch,
+        kMaxCameraPitch);
+
+    const ecs::Vec3 worldUp{ 0.0f, 1.0f, 0.0f };
+    const ecs::Vec3 forward = BuildCameraForward(m_Camera.yaw, m_Camera.pitch);
+    const ecs::Vec3 right = Normalize(Cross(worldUp, forward));
+
+    ecs::Vec3 movement = Scale(forward, frame.cameraMove.z);
+    movement = Add(movement, Scale(right, frame.cameraMove.x));
+    movement = Add(movement, Scale(worldUp, frame.cameraMove.y));
 
     if (Length(movement) <= 0.0001f)
         return;
 
     float speed = m_Camera.moveSpeed;
-    if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+    if (frame.HasFlag(InputFrame::CameraBoost))
         speed *= m_Camera.boostMultiplier;
 
     m_Camera.position = Add(
@@ -918,6 +1057,84 @@ void Application::UpdateCameraController(float dt)
         Scale(Normalize(movement), speed * dt));
 }
 
+bool Application::BeginInputFrame(float& dt, InputFrame& outFrame)
+{
+    outFrame = InputFrame{};
+
+    if (m_InputRecorder.IsReplaying())
+    {
+        if (m_InputRecorder.ReadNextFrame(outFrame))
+        {
+            dt = outFrame.dt;
+            m_InputManager.SetReplayActions(m_InputRecorder.GetReplayActionNames(), outFrame.actionMask);
+            SetEditorPlayMode(outFrame.HasFlag(InputFrame::EditorPlayMode));
+            return true;
+        }
+
+        m_InputRecorder.FinishReplay();
+        m_InputManager.ClearReplayActions();
+        if (m_LaunchOptions.headless)
+            return false;
+
+        Logger::Get().Info("Application: replay finished, returning to live input");
+        outFrame = InputFrame{};
+    }
+
+    outFrame.dt = dt;
+    for (std::size_t i = 0; i < m_RecordedActions.size(); ++i)
+    {
+        if (IsInputActionActive(m_RecordedActions[i]))
+            outFrame.actionMask |= 1u << i;
+    }
+    outFrame.SetFlag(InputFrame::EditorPlayMode, m_EditorPlayMode);
+    GatherCameraInput(outFrame);
+    return true;
+}
+
+void Application::EndInputFrame(const InputFrame& frame)
+{
+    if (!m_InputRecorder.IsRecording() && !m_InputRecorder.IsReplaying())
+        return;
+
+    const std::uint64_t stateHash = ComputeWorldStateHash();
+    if (m_InputRecorder.IsReplaying())
+    {
+        m_InputRecorder.CompareStateHash(frame, stateHash);
+        return;
+    }
+
+    InputFrame recorded = frame;
+    recorded.stateHash = stateHash;
+    m_InputRecorder.RecordFrame(recorded);
+}
+
+std::uint64_t Application::ComputeWorldStateHash()
+{
+    std::pmr::vector<std::pair<ecs::Entity, const ecs::TransformComponent*>> transforms(&FrameArena::ForThisThread());
+    m_World.ForEach<ecs::TransformComponent>(
+        [&](ecs::Entity entity, ecs::TransformComponent& transform)
+        {
+            transforms.emplace_back(entity, &transform);
+        });
+    std::sort(transforms.begin(), transforms.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first.index < rhs.first.index; });
+
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const auto& [entity, transform] : transforms)
+    {
+        hash = HashBytes(hash, &entity.index, sizeof(entity.index));
+        hash = HashBytes(hash, &transform->position, sizeof(transform->position));
+        hash = HashBytes(hash, &transform->rotation, sizeof(transform->rotation));
+        if (const auto* rigidbody = m_World.GetComponent<ecs::RigidbodyComponent>(entity))
+            hash = HashBytes(hash, &rigidbody->velocity, sizeof(rigidbody->velocity));
+    }
+
+    hash = HashBytes(hash, &m_Camera.position, sizeof(m_Camera.position));
+    hash = HashBytes(hash, &m_Camera.yaw, sizeof(m_Camera.yaw));
+    hash = HashBytes(hash, &m_Camera.pitch, sizeof(m_Camera.pitch));
+    return hash;
+}
+
 void Application::UpdateRenderSystemCamera(IWindow* window)
 {
     if (m_RenderSystem == nullptr || window == nullptr)
@@ -948,6 +1165,11 @@ void Application::UpdateRenderSystemCameraAspect(float aspectRatio)
         aspectRatio = kFallbackAspectRatio;
 
     m_RenderSystem->SetCameraTransform(m_Camera.position, m_Camera.yaw, m_Camera.pitch);
+    // Physics LOD follows the camera that renders the frame.
+    if (m_AsyncPhysicsSystem != nullptr)
+        m_AsyncPhysicsSystem->SetLodFocus(m_Camera.position);
+    else if (m_PhysicsSystem != nullptr)
+        m_PhysicsSystem->SetLodFocus(m_Camera.position);
     m_RenderSystem->SetCameraProjection(
         m_Camera.verticalFovRadians,
         aspectRatio,
@@ -985,6 +1207,7 @@ ecs::Entity Application::SpawnGameplayEntity()
     entityCfg.scale = ecs::Vec3{ preset.sx, preset.sy, preset.sz };
     entityCfg.meshPath = "models/african_head.obj";
     entityCfg.materialPath = "materials/african_head.material.json";
+    entityCfg.colliderType = "mesh";
     entityCfg.bounce = false;
 
     const ecs::Entity entity = SpawnEcsDemoEntity(entityCfg);
@@ -1026,8 +1249,32 @@ void Application::ToggleDebugColliders()
     Logger::Get().Info(std::string("Application: debug colliders ") + (m_DebugCollidersEnabled ? "enabled" : "disabled"));
 }
 
+void Application::ToggleFrameCapture()
+{
+    if (m_FrameStats.IsCapturing())
+    {
+        m_FrameStats.StopCapture();
+        return;
+    }
+
+    const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm localTime{};
+#if defined(_WIN32)
+    localtime_s(&localTime, &now);
+#else
+    localtime_r(&now, &localTime);
+#endif
+    char fileName[64];
+    std::strftime(fileName, sizeof(fileName), "frame_capture_%Y%m%d_%H%M%S.csv", &localTime);
+    (void)m_FrameStats.StartCapture(std::filesystem::current_path() / "captures" / fileName);
+}
+
 bool Application::IsInputActionActive(const std::string& action) const
 {
+    // Replayed masks were sampled after the editor keyboard filter below.
+    if (m_InputManager.IsReplaying())
+        return m_InputManager.IsActionActive(action);
+
     if (ImGui::GetCurrentContext() != nullptr && ImGui::GetIO().WantCaptureKeyboard)
         return false;
 
@@ -1042,10 +1289,57 @@ void Application::SetEditorPlayMode(bool enabled)
     m_EditorPlayMode = enabled;
     if (m_PhysicsSystem != nullptr)
         m_PhysicsSystem->SetEnabled(enabled);
+    if (m_AsyncPhysicsSystem != nullptr)
+        m_AsyncPhysicsSystem->SetEnabled(enabled);
 
     Logger::Get().Info(std::string("Application: editor mode -> ") + (enabled ? "Play" : "Edit"));
 }
 
+bool Application::RaycastPhysics(const physics::Ray& ray, physics::RaycastHit& outHit) const
+{
+    if (m_AsyncPhysicsSystem != nullptr)
+        return m_AsyncPhysicsSystem->WithPhysics([&](const ecs::PhysicsSystem& physicsSystem) { return physicsSystem.GetQuery().Raycast(ray, outHit); });
+    return m_PhysicsSystem != nullptr && m_PhysicsSystem->GetQuery().Raycast(ray, outHit);
+}
+
+bool Application::GetPhysicsStepStats(ecs::PhysicsStepStats& outStats) const
+{
+    if (m_AsyncPhysicsSystem != nullptr)
+        outStats = m_AsyncPhysicsSystem->GetStepStats();
+    else if (m_PhysicsSystem != nullptr)
+        outStats = m_PhysicsSystem->GetStepStats();
+    else
+        return false;
+    return true;
+}
+
+void Application::CapturePhysicsState()
+{
+    if (m_AsyncPhysicsSystem != nullptr)
+        m_AsyncPhysicsSystem->CaptureSnapshot(m_World, m_PhysicsState);
+    else if (m_PhysicsSystem != nullptr)
+        m_PhysicsSystem->CaptureSnapshot(m_World, m_PhysicsState);
+    else
+        return;
+
+    Logger::Get().Info("Application: captured physics state bytes=" + std::to_string(m_PhysicsState.size()));
+}
+
+bool Application::RestorePhysicsState()
+{
+    if ((m_PhysicsSystem == nullptr && m_AsyncPhysicsSystem == nullptr) || m_PhysicsState.empty())
+        return false;
+
+    const bool restored = m_AsyncPhysicsSystem != nullptr
+        ? m_AsyncPhysicsSystem->RestoreSnapshot(m_World, m_PhysicsState)
+        : m_PhysicsSystem->RestoreSnapshot(m_World, m_PhysicsState);
+    if (restored)
+        Logger::Get().Info("Application: restored physics state");
+    else
+        Logger::Get().Warn("Application: physics state could not be restored");
+    return restored;
+}
+
 void Application::UpdateEcs(float dt)
 {
     if (m_EcsDebugEntities.empty())
@@ -1085,6 +1379,39 @@ void Application::UpdateEcs(float dt)
     Logger::Get().Info(ss.str());
 }
 
+bool Application::CreatePrimaryWindow(const WindowConfig& windowConfig)
+{
+    WindowContext ctx;
+    ctx.backend = windowConfig.backend;
+    ctx.baseTitle = windowConfig.title + " | " + BackendToString(windowConfig.backend);
+    ctx.clear[0] = windowConfig.clear[0];
+    ctx.clear[1] = windowConfig.clear[1];
+    ctx.clear[2] = windowConfig.clear[2];
+    ctx.clear[3] = windowConfig.clear[3];
+
+    ctx.window = std::make_unique<GlfwWindow>();
+    if (!ctx.window->Create(windowConfig.width, windowConfig.height, ctx.baseTitle))
+        return false;
+
+    ctx.renderer = RenderFactory::Create(ctx.backend);
+    if (!ctx.renderer)
+    {
+        Logger::Get().Error(
+            std::string("Application: renderer backend is unavailable: ") + BackendToString(ctx.backend));
+        return false;
+    }
+
+    if (!ctx.renderer->Initialize(ctx.window.get()))
+        return false;
+
+    ctx.editorUiAvailable = ctx.renderer->InitializeEditorUi(ctx.window.get());
+    if (!ctx.editorUiAvailable)
+        Logger::Get().Warn("Application: editor UI is unavailable for this renderer");
+
+    m_Windows.push_back(std::move(ctx));
+    return true;
+}
+
 bool Application::Initialize()
 {
     Logger::Get().Initialize("engine.log");
@@ -1093,7 +1420,17 @@ bool Application::Initialize()
     if (!ValidateAssetDependencyAvailability())
         return false;
 
+    if (m_LaunchOptions.headless && m_LaunchOptions.replayInputPath.empty())
+    {
+        Logger::Get().Error("Application: --headless requires --replay-input <file>");
+        return false;
+    }
+
     m_ResourceManager = std::make_unique<ResourceManager>();
+    m_ResourceManager->SubscribeLoaded<MeshResource>([this](const std::string& meshKey)
+    {
+        QueueColliderAutoFitForMesh(meshKey);
+    });
     RunResourceBootstrapCheck();
 
     RunEcsBootstrapCheck();
@@ -1146,40 +1483,72 @@ bool Application::Initialize()
         }
     }
 
-    WindowContext ctx;
-    ctx.backend = selectedWindow.backend;
-    ctx.baseTitle = selectedWindow.title + " | " + BackendToString(selectedWindow.backend);
-    ctx.clear[0] = selectedWindow.clear[0];
-    ctx.clear[1] = selectedWindow.clear[1];
-    ctx.clear[2] = selectedWindow.clear[2];
-    ctx.clear[3] = selectedWindow.clear[3];
-
-    ctx.window = std::make_unique<GlfwWindow>();
-    if (!ctx.window->Create(selectedWindow.width, selectedWindow.height, ctx.baseTitle))
+    if (m_LaunchOptions.headless)
+        Logger::Get().Info("Application: headless mode, window and renderer are not created");
+    else if (!CreatePrimaryWindow(selectedWindow))
         return false;
 
-    ctx.renderer = RenderFactory::Create(ctx.backend);
-    if (!ctx.renderer)
+    ConfigureInputBindings();
+    m_EventBus.SubscribeContacts([this](std::span<const ecs::ContactEvent> events){
+        for (const ecs::ContactEvent& e : events)
+        {
+            if (e.state == ecs::ContactEventState::End)
+                continue;
+            const std::uint64_t key = BuildCollisionPairKey(e.a.index, e.b.index);
+            const auto it = std::lower_bound(m_ActiveCollisionPairs.begin(), m_ActiveCollisionPairs.end(), key);
+            if (it == m_ActiveCollisionPairs.end() || *it != key)
+                m_ActiveCollisionPairs.insert(it, key);
+        }
+    });
+    SetupEcsRuntimeDemo();
+    InitializeConfigHotReload();
+    RegisterFrameTasks();
+
+    if (!m_LaunchOptions.replayInputPath.empty())
     {
-        Logger::Get().Error(
-            std::string("Application: renderer backend is unavailable: ") + BackendToString(ctx.backend));
-        return false;
+        std::string replayError;
+        if (!m_InputRecorder.LoadReplay(m_LaunchOptions.replayInputPath, &replayError))
+        {
+            Logger::Get().Error(replayError);
+            return false;
+        }
+
+        if (!m_LaunchOptions.recordInputPath.empty())
+            Logger::Get().Warn("Application: --record-input is ignored while replaying");
+    }
+    else if (!m_LaunchOptions.recordInputPath.empty())
+    {
+        m_RecordedActions = m_InputManager.GetBoundActions();
+        (void)m_InputRecorder.StartRecording(m_LaunchOptions.recordInputPath, m_RecordedActions);
     }
 
-    if (!ctx.renderer->Initialize(ctx.window.get()))
-        return false;
+    if (!m_LaunchOptions.frameCapturePath.empty())
+        (void)m_FrameStats.StartCapture(m_LaunchOptions.frameCapturePath, m_LaunchOptions.frameCaptureFrames);
 
-    ctx.editorUiAvailable = ctx.renderer->InitializeEditorUi(ctx.window.get());
-    if (!ctx.editorUiAvailable)
-        Logger::Get().Warn("Application: editor UI is unavailable for this renderer");
+    if (m_LaunchOptions.allocationBudget > 0 || !m_LaunchOptions.allocationReportPath.empty())
+    {
+        if (!AllocationTracker::IsEnabled())
+            Logger::Get().Warn("Application: allocation budget/report requested but WHISP_TRACK_ALLOCATIONS is off");
+        AllocationTracker::SetFrameBudget(m_LaunchOptions.allocationBudget, m_LaunchOptions.allocationBudgetWarmupFrames);
+    }
 
-    m_Windows.push_back(std::move(ctx));
-    ConfigureInputBindings();
-    m_EventBus.SubscribeCollision([this](const ecs::CollisionEvent& e){
-        m_ActiveCollisionPairs.insert(BuildCollisionPairKey(e.a.index, e.b.index));
-    });
-    SetupEcsRuntimeDemo();
-    InitializeConfigHotReload();
+    if (m_LaunchOptions.jobThreads > 0)
+        JobSystem::Get().SetWorkerCount(m_LaunchOptions.jobThreads - 1);
+    Logger::Get().Info("Application: job system running on " + std::to_string(JobSystem::Get().GetThreadCount()) + " thread(s)");
+
+    // The batched narrowphase must agree bit for bit with the scalar path (replays and the
+    // thread-count determinism rely on it); fall back to scalar if this build does not.
+    const std::size_t kernelMismatches = physics::VerifyNarrowphaseKernels(4096);
+    if (kernelMismatches == 0)
+    {
+        Logger::Get().Info(std::string("Application: narrowphase kernels ") + physics::GetNarrowphaseKernelName() + ", bit-exact with scalar");
+    }
+    else
+    {
+        physics::SetNarrowphaseSimdEnabled(false);
+        Logger::Get().Warn("Application: " + std::string(physics::GetNarrowphaseKernelName()) + " narrowphase kernels differ from scalar in " +
+            std::to_string(kernelMismatches) + " results; using scalar kernels");
+    }
 
     m_IsRunning = true;
 
@@ -1198,6 +1567,8 @@ int Application::Run()
 
     while (m_IsRunning)
     {
+        const auto frameStart = std::chrono::steady_clock::now();
+
         if (!m_Windows.empty())
             m_Windows[0].window->PollEvents();
 
@@ -1217,43 +1588,41 @@ int Application::Run()
                 }
             }
             prevF5 = f5;
+
+            static bool prevF9 = false;
+            const bool f9 = glfwGetKey(w, GLFW_KEY_F9) == GLFW_PRESS;
+            if (f9 && !prevF9)
+                ToggleFrameCapture();
+            prevF9 = f9;
         }
 
-        bool anyAlive = false;
+        bool anyAlive = m_LaunchOptions.headless;
         for (auto& wc : m_Windows)
             anyAlive |= (wc.window && !wc.window->ShouldClose());
 
         if (!anyAlive) break;
 
         float dt = m_Time.Tick();
+        InputFrame inputFrame;
+        if (!BeginInputFrame(dt, inputFrame))
+            break;
+
+        m_FrameStats.BeginFrame();
         if (m_ResourceManager != nullptr)
         {
-            m_ResourceManager->PollAsyncLoads();
-            m_ResourceManager->PollHotReload();
-            m_World.ForEach<ecs::ColliderComponent, ecs::MeshRendererComponent, ecs::TransformComponent>(
-                [&](ecs::Entity, ecs::ColliderComponent& collider, ecs::MeshRendererComponent& meshRenderer, ecs::TransformComponent& transform)
-                {
-                    if (!collider.autoFitFromMesh)
-                        return;
-                    ecs::Vec3 halfExtents{};
-                    ecs::Vec3 offset{};
-                    if (TryBuildMeshCollider(m_ResourceManager.get(), meshRenderer.meshPath, transform.scale, halfExtents, offset))
-                    {
-                        collider.halfExtents = halfExtents;
-                        collider.offset = offset;
-                        if (meshRenderer.meshPath.find("african_head") != std::string::npos)
-                        {
-                            collider.halfExtents.x *= 1.08f;
-                            collider.halfExtents.y *= 1.10f;
-                            collider.halfExtents.z *= 1.18f;
-                            collider.offset.y += collider.halfExtents.y * 0.04f;
-                        }
-                        collider.autoFitFromMesh = false;
-                    }
-                });
+            FramePhaseTimer timer(m_FrameStats, FramePhase::AsyncLoads);
+            const std::size_t completedLoads = m_ResourceManager->PollAsyncLoads();
+            m_FrameStats.AddCounter(FramePhase::AsyncLoads, static_cast<std::uint32_t>(completedLoads));
+        }
+        {
+            // Recorded and replayed runs drain all tasks so collider fits land on the same frame.
+            const bool deterministic = m_InputRecorder.IsRecording() || m_InputRecorder.IsReplaying();
+            FramePhaseTimer timer(m_FrameStats, FramePhase::FrameTasks);
+            m_FrameTasks.Run(deterministic ? FrameTaskScheduler::kUnlimitedBudget : m_Config.frameTasks.budgetMs);
         }
-        PollConfigHotReload();
-        UpdateCameraController(dt);
+
+        FramePhaseTimer gameplayTimer(m_FrameStats, FramePhase::Gameplay);
+        ApplyCameraInput(inputFrame, dt);
 
         if (m_UpdateMode == UpdateMode::Fixed)
         {
@@ -1274,6 +1643,7 @@ int Application::Run()
             m_StateMachine.Update(*this, dt);
             m_StateMachine.ApplyPending(*this);
         }
+        gameplayTimer.Stop();
 
         static float fpsTimer = 0.0f;
         static int fpsFrames = 0;
@@ -1284,6 +1654,7 @@ int Application::Run()
         if (fpsTimer >= 1.0f)
         {
             float fps = fpsFrames / fpsTimer;
+            const FrameStats::Summary frameSummary = m_FrameStats.GetSessionSummary();
 
             for (auto& wc : m_Windows)
             {
@@ -1291,16 +1662,19 @@ int Application::Run()
 
                 char title[256];
                 snprintf(title, sizeof(title),
-                    "%s | FPS: %.1f | dt: %.3f ms",
+                    "%s | FPS: %.1f | dt: %.3f ms | p99: %.2f ms | max: %.2f ms%s",
                     wc.baseTitle.c_str(),
                     fps,
-                    dt * 1000.0f);
+                    dt * 1000.0f,
+                    frameSummary.p99Ms,
+                    frameSummary.maxMs,
+                    m_FrameStats.IsCapturing() ? " | REC" : "");
 
                 wc.window->SetTitle(title);
             }
 
             std::ostringstream ss;
-            ss << "FPS=" << fps << " dt(ms)=" << dt * 1000.0f;
+            ss << "FPS=" << fps << " dt(ms)=" << dt * 1000.0f << " " << FrameStats::FormatSummary(frameSummary);
             Logger::Get().Info(ss.str());
 
             fpsTimer = 0.0f;
@@ -1314,6 +1688,7 @@ int Application::Run()
             wc.renderer->BeginFrame();
             if (wc.editorUiAvailable)
             {
+                FramePhaseTimer timer(m_FrameStats, FramePhase::Editor);
                 wc.renderer->BeginEditorUiFrame();
                 m_EditorLayer.Render(*this, wc.renderer.get(), dt);
             }
@@ -1335,7 +1710,10 @@ int Application::Run()
                     UpdateRenderSystemCameraAspect(static_cast<float>(viewportWidth) / static_cast<float>(viewportHeight));
                 }
 
-                m_World.UpdateSystems(dt);
+                {
+                    FramePhaseTimer timer(m_FrameStats, FramePhase::Systems);
+                    m_World.UpdateSystems(dt);
+                }
                 UpdateEcs(dt);
                 m_StateMachine.Render(*this, *wc.renderer);
                 wc.renderer->EndViewportRender();
@@ -1352,26 +1730,79 @@ int Application::Run()
                     UpdateRenderSystemCamera(wc.window.get());
                 }
 
-                m_World.UpdateSystems(dt);
+                {
+                    FramePhaseTimer timer(m_FrameStats, FramePhase::Systems);
+                    m_World.UpdateSystems(dt);
+                }
                 UpdateEcs(dt);
                 m_StateMachine.Render(*this, *wc.renderer);
             }
 
             if (wc.editorUiAvailable)
+            {
+                FramePhaseTimer timer(m_FrameStats, FramePhase::Editor);
                 wc.renderer->RenderEditorUiFrame();
+            }
 
-            wc.renderer->EndFrame();
-            wc.renderer->Present();
+            {
+                FramePhaseTimer timer(m_FrameStats, FramePhase::Present);
+                wc.renderer->EndFrame();
+                wc.renderer->Present();
+            }
 
             if (m_RenderSystem != nullptr)
                 m_RenderSystem->SetRenderAdapter(nullptr);
         }
+
+        if (m_Windows.empty())
+        {
+            m_ActiveCollisionPairs.clear();
+            {
+                FramePhaseTimer timer(m_FrameStats, FramePhase::Systems);
+                m_World.UpdateSystems(dt);
+            }
+            UpdateEcs(dt);
+        }
+
+        EndInputFrame(inputFrame);
+
+        if (m_RenderSystem != nullptr)
+        {
+            // Uploads run inside RenderSystem::Update, so move them out of the Systems phase.
+            const ecs::RenderSystem::GpuUploadStats uploads = m_RenderSystem->ConsumeGpuUploadStats();
+            m_FrameStats.MovePhaseTime(FramePhase::Systems, FramePhase::GpuUpload, uploads.milliseconds);
+            m_FrameStats.AddCounter(FramePhase::GpuUpload, uploads.uploads);
+        }
+
+        const std::chrono::duration<double, std::milli> frameElapsed = std::chrono::steady_clock::now() - frameStart;
+        m_FrameStats.EndFrame(frameElapsed.count(), dt);
+        AllocationTracker::EndFrame();
+        FrameArena::ResetAll();
     }
+
+    if (!m_LaunchOptions.allocationReportPath.empty())
+    {
+        std::string reportError;
+        if (!AllocationTracker::WriteReport(m_LaunchOptions.allocationReportPath, &reportError))
+            Logger::Get().Error(reportError);
+    }
+
+    if (const std::uint64_t violations = AllocationTracker::GetBudgetViolationCount(); violations > 0)
+    {
+        Logger::Get().Error(
+            "Application: allocation budget exceeded in " + std::to_string(violations) + " frame(s)");
+        return 2;
+    }
+
     return 0;
 }
 
 void Application::Shutdown()
 {
+    m_FrameStats.StopCapture();
+    m_InputRecorder.StopRecording();
+    m_InputRecorder.FinishReplay();
+
     if (auto* primary = dynamic_cast<GlfwWindow*>(GetWindow()))
     {
         if (GLFWwindow* window = primary->GetGlfwHandle(); window != nullptr)
@@ -1401,6 +1832,7 @@ void Application::Shutdown()
     m_ResourceManager.reset();
     m_World.ClearSystems();
     m_PhysicsSystem = nullptr;
+    m_AsyncPhysicsSystem = nullptr;
     m_RenderSystem = nullptr;
     m_EcsDebugEntities.clear();
     m_EcsDebugLogTimer = 0.0f;
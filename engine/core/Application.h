@@ -4,9 +4,12 @@
 #include <vector>
 #include <string>
 #include <cstdint>
-#include <unordered_set>
 
+#include "CommandLine.h"
 #include "ConfigLoader.h"
+#include "FrameStats.h"
+#include "FrameTaskScheduler.h"
+#include "InputRecorder.h"
 #include "Time.h"
 #include "../ecs/World.h"
 #include "../ecs/systems/RenderSystem.h"
@@ -21,7 +24,8 @@ class IWindow;
 class IRenderAdapter;
 class IGameState;
 class ResourceManager;
-namespace ecs { class PhysicsSystem; }
+namespace ecs { class PhysicsSystem; class AsyncPhysicsSystem; struct PhysicsStepStats; }
+namespace physics { struct Ray; struct RaycastHit; }
 
 enum class UpdateMode { 
     Variable, 
@@ -38,6 +42,7 @@ public:
     int Run();
     void Shutdown();
     void SetUpdateMode(UpdateMode m) { m_UpdateMode = m; }
+    void SetLaunchOptions(const LaunchOptions& options) { m_LaunchOptions = options; }
 
     IWindow* GetWindow() { return m_Windows.empty() ? nullptr : m_Windows[0].window.get(); }
     ecs::World& GetWorld() { return m_World; }
@@ -58,12 +63,30 @@ public:
     float GetCameraVerticalFovRadians() const { return m_Camera.verticalFovRadians; }
     float GetCameraNearPlane() const { return m_Camera.nearPlane; }
     float GetCameraFarPlane() const { return m_Camera.farPlane; }
+    // Null while physics runs on its own thread; RaycastPhysics works in both modes.
+    const ecs::PhysicsSystem* GetPhysicsSystem() const { return m_PhysicsSystem; }
+    bool RaycastPhysics(const physics::Ray& ray, physics::RaycastHit& outHit) const;
+    // Counters and phase timings of the last physics step (the last tick on the physics
+    // thread); false without a physics system.
+    bool GetPhysicsStepStats(ecs::PhysicsStepStats& outStats) const;
     bool IsEditorPlayMode() const { return m_EditorPlayMode; }
     void SetEditorPlayMode(bool enabled);
     void ToggleDebugColliders();
     bool IsInputActionActive(const std::string& action) const;
     bool SaveCurrentScene(std::string* outError = nullptr);
     bool LoadCurrentScene(std::string* outError = nullptr);
+    const FrameStats& GetFrameStats() const { return m_FrameStats; }
+    FrameTaskScheduler& GetFrameTasks() { return m_FrameTasks; }
+    const FrameTaskScheduler& GetFrameTasks() const { return m_FrameTasks; }
+    void ToggleFrameCapture();
+    // Keeps one physics snapshot for rewinding: restoring it puts every body back where the
+    // capture found it, and the following steps replay from there.
+    void CapturePhysicsState();
+    bool RestorePhysicsState();
+    bool HasPhysicsState() const { return !m_PhysicsState.empty(); }
+    // Refits the entity's collider from its mesh on the next frame, after its scale, mesh or
+    // collider settings changed.
+    void RequestColliderAutoFit(ecs::Entity entity);
 
     void RequestStateChange(std::unique_ptr<IGameState> s);
 
@@ -76,11 +99,20 @@ private:
     void SetupEcsRuntimeDemo();
     void InitializeConfigHotReload();
     void PollConfigHotReload();
+    void RegisterFrameTasks();
+    FrameTaskResult StepColliderAutoFit();
+    void QueueColliderAutoFitForMesh(const std::string& meshKey);
+    bool TryFitColliderToMesh(ecs::Entity entity);
     bool ReloadSceneFromCurrentConfig(const char* reason);
     void ConfigureInputBindings();
     ecs::Entity SpawnEcsDemoEntity(const EcsDemoEntityConfig& entityCfg);
     void UpdateEcs(float dt);
-    void UpdateCameraController(float dt);
+    bool CreatePrimaryWindow(const WindowConfig& windowConfig);
+    bool BeginInputFrame(float& dt, InputFrame& outFrame);
+    void EndInputFrame(const InputFrame& frame);
+    void GatherCameraInput(InputFrame& frame);
+    void ApplyCameraInput(const InputFrame& frame, float dt);
+    std::uint64_t ComputeWorldStateHash();
     void UpdateRenderSystemCamera(IWindow* window);
     void UpdateRenderSystemCameraAspect(float aspectRatio);
 
@@ -124,6 +156,7 @@ private:
 
     ecs::World m_World;
     ecs::PhysicsSystem* m_PhysicsSystem = nullptr;
+    ecs::AsyncPhysicsSystem* m_AsyncPhysicsSystem = nullptr;
     ecs::RenderSystem* m_RenderSystem = nullptr;
     std::vector<ecs::Entity> m_EcsDebugEntities;
     float m_EcsDebugLogTimer = 0.0f;
@@ -135,6 +168,13 @@ private:
     bool m_HasSceneWatch = false;
 
     Time m_Time;
+    FrameStats m_FrameStats;
+    FrameTaskScheduler m_FrameTasks;
+    std::vector<ecs::Entity> m_ColliderAutoFitQueue;
+    std::vector<std::uint8_t> m_PhysicsState;
+    LaunchOptions m_LaunchOptions;
+    InputRecorder m_InputRecorder;
+    std::vector<std::string> m_RecordedActions;
     StateMachine m_StateMachine;
     CameraControllerState m_Camera;
     bool m_DebugCollidersEnabled = false;
@@ -142,7 +182,8 @@ private:
     ecs::EventBus m_EventBus;
     InputManager m_InputManager;
     editor::EditorLayer m_EditorLayer;
-    std::unordered_set<std::uint64_t> m_ActiveCollisionPairs;
+    // Sorted and deduplicated; a vector keeps its capacity across frames.
+    std::vector<std::uint64_t> m_ActiveCollisionPairs;
 
     UpdateMode m_UpdateMode = UpdateMode::Variable;
 
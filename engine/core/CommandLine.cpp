@@ -0,0 +1,58 @@
+#include "CommandLine.h"
+#include "Logger.h"
+
+#include <cstdlib>
+#include <string_view>
+
+namespace
+{
+bool ReadValue(int argc, char** argv, int& index, std::string_view flag, std::string& outValue)
+{
+    const std::string_view arg = argv[index];
+    if (arg.size() > flag.size() && arg.substr(0, flag.size()) == flag && arg[flag.size()] == '=')
+    {
+        outValue = std::string(arg.substr(flag.size() + 1));
+        return true;
+    }
+
+    if (arg == flag && index + 1 < argc)
+    {
+        outValue = argv[++index];
+        return true;
+    }
+
+    return false;
+}
+}
+
+LaunchOptions CommandLine::Parse(int argc, char** argv)
+{
+    LaunchOptions options;
+    std::string value;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (ReadValue(argc, argv, i, "--capture-frames", value))
+            options.frameCapturePath = value;
+        else if (ReadValue(argc, argv, i, "--capture-frame-count", value))
+            options.frameCaptureFrames = std::strtoull(value.c_str(), nullptr, 10);
+        else if (ReadValue(argc, argv, i, "--record-input", value))
+            options.recordInputPath = value;
+        else if (ReadValue(argc, argv, i, "--replay-input", value))
+            options.replayInputPath = value;
+        else if (ReadValue(argc, argv, i, "--alloc-report", value))
+            options.allocationReportPath = value;
+        else if (ReadValue(argc, argv, i, "--alloc-budget", value))
+            options.allocationBudget = std::strtoull(value.c_str(), nullptr, 10);
+        else if (ReadValue(argc, argv, i, "--alloc-budget-warmup", value))
+            options.allocationBudgetWarmupFrames = std::strtoull(value.c_str(), nullptr, 10);
+        else if (ReadValue(argc, argv, i, "--job-threads", value))
+            options.jobThreads = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        else if (std::string_view(argv[i]) == "--headless")
+            options.headless = true;
+        else
+            Logger::Get().Warn(std::string("CommandLine: ignoring unknown argument ") + argv[i]);
+    }
+
+    return options;
+}
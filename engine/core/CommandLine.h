@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+struct LaunchOptions
+{
+    std::string frameCapturePath;
+    std::uint64_t frameCaptureFrames = 0;
+    std::string recordInputPath;
+    std::string replayInputPath;
+    bool headless = false;
+    std::string allocationReportPath;
+    std::uint64_t allocationBudget = 0;
+    std::uint64_t allocationBudgetWarmupFrames = 120;
+    // Total job threads including the main thread; 0 keeps the hardware default.
+    std::uint32_t jobThreads = 0;
+};
+
+class CommandLine
+{
+public:
+    static LaunchOptions Parse(int argc, char** argv);
+};
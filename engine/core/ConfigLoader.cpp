@@ -145,6 +145,9 @@ bool ConfigLoader::Load(const std::string& path, AppConfig& outCfg, std::string*
                 entityCfg.simulatePhysics = je.value("simulatePhysics", true);
                 entityCfg.isStatic = je.value("isStatic", false);
                 entityCfg.useGravity = je.value("useGravity", true);
+                entityCfg.continuousCollision = je.value("continuousCollision", false);
+                entityCfg.collisionLayer = je.value("collisionLayer", entityCfg.collisionLayer);
+                entityCfg.collisionMask = je.value("collisionMask", entityCfg.collisionMask);
 
                 if (je.contains("x")) entityCfg.position.x = je.value("x", 0.0f);
                 if (je.contains("y")) entityCfg.position.y = je.value("y", 0.0f);
@@ -178,6 +181,22 @@ bool ConfigLoader::Load(const std::string& path, AppConfig& outCfg, std::string*
         outCfg.physics.restitution = physics.value("restitution", outCfg.physics.restitution);
         outCfg.physics.friction = physics.value("friction", outCfg.physics.friction);
         outCfg.physics.solverIterations = physics.value("solverIterations", outCfg.physics.solverIterations);
+        outCfg.physics.adaptiveSubsteps = physics.value("adaptiveSubsteps", outCfg.physics.adaptiveSubsteps);
+        outCfg.physics.maxSubsteps = physics.value("maxSubsteps", outCfg.physics.maxSubsteps);
+        outCfg.physics.asyncThread = physics.value("asyncThread", outCfg.physics.asyncThread);
+        outCfg.physics.tickRate = physics.value("tickRate", outCfg.physics.tickRate);
+        if (physics.contains("lod") && physics["lod"].is_object())
+        {
+            const auto& lod = physics["lod"];
+            physics::LodSettings& lodCfg = outCfg.physics.lod;
+            lodCfg.enabled = lod.value("enabled", lodCfg.enabled);
+            lodCfg.nearDistance = lod.value("nearDistance", lodCfg.nearDistance);
+            lodCfg.farDistance = lod.value("farDistance", lodCfg.farDistance);
+            lodCfg.freezeDistance = lod.value("freezeDistance", lodCfg.freezeDistance);
+            lodCfg.reducedSolverIterations = lod.value("reducedSolverIterations", lodCfg.reducedSolverIterations);
+            lodCfg.distantInterval = lod.value("distantInterval", lodCfg.distantInterval);
+            lodCfg.hysteresis = lod.value("hysteresis", lodCfg.hysteresis);
+        }
         outCfg.physics.sphereMaxSpeed = physics.value("sphereMaxSpeed", outCfg.physics.sphereMaxSpeed);
         outCfg.physics.spherePenetrationEpsilon = physics.value("spherePenetrationEpsilon", outCfg.physics.spherePenetrationEpsilon);
         outCfg.physics.sphereVelocityEpsilon = physics.value("sphereVelocityEpsilon", outCfg.physics.sphereVelocityEpsilon);
@@ -185,6 +204,13 @@ bool ConfigLoader::Load(const std::string& path, AppConfig& outCfg, std::string*
         outCfg.physics.rollingSphereProfile = physics.value("rollingSphereProfile", outCfg.physics.rollingSphereProfile);
     }
 
+    if (j.contains("frameTasks") && j["frameTasks"].is_object())
+    {
+        const auto& frameTasks = j["frameTasks"];
+        outCfg.frameTasks.budgetMs = frameTasks.value("budgetMs", outCfg.frameTasks.budgetMs);
+        outCfg.frameTasks.hotReloadWatchesPerStep = frameTasks.value("hotReloadWatchesPerStep", outCfg.frameTasks.hotReloadWatchesPerStep);
+    }
+
     Logger::Get().Info(
         "ConfigLoader: loaded " + std::to_string(outCfg.windows.size()) +
         " windows from config, active renderer=" + std::string(j.value("activeRenderer", "DX12")) +
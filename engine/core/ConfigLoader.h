@@ -1,10 +1,12 @@
 #pragma once
 #include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "../ecs/MathTypes.h"
 #include "../ecs/components/MeshRendererComponent.h"
+#include "../physics/PhysicsLod.h"
 #include "../render/RenderFactory.h" 
 
 struct WindowConfig
@@ -38,6 +40,10 @@ struct EcsDemoEntityConfig
     bool simulatePhysics = true;
     bool isStatic = false;
     bool useGravity = true;
+    bool continuousCollision = false;
+    // Collider layer and mask bits; see ColliderComponent.
+    std::uint32_t collisionLayer = 1u;
+    std::uint32_t collisionMask = 0xFFFFFFFFu;
 };
 
 struct EcsDemoConfig
@@ -53,10 +59,18 @@ struct AppConfig
     {
         float gravity = 9.81f;
         float linearDamping = 0.985f;
-        int substeps = 2;
+        int substeps = 4;
         float restitution = 0.05f;
         float friction = 0.85f;
         int solverIterations = 4;
+        // Per-island substep counts, up to maxSubsteps for fast groups.
+        bool adaptiveSubsteps = false;
+        int maxSubsteps = 8;
+        // Step physics on its own thread at tickRate Hz; rendering sees interpolated results.
+        bool asyncThread = false;
+        float tickRate = 60.0f;
+        // Distance LOD around the camera; see physics::LodSettings.
+        physics::LodSettings lod;
         float sphereMaxSpeed = 9.0f;
         float spherePenetrationEpsilon = 0.0005f;
         float sphereVelocityEpsilon = 0.05f;
@@ -64,10 +78,18 @@ struct AppConfig
         std::string rollingSphereProfile = "stable";
     };
 
+    // Time-sliced maintenance work (hot reload polling, collider auto-fit, asset scans).
+    struct FrameTaskConfig
+    {
+        float budgetMs = 2.0f;
+        int hotReloadWatchesPerStep = 8;
+    };
+
     RenderBackend activeBackend = RenderBackend::DX12;
     std::vector<WindowConfig> windows;
     EcsDemoConfig ecsDemo;
     PhysicsConfig physics;
+    FrameTaskConfig frameTasks;
 };
 
 class ConfigLoader
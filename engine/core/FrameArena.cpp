@@ -0,0 +1,131 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+namespace
+{
+std::mutex& RegistryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<FrameArena*>& Registry()
+{
+    static std::vector<FrameArena*> arenas;
+    return arenas;
+}
+
+struct ThreadArena
+{
+    FrameArena arena;
+
+    ThreadArena()
+    {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        Registry().push_back(&arena);
+    }
+
+    ~ThreadArena()
+    {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        auto& arenas = Registry();
+        arenas.erase(std::remove(arenas.begin(), arenas.end(), &arena), arenas.end());
+    }
+};
+}
+
+FrameArena::FrameArena(std::size_t blockSize)
+    : m_BlockSize(std::max<std::size_t>(blockSize, 4096))
+{
+    m_Blocks.push_back(Block{ std::make_unique_for_overwrite<std::byte[]>(m_BlockSize), m_BlockSize });
+}
+
+FrameArena::~FrameArena() = default;
+
+std::size_t FrameArena::GetCapacity() const
+{
+    std::size_t capacity = 0;
+    for (const Block& block : m_Blocks)
+        capacity += block.size;
+    return capacity;
+}
+
+void FrameArena::Reset()
+{
+    // A frame that spilled into extra blocks gets one block big enough for all
+    // of them, so the next frame of the same size stays inside a single block.
+    if (m_Blocks.size() > 1)
+    {
+        const std::size_t capacity = GetCapacity();
+        m_Blocks.clear();
+        m_Blocks.push_back(Block{ std::make_unique_for_overwrite<std::byte[]>(capacity), capacity });
+    }
+
+    m_CurrentBlock = 0;
+    m_Offset = 0;
+    m_BytesUsed = 0;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    for (;;)
+    {
+        Block& block = m_Blocks[m_CurrentBlock];
+        const auto base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+        const std::uintptr_t aligned = (base + m_Offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        const std::size_t end = static_cast<std::size_t>(aligned - base) + bytes;
+        if (end <= block.size)
+        {
+            m_BytesUsed += end - m_Offset;
+            m_PeakBytesUsed = std::max(m_PeakBytesUsed, m_BytesUsed);
+            m_Offset = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        if (m_CurrentBlock + 1 >= m_Blocks.size())
+        {
+            const std::size_t size = std::max(m_BlockSize, bytes + alignment);
+            m_Blocks.push_back(Block{ std::make_unique_for_overwrite<std::byte[]>(size), size });
+            ++m_OverflowCount;
+        }
+
+        ++m_CurrentBlock;
+        m_Offset = 0;
+    }
+}
+
+void FrameArena::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    (void)pointer;
+    (void)bytes;
+    (void)alignment;
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+FrameArena& FrameArena::ForThisThread()
+{
+    thread_local ThreadArena threadArena;
+    return threadArena.arena;
+}
+
+void FrameArena::ResetAll()
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    for (FrameArena* arena : Registry())
+        arena->Reset();
+}
+
+void FrameArena::ExcludeThisThreadFromResetAll()
+{
+    FrameArena* arena = &ForThisThread();
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    auto& arenas = Registry();
+    arenas.erase(std::remove(arenas.begin(), arenas.end(), arena), arenas.end());
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Linear per-thread scratch memory for data that lives at most one frame.
+// Deallocation is a no-op; everything is released by Reset() at frame end.
+class FrameArena final : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t kDefaultBlockSize = 256 * 1024;
+
+    explicit FrameArena(std::size_t blockSize = kDefaultBlockSize);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void Reset();
+
+    [[nodiscard]] std::size_t GetBytesUsed() const { return m_BytesUsed; }
+    [[nodiscard]] std::size_t GetPeakBytesUsed() const { return m_PeakBytesUsed; }
+    [[nodiscard]] std::size_t GetCapacity() const;
+    [[nodiscard]] std::size_t GetOverflowCount() const { return m_OverflowCount; }
+
+    static FrameArena& ForThisThread();
+    // Only call while no other thread is using its arena (frame end).
+    static void ResetAll();
+    // Leaves this thread's arena out of ResetAll, for a thread that runs its own loop and
+    // resets its arena itself between iterations.
+    static void ExcludeThisThreadFromResetAll();
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t size = 0;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::vector<Block> m_Blocks;
+    std::size_t m_BlockSize = kDefaultBlockSize;
+    std::size_t m_CurrentBlock = 0;
+    std::size_t m_Offset = 0;
+    std::size_t m_BytesUsed = 0;
+    std::size_t m_PeakBytesUsed = 0;
+    std::size_t m_OverflowCount = 0;
+};
@@ -0,0 +1,257 @@
+#include "FrameStats.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+FrameTimeHistogram::FrameTimeHistogram()
+    : m_Buckets(kBucketCount, 0)
+{
+}
+
+std::uint32_t FrameTimeHistogram::BucketForMicros(std::uint64_t micros)
+{
+    if (micros < kLinearBuckets)
+        return static_cast<std::uint32_t>(micros);
+
+    const std::uint32_t msb = static_cast<std::uint32_t>(std::bit_width(micros)) - 1;
+    const std::uint32_t shift = std::min(msb - 9u, kExponents);
+    const std::uint64_t sub = std::min<std::uint64_t>(micros >> shift, 2 * kSubBuckets - 1);
+    return kLinearBuckets + (shift - 1) * kSubBuckets + static_cast<std::uint32_t>(sub - kSubBuckets);
+}
+
+double FrameTimeHistogram::BucketMidpointMs(std::uint32_t bucket)
+{
+    if (bucket < kLinearBuckets)
+        return (static_cast<double>(bucket) + 0.5) / 1000.0;
+
+    const std::uint32_t index = bucket - kLinearBuckets;
+    const std::uint32_t shift = index / kSubBuckets + 1;
+    const std::uint64_t sub = index % kSubBuckets + kSubBuckets;
+    const double low = static_cast<double>(sub << shift);
+    const double width = static_cast<double>(std::uint64_t{ 1 } << shift);
+    return (low + width * 0.5) / 1000.0;
+}
+
+void FrameTimeHistogram::Record(double milliseconds)
+{
+    const double clamped = std::max(milliseconds, 0.0);
+    const auto micros = static_cast<std::uint64_t>(clamped * 1000.0);
+    ++m_Buckets[BucketForMicros(micros)];
+    ++m_Count;
+    m_TotalMs += clamped;
+    m_MaxMs = std::max(m_MaxMs, clamped);
+}
+
+void FrameTimeHistogram::Reset()
+{
+    std::fill(m_Buckets.begin(), m_Buckets.end(), 0u);
+    m_Count = 0;
+    m_TotalMs = 0.0;
+    m_MaxMs = 0.0;
+}
+
+double FrameTimeHistogram::Percentile(double fraction) const
+{
+    if (m_Count == 0)
+        return 0.0;
+
+    const double clampedFraction = std::clamp(fraction, 0.0, 1.0);
+    const auto target = std::max<std::uint64_t>(
+        1,
+        static_cast<std::uint64_t>(std::ceil(clampedFraction * static_cast<double>(m_Count))));
+
+    std::uint64_t cumulative = 0;
+    for (std::uint32_t bucket = 0; bucket < kBucketCount; ++bucket)
+    {
+        cumulative += m_Buckets[bucket];
+        if (cumulative >= target)
+            return std::min(BucketMidpointMs(bucket), m_MaxMs);
+    }
+
+    return m_MaxMs;
+}
+
+void FrameStats::BeginFrame()
+{
+    m_PhaseMs.fill(0.0);
+    m_Counters.fill(0);
+}
+
+void FrameStats::AddPhaseTime(FramePhase phase, double milliseconds)
+{
+    m_PhaseMs[static_cast<std::size_t>(phase)] += milliseconds;
+}
+
+void FrameStats::MovePhaseTime(FramePhase from, FramePhase to, double milliseconds)
+{
+    double& source = m_PhaseMs[static_cast<std::size_t>(from)];
+    const double moved = std::min(source, milliseconds);
+    source -= moved;
+    m_PhaseMs[static_cast<std::size_t>(to)] += moved;
+}
+
+void FrameStats::AddCounter(FramePhase phase, std::uint32_t count)
+{
+    m_Counters[static_cast<std::size_t>(phase)] += count;
+}
+
+void FrameStats::CountHitches(double frameMilliseconds, HitchCounts& hitches)
+{
+    for (std::size_t i = 0; i < kHitchThresholdsMs.size(); ++i)
+    {
+        if (frameMilliseconds >= kHitchThresholdsMs[i])
+            ++hitches[i];
+    }
+}
+
+void FrameStats::EndFrame(double frameMilliseconds, float simulationDt)
+{
+    m_Session.Record(frameMilliseconds);
+    CountHitches(frameMilliseconds, m_SessionHitches);
+    m_LastPhaseMs = m_PhaseMs;
+
+    if (m_Capturing)
+    {
+        m_Capture.Record(frameMilliseconds);
+        CountHitches(frameMilliseconds, m_CaptureHitches);
+        WriteCaptureRow(frameMilliseconds, simulationDt);
+        ++m_CaptureFrames;
+        if (m_CaptureMaxFrames > 0 && m_CaptureFrames >= m_CaptureMaxFrames)
+            StopCapture();
+    }
+
+    ++m_FrameIndex;
+}
+
+void FrameStats::ResetSession()
+{
+    m_Session.Reset();
+    m_SessionHitches.fill(0);
+}
+
+bool FrameStats::StartCapture(const std::filesystem::path& path, std::uint64_t maxFrames)
+{
+    if (m_Capturing)
+        StopCapture();
+
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+    m_CaptureFile.open(path, std::ios::out | std::ios::trunc);
+    if (!m_CaptureFile.is_open())
+    {
+        Logger::Get().Warn("FrameStats: cannot open capture file " + path.string());
+        return false;
+    }
+
+    m_CaptureFile << "frame,elapsed_ms,frame_ms,sim_dt_ms";
+    for (std::size_t i = 0; i < static_cast<std::size_t>(FramePhase::Count); ++i)
+        m_CaptureFile << ',' << PhaseName(static_cast<FramePhase>(i)) << "_ms";
+    m_CaptureFile << ",async_completed,gpu_uploads,hitch\n";
+
+    m_Capture.Reset();
+    m_CaptureHitches.fill(0);
+    m_CapturePath = path;
+    m_CaptureFrames = 0;
+    m_CaptureMaxFrames = maxFrames;
+    m_CaptureElapsedMs = 0.0;
+    m_Capturing = true;
+    Logger::Get().Info(
+        "FrameStats: capture started -> " + path.string() +
+        (maxFrames > 0 ? " (" + std::to_string(maxFrames) + " frames)" : std::string()));
+    return true;
+}
+
+void FrameStats::StopCapture()
+{
+    if (!m_Capturing)
+        return;
+
+    m_Capturing = false;
+    m_CaptureFile.close();
+    Logger::Get().Info(
+        "FrameStats: capture stopped -> " + m_CapturePath.string() +
+        " " + FormatSummary(GetCaptureSummary()));
+}
+
+void FrameStats::WriteCaptureRow(double frameMilliseconds, float simulationDt)
+{
+    m_CaptureElapsedMs += frameMilliseconds;
+
+    char row[64];
+    std::snprintf(row, sizeof(row), "%llu,%.3f,%.3f,%.3f",
+        static_cast<unsigned long long>(m_CaptureFrames),
+        m_CaptureElapsedMs,
+        frameMilliseconds,
+        static_cast<double>(simulationDt) * 1000.0);
+    m_CaptureFile << row;
+
+    for (const double phaseMs : m_PhaseMs)
+    {
+        std::snprintf(row, sizeof(row), ",%.3f", phaseMs);
+        m_CaptureFile << row;
+    }
+
+    int hitchLevel = 0;
+    for (const double threshold : kHitchThresholdsMs)
+    {
+        if (frameMilliseconds >= threshold)
+            ++hitchLevel;
+    }
+
+    m_CaptureFile
+        << ',' << m_Counters[static_cast<std::size_t>(FramePhase::AsyncLoads)]
+        << ',' << m_Counters[static_cast<std::size_t>(FramePhase::GpuUpload)]
+        << ',' << hitchLevel << '\n';
+}
+
+FrameStats::Summary FrameStats::BuildSummary(const FrameTimeHistogram& histogram, const HitchCounts& hitches)
+{
+    Summary summary;
+    summary.frameCount = histogram.GetCount();
+    summary.averageMs = histogram.GetAverageMs();
+    summary.p50Ms = histogram.Percentile(0.50);
+    summary.p90Ms = histogram.Percentile(0.90);
+    summary.p99Ms = histogram.Percentile(0.99);
+    summary.p999Ms = histogram.Percentile(0.999);
+    summary.maxMs = histogram.GetMaxMs();
+    summary.hitchCounts = hitches;
+    return summary;
+}
+
+const char* FrameStats::PhaseName(FramePhase phase)
+{
+    switch (phase)
+    {
+    case FramePhase::AsyncLoads:   return "async_loads";
+    case FramePhase::FrameTasks:   return "frame_tasks";
+    case FramePhase::Gameplay:     return "gameplay";
+    case FramePhase::Systems:      return "systems";
+    case FramePhase::GpuUpload:    return "gpu_upload";
+    case FramePhase::Editor:       return "editor";
+    case FramePhase::Present:      return "present";
+    default:                       return "unknown";
+    }
+}
+
+std::string FrameStats::FormatSummary(const Summary& summary)
+{
+    std::ostringstream ss;
+    ss.setf(std::ios::fixed);
+    ss.precision(2);
+    ss << "frames=" << summary.frameCount
+       << " avg=" << summary.averageMs
+       << "ms p50=" << summary.p50Ms
+       << "ms p90=" << summary.p90Ms
+       << "ms p99=" << summary.p99Ms
+       << "ms p99.9=" << summary.p999Ms
+       << "ms max=" << summary.maxMs << "ms hitches";
+    for (std::size_t i = 0; i < kHitchThresholdsMs.size(); ++i)
+        ss << " >" << kHitchThresholdsMs[i] << "ms=" << summary.hitchCounts[i];
+    return ss.str();
+}
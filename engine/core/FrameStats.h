@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum class FramePhase
+{
+    AsyncLoads,
+    FrameTasks,
+    Gameplay,
+    Systems,
+    GpuUpload,
+    Editor,
+    Present,
+    Count
+};
+
+// Log-linear histogram over microseconds: exact below ~1 ms, <0.2% relative
+// error above, so tail percentiles stay meaningful without storing every sample.
+class FrameTimeHistogram
+{
+public:
+    FrameTimeHistogram();
+
+    void Record(double milliseconds);
+    void Reset();
+
+    [[nodiscard]] double Percentile(double fraction) const;
+    [[nodiscard]] double GetMaxMs() const { return m_MaxMs; }
+    [[nodiscard]] double GetAverageMs() const { return m_Count > 0 ? m_TotalMs / static_cast<double>(m_Count) : 0.0; }
+    [[nodiscard]] std::uint64_t GetCount() const { return m_Count; }
+
+private:
+    static constexpr std::uint32_t kLinearBuckets = 1024;
+    static constexpr std::uint32_t kSubBuckets = 512;
+    static constexpr std::uint32_t kExponents = 15;
+    static constexpr std::uint32_t kBucketCount = kLinearBuckets + kExponents * kSubBuckets;
+
+    static std::uint32_t BucketForMicros(std::uint64_t micros);
+    static double BucketMidpointMs(std::uint32_t bucket);
+
+    std::vector<std::uint32_t> m_Buckets;
+    std::uint64_t m_Count = 0;
+    double m_TotalMs = 0.0;
+    double m_MaxMs = 0.0;
+};
+
+class FrameStats
+{
+public:
+    static constexpr std::array<double, 3> kHitchThresholdsMs = { 33.3, 50.0, 100.0 };
+
+    struct Summary
+    {
+        std::uint64_t frameCount = 0;
+        double averageMs = 0.0;
+        double p50Ms = 0.0;
+        double p90Ms = 0.0;
+        double p99Ms = 0.0;
+        double p999Ms = 0.0;
+        double maxMs = 0.0;
+        std::array<std::uint64_t, kHitchThresholdsMs.size()> hitchCounts{};
+    };
+
+    void BeginFrame();
+    void AddPhaseTime(FramePhase phase, double milliseconds);
+    void MovePhaseTime(FramePhase from, FramePhase to, double milliseconds);
+    void AddCounter(FramePhase phase, std::uint32_t count);
+    void EndFrame(double frameMilliseconds, float simulationDt);
+
+    [[nodiscard]] Summary GetSessionSummary() const { return BuildSummary(m_Session, m_SessionHitches); }
+    [[nodiscard]] Summary GetCaptureSummary() const { return BuildSummary(m_Capture, m_CaptureHitches); }
+    [[nodiscard]] double GetLastPhaseTime(FramePhase phase) const { return m_LastPhaseMs[static_cast<std::size_t>(phase)]; }
+    [[nodiscard]] std::uint64_t GetFrameIndex() const { return m_FrameIndex; }
+    void ResetSession();
+
+    bool StartCapture(const std::filesystem::path& path, std::uint64_t maxFrames = 0);
+    void StopCapture();
+    [[nodiscard]] bool IsCapturing() const { return m_Capturing; }
+    [[nodiscard]] const std::filesystem::path& GetCapturePath() const { return m_CapturePath; }
+
+    static const char* PhaseName(FramePhase phase);
+    static std::string FormatSummary(const Summary& summary);
+
+private:
+    using HitchCounts = std::array<std::uint64_t, kHitchThresholdsMs.size()>;
+    using PhaseArray = std::array<double, static_cast<std::size_t>(FramePhase::Count)>;
+    using CounterArray = std::array<std::uint32_t, static_cast<std::size_t>(FramePhase::Count)>;
+
+    static Summary BuildSummary(const FrameTimeHistogram& histogram, const HitchCounts& hitches);
+    static void CountHitches(double frameMilliseconds, HitchCounts& hitches);
+    void WriteCaptureRow(double frameMilliseconds, float simulationDt);
+
+    FrameTimeHistogram m_Session;
+    FrameTimeHistogram m_Capture;
+    HitchCounts m_SessionHitches{};
+    HitchCounts m_CaptureHitches{};
+    PhaseArray m_PhaseMs{};
+    PhaseArray m_LastPhaseMs{};
+    CounterArray m_Counters{};
+    std::uint64_t m_FrameIndex = 0;
+
+    bool m_Capturing = false;
+    std::ofstream m_CaptureFile;
+    std::filesystem::path m_CapturePath;
+    std::uint64_t m_CaptureFrames = 0;
+    std::uint64_t m_CaptureMaxFrames = 0;
+    double m_CaptureElapsedMs = 0.0;
+};
+
+class FramePhaseTimer
+{
+public:
+    FramePhaseTimer(FrameStats& stats, FramePhase phase)
+        : m_Stats(stats)
+        , m_Phase(phase)
+        , m_Start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~FramePhaseTimer()
+    {
+        Stop();
+    }
+
+    void Stop()
+    {
+        if (m_Stopped)
+            return;
+
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_Start;
+        m_Stats.AddPhaseTime(m_Phase, elapsed.count());
+        m_Stopped = true;
+    }
+
+    FramePhaseTimer(const FramePhaseTimer&) = delete;
+    FramePhaseTimer& operator=(const FramePhaseTimer&) = delete;
+
+private:
+    FrameStats& m_Stats;
+    FramePhase m_Phase;
+    std::chrono::steady_clock::time_point m_Start;
+    bool m_Stopped = false;
+};
@@ -0,0 +1,165 @@
+#include "FrameTaskScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+FrameTaskScheduler::TaskId FrameTaskScheduler::Add(std::string name, TaskFunction function)
+{
+    Task task;
+    task.id = m_NextId++;
+    task.function = std::move(function);
+    task.stats.name = std::move(name);
+    const TaskId id = task.id;
+    if (m_Running)
+        m_AddedWhileRunning.push_back(std::move(task));
+    else
+        m_Tasks.push_back(std::move(task));
+    return id;
+}
+
+void FrameTaskScheduler::Remove(TaskId id)
+{
+    for (Task& task : m_Tasks)
+    {
+        if (task.id == id)
+            task.removed = true;
+    }
+    std::erase_if(m_AddedWhileRunning, [id](const Task& task) { return task.id == id; });
+
+    if (!m_Running)
+    {
+        std::erase_if(m_Tasks, [](const Task& task) { return task.removed; });
+        m_Cursor = m_Tasks.empty() ? 0 : m_Cursor % m_Tasks.size();
+    }
+}
+
+void FrameTaskScheduler::Clear()
+{
+    for (Task& task : m_Tasks)
+        task.removed = true;
+    m_AddedWhileRunning.clear();
+
+    if (!m_Running)
+    {
+        m_Tasks.clear();
+        m_Cursor = 0;
+    }
+}
+
+double FrameTaskScheduler::Run(double budgetMilliseconds)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const auto elapsedMs = [&start](Clock::time_point now)
+    {
+        return std::chrono::duration<double, std::milli>(now - start).count();
+    };
+
+    m_Running = true;
+    for (Task& task : m_Tasks)
+    {
+        task.yielded = false;
+        task.deferred = false;
+        task.stats.lastFrameSteps = 0;
+        task.stats.lastFrameMs = 0.0;
+    }
+
+    const std::size_t taskCount = m_Tasks.size();
+    std::size_t activeTasks = taskCount;
+    bool budgetSpent = false;
+    while (activeTasks > 0 && taskCount > 0)
+    {
+        Task& task = m_Tasks[m_Cursor % taskCount];
+        m_Cursor = (m_Cursor + 1) % taskCount;
+        if (task.yielded)
+            continue;
+        // Removed by another step this frame before it yielded; it is done for this Run.
+        if (task.removed)
+        {
+            task.yielded = true;
+            --activeTasks;
+            continue;
+        }
+
+        // Over budget, a task only runs if it has not had its guaranteed step yet.
+        if (budgetSpent && task.stats.lastFrameSteps > 0)
+        {
+            task.yielded = true;
+            task.deferred = true;
+            --activeTasks;
+            continue;
+        }
+
+        const auto stepStart = Clock::now();
+        const FrameTaskResult result = task.function();
+        const auto stepEnd = Clock::now();
+
+        task.stats.lastFrameMs += std::chrono::duration<double, std::milli>(stepEnd - stepStart).count();
+        ++task.stats.lastFrameSteps;
+        ++task.stats.totalSteps;
+
+        if (result == FrameTaskResult::Finished)
+            task.removed = true;
+        if (result != FrameTaskResult::Continue)
+        {
+            task.yielded = true;
+            --activeTasks;
+        }
+
+        budgetSpent = elapsedMs(stepEnd) >= budgetMilliseconds;
+    }
+
+    m_LastFrameDeferred = 0;
+    for (Task& task : m_Tasks)
+    {
+        task.stats.maxFrameMs = std::max(task.stats.maxFrameMs, task.stats.lastFrameMs);
+        if (task.deferred && !task.removed)
+            ++m_LastFrameDeferred;
+    }
+
+    m_Running = false;
+    std::erase_if(m_Tasks, [](const Task& task) { return task.removed; });
+    for (Task& task : m_AddedWhileRunning)
+        m_Tasks.push_back(std::move(task));
+    m_AddedWhileRunning.clear();
+    m_Cursor = m_Tasks.empty() ? 0 : m_Cursor % m_Tasks.size();
+
+    m_LastFrameMs = elapsedMs(Clock::now());
+    return m_LastFrameMs;
+}
+
+std::vector<FrameTaskScheduler::TaskStats> FrameTaskScheduler::GetTaskStats() const
+{
+    std::vector<TaskStats> stats;
+    stats.reserve(m_Tasks.size());
+    for (const Task& task : m_Tasks)
+        stats.push_back(task.stats);
+    return stats;
+}
+
+bool FrameTaskScheduler::VerifyRemovalDuringRun()
+{
+    FrameTaskScheduler scheduler;
+    TaskId removedId = 0;
+    bool removedRan = false;
+    (void)scheduler.Add("remover", [&scheduler, &removedId]()
+    {
+        scheduler.Remove(removedId);
+        return FrameTaskResult::Continue;
+    });
+    removedId = scheduler.Add("removed", [&removedRan]()
+    {
+        removedRan = true;
+        return FrameTaskResult::Continue;
+    });
+    (void)scheduler.Add("clearer", [&scheduler]()
+    {
+        scheduler.Clear();
+        return FrameTaskResult::Continue;
+    });
+
+    // Both the remover and the clearer keep returning Continue, so Run only ends once the
+    // removed tasks count as done.
+    (void)scheduler.Run(kUnlimitedBudget);
+    return !removedRan && scheduler.GetTaskCount() == 0;
+}
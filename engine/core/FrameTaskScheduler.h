@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+enum class FrameTaskResult
+{
+    // More work is ready; the scheduler may call the task again this frame.
+    Continue,
+    // Nothing left to do this frame; call again next frame.
+    Yield,
+    // The task is done and gets removed.
+    Finished
+};
+
+// Runs resumable maintenance work inside a per-frame time budget. Each call to a task
+// should do one small, bounded step; the scheduler round-robins across tasks until the
+// budget is spent, so a large backlog is spread over several frames instead of one.
+class FrameTaskScheduler
+{
+public:
+    using TaskId = std::uint32_t;
+    using TaskFunction = std::function<FrameTaskResult()>;
+
+    static constexpr double kUnlimitedBudget = std::numeric_limits<double>::infinity();
+
+    struct TaskStats
+    {
+        std::string name;
+        std::uint32_t lastFrameSteps = 0;
+        double lastFrameMs = 0.0;
+        double maxFrameMs = 0.0;
+        std::uint64_t totalSteps = 0;
+    };
+
+    TaskId Add(std::string name, TaskFunction function);
+    void Remove(TaskId id);
+    void Clear();
+
+    void SetBudgetMilliseconds(double milliseconds) { m_BudgetMs = milliseconds; }
+    [[nodiscard]] double GetBudgetMilliseconds() const { return m_BudgetMs; }
+
+    // Steps tasks until every task yielded or the budget is spent. Every task that has work
+    // gets at least one step per frame so nothing starves. Returns the milliseconds used.
+    double Run(double budgetMilliseconds);
+    double Run() { return Run(m_BudgetMs); }
+
+    [[nodiscard]] std::size_t GetTaskCount() const { return m_Tasks.size(); }
+    [[nodiscard]] double GetLastFrameMs() const { return m_LastFrameMs; }
+    [[nodiscard]] std::uint32_t GetLastFrameDeferredTasks() const { return m_LastFrameDeferred; }
+    [[nodiscard]] std::vector<TaskStats> GetTaskStats() const;
+
+    // Runs a scratch scheduler whose tasks Remove and Clear each other mid-Run; true when Run
+    // returned with the removed tasks skipped and gone.
+    static bool VerifyRemovalDuringRun();
+
+private:
+    struct Task
+    {
+        TaskId id = 0;
+        TaskFunction function;
+        TaskStats stats;
+        bool yielded = false;
+        bool deferred = false;
+        bool removed = false;
+    };
+
+    std::vector<Task> m_Tasks;
+    // Tasks added from inside a step; they join after the current Run.
+    std::vector<Task> m_AddedWhileRunning;
+    TaskId m_NextId = 1;
+    std::size_t m_Cursor = 0;
+    double m_BudgetMs = 2.0;
+    double m_LastFrameMs = 0.0;
+    std::uint32_t m_LastFrameDeferred = 0;
+    bool m_Running = false;
+};
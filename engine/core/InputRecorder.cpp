@@ -0,0 +1,211 @@
+#include "InputRecorder.h"
+#include "Logger.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr char kInputRecordingMagic[4] = { 'W', 'I', 'N', 'P' };
+constexpr std::uint32_t kInputRecordingVersion = 1;
+
+template <typename T>
+void WriteValue(std::ofstream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadValue(std::ifstream& stream, T& outValue)
+{
+    stream.read(reinterpret_cast<char*>(&outValue), sizeof(T));
+    return stream.good();
+}
+
+void SetError(std::string* outError, const std::string& message)
+{
+    if (outError != nullptr)
+        *outError = message;
+}
+}
+
+bool InputRecorder::StartRecording(const std::filesystem::path& path, const std::vector<std::string>& actionNames)
+{
+    StopRecording();
+
+    if (actionNames.size() > kMaxActions)
+    {
+        Logger::Get().Warn("InputRecorder: too many bound actions to record (" + std::to_string(actionNames.size()) + ")");
+        return false;
+    }
+
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+    m_RecordFile.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_RecordFile.is_open())
+    {
+        Logger::Get().Warn("InputRecorder: cannot open recording file " + path.string());
+        return false;
+    }
+
+    m_RecordFile.write(kInputRecordingMagic, sizeof(kInputRecordingMagic));
+    WriteValue(m_RecordFile, kInputRecordingVersion);
+    WriteValue(m_RecordFile, static_cast<std::uint32_t>(actionNames.size()));
+    for (const auto& name : actionNames)
+    {
+        WriteValue(m_RecordFile, static_cast<std::uint16_t>(name.size()));
+        m_RecordFile.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+
+    m_RecordPath = path;
+    m_RecordedFrames = 0;
+    m_Recording = true;
+    Logger::Get().Info("InputRecorder: recording input -> " + path.string());
+    return true;
+}
+
+void InputRecorder::RecordFrame(const InputFrame& frame)
+{
+    if (!m_Recording)
+        return;
+
+    WriteValue(m_RecordFile, frame.dt);
+    WriteValue(m_RecordFile, frame.actionMask);
+    WriteValue(m_RecordFile, frame.cameraMove.x);
+    WriteValue(m_RecordFile, frame.cameraMove.y);
+    WriteValue(m_RecordFile, frame.cameraMove.z);
+    WriteValue(m_RecordFile, frame.cameraLookX);
+    WriteValue(m_RecordFile, frame.cameraLookY);
+    WriteValue(m_RecordFile, frame.cameraScroll);
+    WriteValue(m_RecordFile, frame.flags);
+    WriteValue(m_RecordFile, frame.stateHash);
+    ++m_RecordedFrames;
+}
+
+void InputRecorder::StopRecording()
+{
+    if (!m_Recording)
+        return;
+
+    m_Recording = false;
+    m_RecordFile.close();
+    Logger::Get().Info(
+        "InputRecorder: recording stopped -> " + m_RecordPath.string() +
+        " frames=" + std::to_string(m_RecordedFrames));
+}
+
+bool InputRecorder::LoadReplay(const std::filesystem::path& path, std::string* outError)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream.is_open())
+    {
+        SetError(outError, "InputRecorder: cannot open replay file " + path.string());
+        return false;
+    }
+
+    char magic[4]{};
+    std::uint32_t version = 0;
+    std::uint32_t actionCount = 0;
+    stream.read(magic, sizeof(magic));
+    if (!ReadValue(stream, version) ||
+        !ReadValue(stream, actionCount) ||
+        std::memcmp(magic, kInputRecordingMagic, sizeof(kInputRecordingMagic)) != 0 ||
+        version != kInputRecordingVersion ||
+        actionCount > kMaxActions)
+    {
+        SetError(outError, "InputRecorder: unsupported replay file " + path.string());
+        return false;
+    }
+
+    std::vector<std::string> actionNames(actionCount);
+    for (auto& name : actionNames)
+    {
+        std::uint16_t length = 0;
+        if (!ReadValue(stream, length))
+        {
+            SetError(outError, "InputRecorder: truncated action table in " + path.string());
+            return false;
+        }
+
+        name.resize(length);
+        stream.read(name.data(), length);
+    }
+
+    std::vector<InputFrame> frames;
+    for (;;)
+    {
+        InputFrame frame;
+        if (!ReadValue(stream, frame.dt))
+            break;
+
+        const bool complete =
+            ReadValue(stream, frame.actionMask) &&
+            ReadValue(stream, frame.cameraMove.x) &&
+            ReadValue(stream, frame.cameraMove.y) &&
+            ReadValue(stream, frame.cameraMove.z) &&
+            ReadValue(stream, frame.cameraLookX) &&
+            ReadValue(stream, frame.cameraLookY) &&
+            ReadValue(stream, frame.cameraScroll) &&
+            ReadValue(stream, frame.flags) &&
+            ReadValue(stream, frame.stateHash);
+        if (!complete)
+        {
+            Logger::Get().Warn("InputRecorder: dropping truncated trailing frame in " + path.string());
+            break;
+        }
+
+        frames.push_back(frame);
+    }
+
+    m_ReplayActionNames = std::move(actionNames);
+    m_ReplayFrames = std::move(frames);
+    m_ReplayPath = path;
+    m_ReplayCursor = 0;
+    m_HashMismatches = 0;
+    m_FirstMismatchFrame = 0;
+    m_Replaying = true;
+    Logger::Get().Info(
+        "InputRecorder: replaying " + path.string() +
+        " frames=" + std::to_string(m_ReplayFrames.size()) +
+        " actions=" + std::to_string(m_ReplayActionNames.size()));
+    return true;
+}
+
+bool InputRecorder::ReadNextFrame(InputFrame& outFrame)
+{
+    if (!m_Replaying || m_ReplayCursor >= m_ReplayFrames.size())
+        return false;
+
+    outFrame = m_ReplayFrames[m_ReplayCursor++];
+    return true;
+}
+
+void InputRecorder::CompareStateHash(const InputFrame& recorded, std::uint64_t actualHash)
+{
+    if (!m_Replaying || recorded.stateHash == actualHash)
+        return;
+
+    if (m_HashMismatches == 0)
+    {
+        m_FirstMismatchFrame = m_ReplayCursor - 1;
+        Logger::Get().Warn(
+            "InputRecorder: replay diverged from recording at frame " + std::to_string(m_FirstMismatchFrame));
+    }
+    ++m_HashMismatches;
+}
+
+void InputRecorder::FinishReplay()
+{
+    if (!m_Replaying)
+        return;
+
+    m_Replaying = false;
+    const std::string result = m_HashMismatches == 0
+        ? std::string("matched recording")
+        : "diverged on " + std::to_string(m_HashMismatches) + " frames, first at " + std::to_string(m_FirstMismatchFrame);
+    Logger::Get().Info(
+        "InputRecorder: replay finished -> " + m_ReplayPath.string() +
+        " frames=" + std::to_string(m_ReplayCursor) + "/" + std::to_string(m_ReplayFrames.size()) +
+        " " + result);
+}
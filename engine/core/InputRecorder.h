@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../ecs/MathTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct InputFrame
+{
+    enum Flags : std::uint8_t
+    {
+        CameraControlsActive = 1 << 0,
+        CameraBoost = 1 << 1,
+        EditorPlayMode = 1 << 2
+    };
+
+    float dt = 0.0f;
+    std::uint32_t actionMask = 0;
+    // Camera axes in camera space: x = right, y = world up, z = forward.
+    ecs::Vec3 cameraMove{};
+    float cameraLookX = 0.0f;
+    float cameraLookY = 0.0f;
+    float cameraScroll = 0.0f;
+    std::uint8_t flags = 0;
+    std::uint64_t stateHash = 0;
+
+    [[nodiscard]] bool HasFlag(Flags flag) const { return (flags & flag) != 0; }
+    void SetFlag(Flags flag, bool enabled) { flags = static_cast<std::uint8_t>(enabled ? (flags | flag) : (flags & ~flag)); }
+};
+
+class InputRecorder
+{
+public:
+    static constexpr std::size_t kMaxActions = 32;
+
+    bool StartRecording(const std::filesystem::path& path, const std::vector<std::string>& actionNames);
+    void RecordFrame(const InputFrame& frame);
+    void StopRecording();
+    [[nodiscard]] bool IsRecording() const { return m_Recording; }
+
+    bool LoadReplay(const std::filesystem::path& path, std::string* outError = nullptr);
+    bool ReadNextFrame(InputFrame& outFrame);
+    void CompareStateHash(const InputFrame& recorded, std::uint64_t actualHash);
+    void FinishReplay();
+    [[nodiscard]] bool IsReplaying() const { return m_Replaying; }
+    [[nodiscard]] const std::vector<std::string>& GetReplayActionNames() const { return m_ReplayActionNames; }
+    [[nodiscard]] std::size_t GetReplayFrameCount() const { return m_ReplayFrames.size(); }
+    [[nodiscard]] std::size_t GetReplayCursor() const { return m_ReplayCursor; }
+    [[nodiscard]] std::uint64_t GetHashMismatchCount() const { return m_HashMismatches; }
+
+private:
+    std::ofstream m_RecordFile;
+    std::filesystem::path m_RecordPath;
+    std::uint64_t m_RecordedFrames = 0;
+    bool m_Recording = false;
+
+    std::vector<std::string> m_ReplayActionNames;
+    std::vector<InputFrame> m_ReplayFrames;
+    std::filesystem::path m_ReplayPath;
+    std::size_t m_ReplayCursor = 0;
+    std::uint64_t m_HashMismatches = 0;
+    std::size_t m_FirstMismatchFrame = 0;
+    bool m_Replaying = false;
+};
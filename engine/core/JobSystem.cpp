@@ -0,0 +1,145 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+thread_local std::size_t t_ThreadIndex = 0;
+thread_local bool t_InsideJob = false;
+}
+
+JobSystem& JobSystem::Get()
+{
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::JobSystem()
+{
+    const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    SetWorkerCount(hardwareThreads > 1 ? std::min<std::size_t>(hardwareThreads - 1, 15) : 0);
+}
+
+JobSystem::~JobSystem()
+{
+    StopWorkers();
+}
+
+std::size_t JobSystem::GetThreadIndex()
+{
+    return t_ThreadIndex;
+}
+
+void JobSystem::SetWorkerCount(std::size_t workerCount)
+{
+    std::lock_guard<std::mutex> dispatchLock(m_DispatchMutex);
+    if (workerCount == m_Workers.size())
+        return;
+
+    StopWorkers();
+    m_Stopping = false;
+    m_Workers.reserve(workerCount);
+    for (std::size_t i = 0; i < workerCount; ++i)
+        m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+}
+
+void JobSystem::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_WakeWorkers.notify_all();
+    for (std::thread& worker : m_Workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+    m_Workers.clear();
+}
+
+void JobSystem::Dispatch(std::size_t count, std::size_t grainSize, void* context, ChunkFunction invoke)
+{
+    if (count == 0)
+        return;
+
+    grainSize = std::max<std::size_t>(grainSize, 1);
+    const std::size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (t_InsideJob || chunkCount == 1 || m_Workers.empty())
+    {
+        for (std::size_t begin = 0; begin < count; begin += grainSize)
+            invoke(context, begin, std::min(begin + grainSize, count));
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(m_DispatchMutex);
+    {
+        // A worker that woke late for the previous batch may still be inside RunChunks.
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_BatchDone.wait(lock, [this]() { return m_ActiveWorkers == 0; });
+        m_Batch.context = context;
+        m_Batch.invoke = invoke;
+        m_Batch.count = count;
+        m_Batch.grainSize = grainSize;
+        m_Batch.chunkCount = chunkCount;
+        m_Batch.nextChunk.store(0, std::memory_order_relaxed);
+        m_Batch.finishedChunks.store(0, std::memory_order_relaxed);
+        ++m_BatchGeneration;
+    }
+    m_WakeWorkers.notify_all();
+
+    RunChunks(m_Batch);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    // Workers must also have left RunChunks before the batch (and the caller's lambda) goes away.
+    m_BatchDone.wait(lock, [this]()
+    {
+        return m_Batch.finishedChunks.load(std::memory_order_acquire) == m_Batch.chunkCount && m_ActiveWorkers == 0;
+    });
+}
+
+void JobSystem::RunChunks(Batch& batch)
+{
+    const bool wasInsideJob = t_InsideJob;
+    t_InsideJob = true;
+    for (;;)
+    {
+        const std::size_t chunk = batch.nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= batch.chunkCount)
+            break;
+        const std::size_t begin = chunk * batch.grainSize;
+        batch.invoke(batch.context, begin, std::min(begin + batch.grainSize, batch.count));
+        batch.finishedChunks.fetch_add(1, std::memory_order_acq_rel);
+    }
+    t_InsideJob = wasInsideJob;
+}
+
+void JobSystem::WorkerLoop(std::size_t threadIndex)
+{
+    t_ThreadIndex = threadIndex;
+    std::uint64_t seenGeneration = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        seenGeneration = m_BatchGeneration;
+    }
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WakeWorkers.wait(lock, [&]() { return m_Stopping || m_BatchGeneration != seenGeneration; });
+            if (m_Stopping)
+                return;
+            seenGeneration = m_BatchGeneration;
+            ++m_ActiveWorkers;
+        }
+
+        RunChunks(m_Batch);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            --m_ActiveWorkers;
+        }
+        m_BatchDone.notify_all();
+    }
+}
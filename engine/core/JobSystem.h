@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed pool of worker threads for data-parallel loops. The calling thread takes part in
+// every ParallelFor, and nested calls from inside a job run inline.
+class JobSystem
+{
+public:
+    static JobSystem& Get();
+
+    // 0 runs everything on the calling thread. Defaults to hardware threads - 1.
+    void SetWorkerCount(std::size_t workerCount);
+    [[nodiscard]] std::size_t GetWorkerCount() const { return m_Workers.size(); }
+    // Worker threads plus the calling thread.
+    [[nodiscard]] std::size_t GetThreadCount() const { return m_Workers.size() + 1; }
+    // 0 on the calling thread, 1..N on workers; stable for the lifetime of the pool.
+    static std::size_t GetThreadIndex();
+
+    // Runs fn(begin, end) over [0, count) in chunks of grainSize and returns when all are done.
+    // Chunk boundaries depend only on count and grainSize, never on the thread count.
+    template <typename Fn>
+    void ParallelFor(std::size_t count, std::size_t grainSize, Fn&& fn)
+    {
+        auto invoke = [](void* context, std::size_t begin, std::size_t end)
+        {
+            (*static_cast<std::remove_reference_t<Fn>*>(context))(begin, end);
+        };
+        Dispatch(count, grainSize, &fn, invoke);
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+private:
+    using ChunkFunction = void (*)(void* context, std::size_t begin, std::size_t end);
+
+    struct Batch
+    {
+        void* context = nullptr;
+        ChunkFunction invoke = nullptr;
+        std::size_t count = 0;
+        std::size_t grainSize = 1;
+        std::size_t chunkCount = 0;
+        std::atomic<std::size_t> nextChunk{ 0 };
+        std::atomic<std::size_t> finishedChunks{ 0 };
+    };
+
+    JobSystem();
+    ~JobSystem();
+
+    void Dispatch(std::size_t count, std::size_t grainSize, void* context, ChunkFunction invoke);
+    void RunChunks(Batch& batch);
+    void WorkerLoop(std::size_t threadIndex);
+    void StopWorkers();
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_DispatchMutex;
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeWorkers;
+    std::condition_variable m_BatchDone;
+    Batch m_Batch;
+    std::uint64_t m_BatchGeneration = 0;
+    std::size_t m_ActiveWorkers = 0;
+    bool m_Stopping = false;
+};
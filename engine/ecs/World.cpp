@@ -8,6 +8,10 @@ Entity World::CreateEntity()
 {
     std::uint32_t index = Entity::InvalidIndex;
 
+    // CreateEntityAt may have revived a free index; its entry is skipped here.
+    while (!m_FreeIndices.empty() && m_Slots[m_FreeIndices.back()].alive)
+        m_FreeIndices.pop_back();
+
     if (!m_FreeIndices.empty())
     {
         index = m_FreeIndices.back();
@@ -25,6 +29,28 @@ Entity World::CreateEntity()
     return Entity{ index, m_Slots[index].generation };
 }
 
+bool World::CreateEntityAt(Entity entity)
+{
+    if (!entity.IsValid())
+        return false;
+
+    if (entity.index >= m_Slots.size())
+    {
+        for (auto index = static_cast<std::uint32_t>(m_Slots.size()); index < entity.index; ++index)
+            m_FreeIndices.push_back(index);
+        m_Slots.resize(static_cast<std::size_t>(entity.index) + 1);
+    }
+
+    EntitySlot& slot = m_Slots[entity.index];
+    if (slot.alive)
+        return false;
+
+    slot.alive = true;
+    slot.generation = entity.generation;
+    ++m_AliveCount;
+    return true;
+}
+
 bool World::DestroyEntity(Entity entity)
 {
     if (!IsAlive(entity))
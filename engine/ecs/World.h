@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Entity.h"
+#include "../core/AllocationTracker.h"
 #include "systems/SystemPipeline.h"
 
 #include <cstddef>
@@ -20,6 +21,9 @@ class World
 {
 public:
     Entity CreateEntity();
+    // Creates the entity with exactly this handle, e.g. to mirror an entity of another world.
+    // Returns false when the slot is already alive.
+    bool CreateEntityAt(Entity entity);
     bool DestroyEntity(Entity entity);
 
     template <typename T, typename... Args>
@@ -50,6 +54,12 @@ public:
         return m_Systems.AddSystem<TSystem>(std::forward<Args>(args)...);
     }
 
+    template <typename TSystem>
+    TSystem& AddSystem(std::unique_ptr<TSystem> system)
+    {
+        return m_Systems.AddSystem(std::move(system));
+    }
+
     void UpdateSystems(float dt)
     {
         m_Systems.Update(*this, dt);
@@ -127,7 +137,8 @@ private:
         }
 
     private:
-        std::unordered_map<std::uint32_t, T> m_Components;
+        using Allocator = TaggedAllocator<std::pair<const std::uint32_t, T>, AllocationTag::ECS>;
+        std::unordered_map<std::uint32_t, T, std::hash<std::uint32_t>, std::equal_to<std::uint32_t>, Allocator> m_Components;
     };
 
     template <typename T>
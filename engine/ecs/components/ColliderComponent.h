@@ -1,3 +1,31 @@
 #pragma once
 #include "../MathTypes.h"
-namespace ecs { enum class ColliderType { Box, Sphere }; struct ColliderComponent { ColliderType type = ColliderType::Box; Vec3 halfExtents{0.5f,0.5f,0.5f}; Vec3 offset{}; float restitution = 0.05f; float friction = 0.85f; bool autoFitFromMesh = true; }; }
+#include <cstdint>
+#include <memory>
+namespace physics { struct MeshShape; }
+namespace ecs
+{
+// Mesh colliders take their shape from the mesh renderer's mesh. TriangleMesh collides with the
+// mesh triangles while the body is static and with their convex hull otherwise; ConvexHull
+// always uses the hull.
+enum class ColliderType { Box, Sphere, TriangleMesh, ConvexHull };
+struct ColliderComponent
+{
+    ColliderType type = ColliderType::Box;
+    Vec3 halfExtents{0.5f,0.5f,0.5f};
+    Vec3 offset{};
+    float restitution = 0.05f;
+    float friction = 0.85f;
+    bool autoFitFromMesh = true;
+    // Collision layer bits; a pair collides only when each collider's layer is in the other's
+    // mask. Queries filter on layer as well.
+    std::uint32_t layer = 1u;
+    std::uint32_t mask = 0xFFFFFFFFu;
+    // Baked collision geometry of mesh colliders, in mesh space; the transform scales and rotates it.
+    std::shared_ptr<const physics::MeshShape> meshShape;
+};
+inline bool IsMeshCollider(ColliderType type)
+{
+    return type == ColliderType::TriangleMesh || type == ColliderType::ConvexHull;
+}
+}
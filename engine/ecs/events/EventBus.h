@@ -1,5 +1,38 @@
 #pragma once
 #include "../Entity.h"
+#include <cstdint>
 #include <functional>
+#include <span>
 #include <vector>
-namespace ecs { struct CollisionEvent { Entity a{}; Entity b{}; }; class EventBus { public: using CollisionListener = std::function<void(const CollisionEvent&)>; void SubscribeCollision(CollisionListener listener){ m_CollisionListeners.push_back(std::move(listener)); } void PublishCollision(const CollisionEvent& event) const { for (const auto& listener : m_CollisionListeners) listener(event);} private: std::vector<CollisionListener> m_CollisionListeners; }; }
+namespace ecs
+{
+enum class ContactEventState : std::uint8_t
+{
+    Begin,
+    Stay,
+    End
+};
+
+// One per touching pair and physics update; a is the entity with the lower index.
+struct ContactEvent
+{
+    Entity a{};
+    Entity b{};
+    ContactEventState state = ContactEventState::Begin;
+};
+
+class EventBus
+{
+public:
+    // Receives all contact events of one physics update at once, sorted by entity pair.
+    using ContactListener = std::function<void(std::span<const ContactEvent>)>;
+    void SubscribeContacts(ContactListener listener) { m_ContactListeners.push_back(std::move(listener)); }
+    void PublishContacts(std::span<const ContactEvent> events) const
+    {
+        for (const auto& listener : m_ContactListeners)
+            listener(events);
+    }
+private:
+    std::vector<ContactListener> m_ContactListeners;
+};
+}
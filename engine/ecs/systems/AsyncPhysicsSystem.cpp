@@ -0,0 +1,390 @@
+#include "AsyncPhysicsSystem.h"
+#include "../../core/FrameArena.h"
+#include "../../core/Logger.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+using ecs::Vec3;
+
+bool SameVec3(const Vec3& a, const Vec3& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+bool SameTransform(const ecs::TransformComponent& a, const ecs::TransformComponent& b)
+{
+    return SameVec3(a.position, b.position) && SameVec3(a.rotation, b.rotation) && SameVec3(a.scale, b.scale);
+}
+
+bool SameRigidbody(const ecs::RigidbodyComponent& a, const ecs::RigidbodyComponent& b)
+{
+    return SameVec3(a.velocity, b.velocity) &&
+        SameVec3(a.acceleration, b.acceleration) &&
+        a.mass == b.mass &&
+        a.useGravity == b.useGravity &&
+        a.isStatic == b.isStatic &&
+        a.simulatePhysics == b.simulatePhysics &&
+        a.linearDampingMultiplier == b.linearDampingMultiplier &&
+        a.useAdvancedSphereStabilization == b.useAdvancedSphereStabilization &&
+        a.isSleeping == b.isSleeping &&
+        a.continuousCollision == b.continuousCollision;
+}
+
+bool SameCollider(const ecs::ColliderComponent& a, const ecs::ColliderComponent& b)
+{
+    return a.type == b.type &&
+        SameVec3(a.halfExtents, b.halfExtents) &&
+        SameVec3(a.offset, b.offset) &&
+        a.restitution == b.restitution &&
+        a.friction == b.friction &&
+        a.autoFitFromMesh == b.autoFitFromMesh &&
+        a.layer == b.layer &&
+        a.mask == b.mask &&
+        a.meshShape == b.meshShape;
+}
+
+template <typename T>
+void Assign(ecs::World& world, ecs::Entity entity, const T& value)
+{
+    if (T* component = world.GetComponent<T>(entity))
+        *component = value;
+    else
+        world.AddComponent<T>(entity, value);
+}
+}
+
+namespace ecs {
+AsyncPhysicsSystem::AsyncPhysicsSystem(std::unique_ptr<PhysicsSystem> physics, EventBus* eventBus, float tickRate)
+    : m_Physics(std::move(physics))
+    , m_EventBus(eventBus)
+    , m_TickDt(1.0f / (tickRate > 0.0f ? tickRate : 60.0f))
+{
+    m_Front.publishTime = Clock::now();
+    m_Thread = std::thread([this] { Run(); });
+    Logger::Get().Info("AsyncPhysicsSystem: ticking at " + std::to_string(static_cast<int>(GetTickRate() + 0.5f)) + " Hz on its own thread");
+}
+
+AsyncPhysicsSystem::~AsyncPhysicsSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Stop = true;
+    }
+    m_Wake.notify_one();
+    if (m_Thread.joinable())
+        m_Thread.join();
+}
+
+void AsyncPhysicsSystem::Update(World& world, float dt)
+{
+    (void)dt;
+    QueueChanges(world);
+    WriteBack(world);
+
+    if (m_EventBus == nullptr)
+        return;
+    // One publish per tick, as the inline system would have made them.
+    std::size_t offset = 0;
+    for (const std::size_t count : m_EventCounts)
+    {
+        m_EventBus->PublishContacts(std::span<const ContactEvent>(m_Events.data() + offset, count));
+        offset += count;
+    }
+}
+
+std::uint64_t AsyncPhysicsSystem::GetTickCount() const
+{
+    std::lock_guard<std::mutex> lock(m_OutputMutex);
+    return m_Front.tick;
+}
+
+PhysicsStepStats AsyncPhysicsSystem::GetStepStats() const
+{
+    std::lock_guard<std::mutex> lock(m_OutputMutex);
+    return m_Front.stats;
+}
+
+const AsyncPhysicsSystem::RenderTicks* AsyncPhysicsSystem::FindRenderTicks(Entity entity) const
+{
+    const auto it = m_RenderTicks.find(entity);
+    return it != m_RenderTicks.end() ? &it->second : nullptr;
+}
+
+float AsyncPhysicsSystem::GetRenderAlpha() const
+{
+    const float sincePublish = std::chrono::duration<float>(Clock::now() - m_RenderPublishTime).count();
+    return std::clamp(sincePublish / m_TickDt, 0.0f, 1.0f);
+}
+
+void AsyncPhysicsSystem::ApplyImpulse(Entity entity, const Vec3& impulse)
+{
+    BodyCommand command;
+    command.type = BodyCommand::Type::Impulse;
+    command.entity = entity;
+    command.impulse = impulse;
+    m_Impulses.push_back(command);
+}
+
+void AsyncPhysicsSystem::SetLodFocus(const Vec3& focus)
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_LodFocus = focus;
+}
+
+void AsyncPhysicsSystem::CaptureSnapshot(World& world, std::vector<std::uint8_t>& outBlob)
+{
+    QueueChanges(world);
+    std::lock_guard<std::mutex> lock(m_StepMutex);
+    ApplyCommands();
+    m_Physics->CaptureSnapshot(m_Mirror, outBlob);
+}
+
+bool AsyncPhysicsSystem::RestoreSnapshot(World& world, std::span<const std::uint8_t> blob)
+{
+    std::lock_guard<std::mutex> lock(m_StepMutex);
+    ApplyCommands();
+    if (!m_Physics->RestoreSnapshot(m_Mirror, blob))
+        return false;
+
+    // Publish the restored state as a tick of its own, so older results are not written back.
+    BeginOutput();
+    FinishOutput();
+    Publish(false);
+    m_Mirror.ForEach<TransformComponent, RigidbodyComponent>([&](Entity entity, TransformComponent& restoredTransform, RigidbodyComponent& restoredBody)
+    {
+        auto* transform = world.GetComponent<TransformComponent>(entity);
+        auto* rigidbody = world.GetComponent<RigidbodyComponent>(entity);
+        const auto tracked = m_Tracked.find(entity);
+        if (transform == nullptr || rigidbody == nullptr || tracked == m_Tracked.end())
+            return;
+        transform->position = restoredTransform.position;
+        transform->rotation = restoredTransform.rotation;
+        rigidbody->velocity = restoredBody.velocity;
+        rigidbody->isSleeping = restoredBody.isSleeping;
+        tracked->second.transform = *transform;
+        tracked->second.rigidbody = *rigidbody;
+        m_RenderTicks.erase(entity);
+    });
+    return true;
+}
+
+void AsyncPhysicsSystem::Run()
+{
+    // Main-thread frame ends must not reset this thread's arena in the middle of a tick.
+    FrameArena::ExcludeThisThreadFromResetAll();
+    const auto tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(m_TickDt));
+    auto next = Clock::now() + tick;
+    std::unique_lock<std::mutex> wakeLock(m_WakeMutex);
+    while (!m_Stop)
+    {
+        if (m_Wake.wait_until(wakeLock, next, [this] { return m_Stop; }))
+            break;
+        wakeLock.unlock();
+        Tick();
+        wakeLock.lock();
+
+        next += tick;
+        const auto now = Clock::now();
+        if (now - next > tick * kMaxCatchUpTicks)
+            next = now;
+    }
+}
+
+void AsyncPhysicsSystem::Tick()
+{
+    std::lock_guard<std::mutex> lock(m_StepMutex);
+    ApplyCommands();
+    m_Physics->SetEnabled(m_Enabled);
+    BeginOutput();
+    m_Physics->Update(m_Mirror, m_TickDt);
+    FinishOutput();
+    Publish(true);
+    FrameArena::ForThisThread().Reset();
+}
+
+void AsyncPhysicsSystem::ApplyCommands()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Commands.swap(m_Queue);
+        m_AppliedBatch = m_QueuedBatch;
+        m_Physics->SetLodFocus(m_LodFocus);
+    }
+
+    for (const BodyCommand& command : m_Commands)
+    {
+        const Entity entity = command.entity;
+        switch (command.type)
+        {
+        case BodyCommand::Type::Destroy:
+            m_Mirror.DestroyEntity(entity);
+            break;
+        case BodyCommand::Type::Set:
+            if (!m_Mirror.IsAlive(entity) && !m_Mirror.CreateEntityAt(entity))
+                break;
+            if (command.setTransform)
+                Assign(m_Mirror, entity, command.transform);
+            if (command.setRigidbody)
+                Assign(m_Mirror, entity, command.rigidbody);
+            if (command.setCollider && command.hasCollider)
+                Assign(m_Mirror, entity, command.collider);
+            else if (command.setCollider)
+                m_Mirror.RemoveComponent<ColliderComponent>(entity);
+            break;
+        case BodyCommand::Type::Impulse:
+            if (auto* rigidbody = m_Mirror.GetComponent<RigidbodyComponent>(entity); rigidbody != nullptr && !rigidbody->isStatic && rigidbody->mass > 0.0f)
+            {
+                const float inverseMass = 1.0f / rigidbody->mass;
+                rigidbody->velocity.x += command.impulse.x * inverseMass;
+                rigidbody->velocity.y += command.impulse.y * inverseMass;
+                rigidbody->velocity.z += command.impulse.z * inverseMass;
+            }
+            break;
+        }
+    }
+    m_Commands.clear();
+}
+
+void AsyncPhysicsSystem::BeginOutput()
+{
+    m_Back.bodies.clear();
+    m_OutputSources.clear();
+    // The step adds and removes no components, so these pointers stay valid until FinishOutput.
+    m_Mirror.ForEach<TransformComponent, RigidbodyComponent>([&](Entity entity, TransformComponent& transform, RigidbodyComponent& rigidbody)
+    {
+        if (rigidbody.isStatic || !rigidbody.simulatePhysics)
+            return;
+        BodyState state;
+        state.entity = entity;
+        state.previousPosition = transform.position;
+        m_Back.bodies.push_back(state);
+        m_OutputSources.emplace_back(&transform, &rigidbody);
+    });
+}
+
+void AsyncPhysicsSystem::FinishOutput()
+{
+    for (std::size_t i = 0; i < m_Back.bodies.size(); ++i)
+    {
+        BodyState& state = m_Back.bodies[i];
+        const auto [transform, rigidbody] = m_OutputSources[i];
+        state.position = transform->position;
+        state.rotation = transform->rotation;
+        state.velocity = rigidbody->velocity;
+        state.isSleeping = rigidbody->isSleeping;
+    }
+}
+
+void AsyncPhysicsSystem::Publish(bool stepped)
+{
+    m_Back.appliedBatch = m_AppliedBatch;
+    m_Back.stats = m_Physics->GetStepStats();
+    m_Back.publishTime = Clock::now();
+
+    std::lock_guard<std::mutex> lock(m_OutputMutex);
+    m_Back.tick = m_Front.tick + (stepped ? 1 : 0);
+    std::swap(m_Back, m_Front);
+    const std::span<const ContactEvent> events = m_Physics->GetContactEvents();
+    if (stepped && !events.empty())
+    {
+        m_PendingEvents.insert(m_PendingEvents.end(), events.begin(), events.end());
+        m_PendingEventCounts.push_back(events.size());
+    }
+}
+
+void AsyncPhysicsSystem::QueueChanges(World& world)
+{
+    ++m_UpdateCount;
+    const std::uint64_t batch = m_SubmittedBatch + 1;
+    world.ForEach<TransformComponent, RigidbodyComponent>([&](Entity entity, TransformComponent& transform, RigidbodyComponent& rigidbody)
+    {
+        const ColliderComponent* collider = world.GetComponent<ColliderComponent>(entity);
+        const auto [it, inserted] = m_Tracked.try_emplace(entity);
+        TrackedBody& tracked = it->second;
+        tracked.seenUpdate = m_UpdateCount;
+
+        BodyCommand command;
+        command.entity = entity;
+        command.setTransform = inserted || !SameTransform(tracked.transform, transform);
+        command.setRigidbody = inserted || !SameRigidbody(tracked.rigidbody, rigidbody);
+        command.setCollider = inserted ||
+            tracked.hasCollider != (collider != nullptr) ||
+            (collider != nullptr && !SameCollider(tracked.collider, *collider));
+        if (!command.setTransform && !command.setRigidbody && !command.setCollider)
+            return;
+
+        tracked.transform = transform;
+        tracked.rigidbody = rigidbody;
+        tracked.hasCollider = collider != nullptr;
+        tracked.collider = collider != nullptr ? *collider : ColliderComponent{};
+        tracked.editBatch = batch;
+        command.transform = transform;
+        command.rigidbody = rigidbody;
+        command.collider = tracked.collider;
+        command.hasCollider = tracked.hasCollider;
+        m_Changes.push_back(std::move(command));
+    });
+
+    // Bodies destroyed or stripped of their rigidbody leave the mirror; destroys go first, so a
+    // recycled entity index is free again when its new entity is created.
+    for (auto it = m_Tracked.begin(); it != m_Tracked.end();)
+    {
+        if (it->second.seenUpdate == m_UpdateCount)
+        {
+            ++it;
+            continue;
+        }
+        BodyCommand command;
+        command.type = BodyCommand::Type::Destroy;
+        command.entity = it->first;
+        m_Destroys.push_back(command);
+        it = m_Tracked.erase(it);
+    }
+
+    if (m_Destroys.empty() && m_Changes.empty() && m_Impulses.empty())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Queue.insert(m_Queue.end(), m_Destroys.begin(), m_Destroys.end());
+        m_Queue.insert(m_Queue.end(), m_Changes.begin(), m_Changes.end());
+        m_Queue.insert(m_Queue.end(), m_Impulses.begin(), m_Impulses.end());
+        m_QueuedBatch = batch;
+    }
+    m_SubmittedBatch = batch;
+    m_Destroys.clear();
+    m_Changes.clear();
+    m_Impulses.clear();
+}
+
+void AsyncPhysicsSystem::WriteBack(World& world)
+{
+    m_Events.clear();
+    m_EventCounts.clear();
+    std::lock_guard<std::mutex> lock(m_OutputMutex);
+    m_Events.swap(m_PendingEvents);
+    m_EventCounts.swap(m_PendingEventCounts);
+
+    // Components get the latest tick as is; only drawing blends towards it, so gameplay, edit
+    // checks and snapshots never see positions between ticks.
+    m_RenderTicks.clear();
+    m_RenderPublishTime = m_Front.publishTime;
+    for (const BodyState& state : m_Front.bodies)
+    {
+        const auto tracked = m_Tracked.find(state.entity);
+        if (tracked == m_Tracked.end() || tracked->second.editBatch > m_Front.appliedBatch)
+            continue;
+        auto* transform = world.GetComponent<TransformComponent>(state.entity);
+        auto* rigidbody = world.GetComponent<RigidbodyComponent>(state.entity);
+        if (transform == nullptr || rigidbody == nullptr)
+            continue;
+        transform->position = state.position;
+        transform->rotation = state.rotation;
+        rigidbody->velocity = state.velocity;
+        rigidbody->isSleeping = state.isSleeping;
+        tracked->second.transform = *transform;
+        tracked->second.rigidbody = *rigidbody;
+        m_RenderTicks[state.entity] = RenderTicks{ state.previousPosition, state.position };
+    }
+}
+}
@@ -0,0 +1,178 @@
+#pragma once
+#include "ISystem.h"
+#include "PhysicsSystem.h"
+#include "../World.h"
+#include "../components/ColliderComponent.h"
+#include "../components/RigidbodyComponent.h"
+#include "../components/TransformComponent.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+namespace ecs {
+// Runs a PhysicsSystem on its own thread at a fixed tick, against a private world that mirrors
+// the rigidbodies of the world it is updated with under the same entity handles. Update queues
+// what changed in that world since the last update (created and destroyed bodies, edited
+// transforms, velocities and colliders) as commands for the next tick, then writes the latest
+// tick back exactly: positions, rotations, velocities and sleep state. The last two ticks'
+// positions stay available for RenderSystem to interpolate between. Contact events of every
+// finished tick are published on the updating thread.
+class AsyncPhysicsSystem final : public ISystem {
+public:
+    // Positions of a written-back body in the two most recently published ticks.
+    struct RenderTicks
+    {
+        Vec3 previous{};
+        Vec3 latest{};
+    };
+
+    AsyncPhysicsSystem(std::unique_ptr<PhysicsSystem> physics, EventBus* eventBus, float tickRate = 60.0f);
+    ~AsyncPhysicsSystem() override;
+    AsyncPhysicsSystem(const AsyncPhysicsSystem&) = delete;
+    AsyncPhysicsSystem& operator=(const AsyncPhysicsSystem&) = delete;
+    const char* Name() const override { return "AsyncPhysicsSystem"; }
+    void Update(World& world, float dt) override;
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    bool IsEnabled() const { return m_Enabled; }
+    float GetTickRate() const { return 1.0f / m_TickDt; }
+    // Ticks published so far.
+    std::uint64_t GetTickCount() const;
+    // Of the last published tick.
+    PhysicsStepStats GetStepStats() const;
+    // Adds impulse / mass to the body's velocity at the next tick, after any edit queued by the
+    // same update, so gameplay pushes add up with the simulated velocity instead of replacing it.
+    void ApplyImpulse(Entity entity, const Vec3& impulse);
+    // Taken by the next tick, see PhysicsSystem::SetLodFocus.
+    void SetLodFocus(const Vec3& focus);
+    // Runs func(const PhysicsSystem&) between two ticks, e.g. for GetQuery(); entities in the
+    // results are those of the updated world.
+    template <typename Func>
+    decltype(auto) WithPhysics(Func&& func) const
+    {
+        std::lock_guard<std::mutex> lock(m_StepMutex);
+        return func(static_cast<const PhysicsSystem&>(*m_Physics));
+    }
+    // Updating thread only. Null for bodies the last update did not write back.
+    const RenderTicks* FindRenderTicks(Entity entity) const;
+    // How far the time since the written-back tick has advanced towards the next one, in [0, 1].
+    float GetRenderAlpha() const;
+    // Same blobs as PhysicsSystem. Capture includes edits made to world since the last update;
+    // restore also writes the restored bodies back into world right away.
+    void CaptureSnapshot(World& world, std::vector<std::uint8_t>& outBlob);
+    bool RestoreSnapshot(World& world, std::span<const std::uint8_t> blob);
+private:
+    using Clock = std::chrono::steady_clock;
+    // Ticks missed beyond this (a stall, a breakpoint) are dropped instead of run back to back.
+    static constexpr int kMaxCatchUpTicks = 4;
+
+    struct BodyCommand
+    {
+        enum class Type : std::uint8_t { Set, Destroy, Impulse };
+        Type type = Type::Set;
+        Entity entity{};
+        // Set only replaces the parts that changed, so a velocity edit does not move the body
+        // back to where an older tick left it.
+        bool setTransform = false;
+        bool setRigidbody = false;
+        bool setCollider = false;
+        TransformComponent transform{};
+        RigidbodyComponent rigidbody{};
+        ColliderComponent collider{};
+        bool hasCollider = false;
+        Vec3 impulse{};
+    };
+
+    // A simulated body as a tick left it.
+    struct BodyState
+    {
+        Entity entity{};
+        Vec3 previousPosition{};
+        Vec3 position{};
+        Vec3 rotation{};
+        Vec3 velocity{};
+        bool isSleeping = false;
+    };
+
+    struct TickOutput
+    {
+        std::uint64_t tick = 0;
+        // Commands of batches up to this one are part of the tick.
+        std::uint64_t appliedBatch = 0;
+        Clock::time_point publishTime{};
+        std::vector<BodyState> bodies;
+        PhysicsStepStats stats;
+    };
+
+    // A body as the updated world held it after the last update, to tell edits from results.
+    struct TrackedBody
+    {
+        TransformComponent transform{};
+        RigidbodyComponent rigidbody{};
+        ColliderComponent collider{};
+        bool hasCollider = false;
+        // Results stay unwritten until the tick that applied the last edit.
+        std::uint64_t editBatch = 0;
+        std::uint64_t seenUpdate = 0;
+    };
+
+    void Run();
+    void Tick();
+    void ApplyCommands();
+    // Output bodies are recorded before a step and completed after it.
+    void BeginOutput();
+    void FinishOutput();
+    void Publish(bool stepped);
+    void QueueChanges(World& world);
+    void WriteBack(World& world);
+
+    std::unique_ptr<PhysicsSystem> m_Physics;
+    EventBus* m_EventBus = nullptr;
+    float m_TickDt = 1.0f / 60.0f;
+    std::atomic<bool> m_Enabled{ true };
+
+    // Physics thread only, or under m_StepMutex.
+    World m_Mirror;
+    std::vector<BodyCommand> m_Commands;
+    std::uint64_t m_AppliedBatch = 0;
+    TickOutput m_Back;
+    std::vector<std::pair<const TransformComponent*, const RigidbodyComponent*>> m_OutputSources;
+    mutable std::mutex m_StepMutex;
+
+    // Filled by Update, taken by the next tick.
+    std::mutex m_QueueMutex;
+    std::vector<BodyCommand> m_Queue;
+    std::uint64_t m_QueuedBatch = 0;
+    Vec3 m_LodFocus{};
+
+    // Latest tick and the contact events of all ticks since the last update, one span per tick.
+    mutable std::mutex m_OutputMutex;
+    TickOutput m_Front;
+    std::vector<ContactEvent> m_PendingEvents;
+    std::vector<std::size_t> m_PendingEventCounts;
+
+    // Updating thread only.
+    std::unordered_map<Entity, TrackedBody, EntityHash> m_Tracked;
+    std::vector<BodyCommand> m_Destroys;
+    std::vector<BodyCommand> m_Changes;
+    std::vector<BodyCommand> m_Impulses;
+    std::vector<ContactEvent> m_Events;
+    std::vector<std::size_t> m_EventCounts;
+    std::unordered_map<Entity, RenderTicks, EntityHash> m_RenderTicks;
+    Clock::time_point m_RenderPublishTime{};
+    std::uint64_t m_UpdateCount = 0;
+    std::uint64_t m_SubmittedBatch = 0;
+
+    std::mutex m_WakeMutex;
+    std::condition_variable m_Wake;
+    bool m_Stop = false;
+    std::thread m_Thread;
+};
+}
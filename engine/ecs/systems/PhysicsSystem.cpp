@@ -3,11 +3,22 @@
 #include "../components/ColliderComponent.h"
 #include "../components/RigidbodyComponent.h"
 #include "../components/TransformComponent.h"
+#include "../../core/AllocationTracker.h"
+#include "../../core/FrameArena.h"
+#include "../../core/JobSystem.h"
+#include "../../physics/ConvexContact.h"
+#include "../../physics/MeshShape.h"
+#include "../../physics/NarrowphaseKernels.h"
+#include "../../physics/TimeOfImpact.h"
 #include <algorithm>
+#include <bit>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
-#include <unordered_map>
-#include <unordered_set>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -34,582 +45,1883 @@ static Vec3 NormalizeSafe(const Vec3& v)
     const float inv = 1.0f / len;
     return Scale(v, inv);
 }
-static float SphereRadius(const ecs::ColliderComponent& c)
+static float SphereRadius(const Vec3& halfExtents)
 {
-    return std::max(c.halfExtents.x, std::max(c.halfExtents.y, c.halfExtents.z));
+    return std::max(halfExtents.x, std::max(halfExtents.y, halfExtents.z));
 }
-static float BoundingRadius(const ecs::ColliderComponent& c)
+using physics::BoxAxes;
+using physics::BuildBoxAxes;
+static const Vec3& AxisAt(const BoxAxes& axes, std::uint32_t index)
 {
-    if (c.type == ecs::ColliderType::Sphere)
-        return SphereRadius(c);
-    return std::sqrt(c.halfExtents.x * c.halfExtents.x +
-                     c.halfExtents.y * c.halfExtents.y +
-                     c.halfExtents.z * c.halfExtents.z);
+    return index == 0 ? axes.xAxis : (index == 1 ? axes.yAxis : axes.zAxis);
 }
-static int CellCoord(float v, float cellSize)
+// World AABB half extents of a rotated box: the row sums of |R| * half.
+static Vec3 RotatedAabbHalfExtents(const Vec3& localHalf, const BoxAxes& axes)
 {
-    return static_cast<int>(std::floor(v / cellSize));
+    return Vec3{
+        Abs(axes.xAxis.x) * localHalf.x + Abs(axes.yAxis.x) * localHalf.y + Abs(axes.zAxis.x) * localHalf.z,
+        Abs(axes.xAxis.y) * localHalf.x + Abs(axes.yAxis.y) * localHalf.y + Abs(axes.zAxis.y) * localHalf.z,
+        Abs(axes.xAxis.z) * localHalf.x + Abs(axes.yAxis.z) * localHalf.y + Abs(axes.zAxis.z) * localHalf.z
+    };
+}
+static float ProjectedObbRadius(const Vec3& half, const BoxAxes& axes, const Vec3& axis)
+{
+    return Abs(Dot(axis, axes.xAxis)) * half.x +
+           Abs(Dot(axis, axes.yAxis)) * half.y +
+           Abs(Dot(axis, axes.zAxis)) * half.z;
 }
-static std::uint64_t CellKey(int x, int y, int z)
+
+constexpr char kSnapshotMagic[4] = { 'W', 'P', 'H', 'S' };
+constexpr std::uint32_t kSnapshotVersion = 2;
+
+struct SnapshotHeader
+{
+    char magic[4]{};
+    std::uint32_t version = 0;
+    std::uint32_t bodyCount = 0;
+    std::uint32_t slotCount = 0;
+    std::uint32_t cacheCount = 0;
+    std::uint32_t pairCount = 0;
+    std::uint32_t nextSleepIsland = 1;
+    std::uint32_t reserved = 0;
+    std::uint64_t sleepingBodyCount = 0;
+    std::uint64_t awakeIslandCount = 0;
+    std::uint64_t lodFrame = 0;
+};
+
+struct SnapshotBody
+{
+    ecs::Entity entity{};
+    Vec3 position{};
+    Vec3 rotation{};
+    Vec3 velocity{};
+    std::uint32_t sleeping = 0;
+};
+
+// Per-entity bookkeeping of a collider that owned a proxy at capture time.
+struct SnapshotSlot
+{
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+    std::uint32_t sleepIsland = 0;
+    float sleepTimer = 0.0f;
+    std::uint32_t lodLevel = 0;
+    float lodPendingTime = 0.0f;
+    Vec3 position{};
+    Vec3 rotation{};
+    Vec3 halfExtents{};
+    Vec3 offset{};
+};
+
+template <typename T>
+void AppendBlob(std::vector<std::uint8_t>& blob, const T* values, std::size_t count)
 {
-    const std::uint64_t ux = static_cast<std::uint32_t>(x) & 0x1fffffu;
-    const std::uint64_t uy = static_cast<std::uint32_t>(y) & 0x1fffffu;
-    const std::uint64_t uz = static_cast<std::uint32_t>(z) & 0x1fffffu;
-    return (ux << 42) | (uy << 21) | uz;
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(values);
+    blob.insert(blob.end(), bytes, bytes + sizeof(T) * count);
 }
-static std::uint64_t PairKey(std::size_t a, std::size_t b)
+
+// Copies count values out of the blob at offset; the blob need not be aligned for T.
+template <typename T>
+bool ReadBlob(std::span<const std::uint8_t> blob, std::size_t& offset, T* outValues, std::size_t count)
 {
-    const std::uint64_t lo = static_cast<std::uint64_t>(std::min(a, b));
-    const std::uint64_t hi = static_cast<std::uint64_t>(std::max(a, b));
-    return (hi << 32) ^ lo;
+    static_assert(std::is_trivially_copyable_v<T>);
+    const std::size_t size = sizeof(T) * count;
+    if (blob.size() - offset < size)
+        return false;
+    if (size > 0)
+        std::memcpy(outValues, blob.data() + offset, size);
+    offset += size;
+    return true;
 }
-static Vec3 RotatedAabbHalfExtents(const Vec3& localHalf, const Vec3& rot)
+
+bool SameVec3(const Vec3& a, const Vec3& b)
 {
-    const float cx = std::cos(rot.x), sx = std::sin(rot.x);
-    const float cy = std::cos(rot.y), sy = std::sin(rot.y);
-    const float cz = std::cos(rot.z), sz = std::sin(rot.z);
-    const float r00 = cz * cy;
-    const float r01 = cz * sy * sx - sz * cx;
-    const float r02 = cz * sy * cx + sz * sx;
-    const float r10 = sz * cy;
-    const float r11 = sz * sy * sx + cz * cx;
-    const float r12 = sz * sy * cx - cz * sx;
-    const float r20 = -sy;
-    const float r21 = cy * sx;
-    const float r22 = cy * cx;
-    return Vec3{
-        Abs(r00) * localHalf.x + Abs(r01) * localHalf.y + Abs(r02) * localHalf.z,
-        Abs(r10) * localHalf.x + Abs(r11) * localHalf.y + Abs(r12) * localHalf.z,
-        Abs(r20) * localHalf.x + Abs(r21) * localHalf.y + Abs(r22) * localHalf.z
-    };
+    return a.x == b.x && a.y == b.y && a.z == b.z;
 }
-struct BoxAxes
+
+enum BodyFlags : std::uint16_t
 {
-    Vec3 xAxis;
-    Vec3 yAxis;
-    Vec3 zAxis;
+    kBodyStatic = 1 << 0,
+    kBodySimulated = 1 << 1,
+    kBodySleeping = 1 << 2,
+    kBodyGravity = 1 << 3,
+    kBodySphere = 1 << 4,
+    kBodyContinuous = 1 << 5,
+    kBodySphereStabilization = 1 << 6,
+    kBodyHasMass = 1 << 7,
+    kBodyHull = 1 << 8,
+    kBodyTriangleMesh = 1 << 9,
+    // Held by distance LOD for this update: not stepped, like a sleeping body.
+    kBodyFrozen = 1 << 10
 };
-static BoxAxes BuildBoxAxes(const Vec3& rot)
-{
-    const float cx = std::cos(rot.x), sx = std::sin(rot.x);
-    const float cy = std::cos(rot.y), sy = std::sin(rot.y);
-    const float cz = std::cos(rot.z), sz = std::sin(rot.z);
-    const float r00 = cz * cy;
-    const float r01 = cz * sy * sx - sz * cx;
-    const float r02 = cz * sy * cx + sz * sx;
-    const float r10 = sz * cy;
-    const float r11 = sz * sy * sx + cz * cx;
-    const float r12 = sz * sy * cx - cz * sx;
-    const float r20 = -sy;
-    const float r21 = cy * sx;
-    const float r22 = cy * cx;
-    return BoxAxes{
-        Vec3{ r00, r10, r20 },
-        Vec3{ r01, r11, r21 },
-        Vec3{ r02, r12, r22 }
-    };
+
+// Simulated, non-static and awake: the only bodies that integrate and drive contact solving.
+bool IsAwakeDynamic(std::uint16_t flags)
+{
+    return (flags & kBodySimulated) != 0 && (flags & (kBodyStatic | kBodySleeping | kBodyFrozen)) == 0;
 }
-static float ProjectedObbRadius(const Vec3& half, const BoxAxes& axes, const Vec3& axis)
+
+float InverseMass(const ecs::RigidbodyComponent& rb)
 {
-    return Abs(Dot(axis, axes.xAxis)) * half.x +
-           Abs(Dot(axis, axes.yAxis)) * half.y +
-           Abs(Dot(axis, axes.zAxis)) * half.z;
+    return (rb.isStatic || rb.mass <= 0.0001f) ? 0.0f : (1.0f / rb.mass);
 }
 
-struct BodyRef
+// Hull or triangle mesh of one body, scaled and rotated into world orientation around the body
+// position. Hull vertices and face normals live in BodyArrays; placed triangle meshes are kept
+// by the physics system across updates.
+struct BodyMeshShape
 {
-    ecs::Entity entity{};
-    ecs::TransformComponent* transform = nullptr;
-    ecs::ColliderComponent* collider = nullptr;
-    ecs::RigidbodyComponent* rigidbody = nullptr;
+    const physics::ConvexHull* hull = nullptr;
+    const physics::TriangleMesh* triangles = nullptr;
+    std::uint32_t firstVertex = 0;
+    std::uint32_t firstFace = 0;
 };
 
-enum class ContactType
+// Body state for one update, one packed array per field. Components are read once when the
+// update starts and written back once when it ends; everything in between indexes the arrays.
+struct BodyArrays
 {
-    None,
-    BoxBox,
-    SphereSphere,
-    BoxSphere
+    explicit BodyArrays(std::pmr::memory_resource* resource)
+        : entity(resource), transform(resource), rigidbody(resource), position(resource), rotation(resource)
+        , velocity(resource), acceleration(resource), offset(resource), halfExtents(resource), axes(resource)
+        , faceAxes(resource), invMass(resource), damping(resource), friction(resource), restitution(resource)
+        , layer(resource), mask(resource), flags(resource), meshShape(resource), meshShapes(resource), hullVertices(resource), hullNormals(resource)
+    {}
+
+    std::size_t Size() const { return entity.size(); }
+    bool Has(std::size_t body, std::uint16_t flag) const { return (flags[body] & flag) != 0; }
+    bool HasMeshShape(std::size_t body) const { return Has(body, kBodyHull | kBodyTriangleMesh); }
+    bool IsAwakeDynamic(std::size_t body) const { return ::IsAwakeDynamic(flags[body]); }
+
+    void Reserve(std::size_t count)
+    {
+        entity.reserve(count); transform.reserve(count); rigidbody.reserve(count);
+        position.reserve(count); rotation.reserve(count); velocity.reserve(count);
+        acceleration.reserve(count); offset.reserve(count); halfExtents.reserve(count);
+        axes.reserve(count); faceAxes.reserve(count); invMass.reserve(count);
+        damping.reserve(count); friction.reserve(count); restitution.reserve(count);
+        layer.reserve(count); mask.reserve(count); flags.reserve(count); meshShape.reserve(count);
+    }
+
+    // placedTriangles is the world-oriented mesh of a static triangle-mesh collider, or null.
+    void Append(ecs::Entity e, ecs::TransformComponent& t, const ecs::ColliderComponent& c, ecs::RigidbodyComponent& rb, float dampingPerStep,
+        const physics::TriangleMesh* placedTriangles)
+    {
+        entity.push_back(e);
+        transform.push_back(&t);
+        rigidbody.push_back(&rb);
+        position.push_back(t.position);
+        rotation.push_back(t.rotation);
+        velocity.push_back(rb.velocity);
+        acceleration.push_back(rb.acceleration);
+        offset.push_back(c.offset);
+        halfExtents.push_back(c.halfExtents);
+        // Rotations do not change during the step, so the trig runs once per body and update.
+        axes.push_back(BuildBoxAxes(t.rotation));
+        faceAxes.push_back(physics::NormalizeBoxAxes(axes.back()));
+        invMass.push_back(InverseMass(rb));
+        damping.push_back(std::pow(dampingPerStep, std::max(rb.linearDampingMultiplier, 0.0f)));
+        friction.push_back(c.friction);
+        restitution.push_back(c.restitution);
+        layer.push_back(c.layer);
+        mask.push_back(c.mask);
+        std::uint16_t bits = 0;
+        if (rb.isStatic) bits |= kBodyStatic;
+        if (rb.simulatePhysics) bits |= kBodySimulated;
+        if (rb.isSleeping) bits |= kBodySleeping;
+        if (rb.useGravity) bits |= kBodyGravity;
+        if (c.type == ecs::ColliderType::Sphere) bits |= kBodySphere;
+        if (rb.continuousCollision) bits |= kBodyContinuous;
+        if (rb.useAdvancedSphereStabilization) bits |= kBodySphereStabilization;
+        if (rb.mass > 0.0f) bits |= kBodyHasMass;
+        flags.push_back(bits);
+        meshShape.push_back(0);
+
+        // Mesh colliders without usable geometry stay boxes of their fitted half extents.
+        if (placedTriangles != nullptr)
+            AppendMeshShape(BodyMeshShape{ nullptr, placedTriangles, 0, 0 }, placedTriangles->nodes.front().bounds, kBodyTriangleMesh);
+        else if (ecs::IsMeshCollider(c.type) && c.meshShape != nullptr && c.meshShape->hull.IsValid())
+            AppendHull(c.meshShape->hull, axes.back(), t.scale);
+    }
+
+    // Positions, velocities and sleep state are the only body state the step changes.
+    void WriteBack() const
+    {
+        for (std::size_t i = 0; i < Size(); ++i)
+        {
+            transform[i]->position = position[i];
+            rigidbody[i]->velocity = velocity[i];
+            rigidbody[i]->isSleeping = Has(i, kBodySleeping);
+        }
+    }
+
+    std::pmr::vector<ecs::Entity> entity;
+    std::pmr::vector<ecs::TransformComponent*> transform;
+    std::pmr::vector<ecs::RigidbodyComponent*> rigidbody;
+    std::pmr::vector<Vec3> position;
+    std::pmr::vector<Vec3> rotation;
+    std::pmr::vector<Vec3> velocity;
+    std::pmr::vector<Vec3> acceleration;
+    std::pmr::vector<Vec3> offset;
+    std::pmr::vector<Vec3> halfExtents;
+    // Rotation columns and their normalized copies (the SAT face axes).
+    std::pmr::vector<BoxAxes> axes;
+    std::pmr::vector<BoxAxes> faceAxes;
+    std::pmr::vector<float> invMass;
+    // Velocity damping factor for one substep.
+    std::pmr::vector<float> damping;
+    std::pmr::vector<float> friction;
+    std::pmr::vector<float> restitution;
+    // Collision filter bits, mirrored into the broadphase proxies.
+    std::pmr::vector<std::uint32_t> layer;
+    std::pmr::vector<std::uint32_t> mask;
+    std::pmr::vector<std::uint16_t> flags;
+    // Index into meshShapes for hull and triangle-mesh bodies.
+    std::pmr::vector<std::uint32_t> meshShape;
+    std::pmr::vector<BodyMeshShape> meshShapes;
+    std::pmr::vector<Vec3> hullVertices;
+    std::pmr::vector<Vec3> hullNormals;
+
+private:
+    void AppendHull(const physics::ConvexHull& hull, const BoxAxes& rotation, const Vec3& scale)
+    {
+        const BodyMeshShape shape{ &hull, nullptr, static_cast<std::uint32_t>(hullVertices.size()), static_cast<std::uint32_t>(hullNormals.size()) };
+        physics::Aabb bounds{ Vec3{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() },
+                              Vec3{ -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() } };
+        for (const Vec3& vertex : hull.vertices)
+        {
+            const Vec3 v = physics::ScaleRotate(rotation, scale, vertex);
+            hullVertices.push_back(v);
+            bounds = physics::Union(bounds, physics::Aabb{ v, v });
+        }
+        hullNormals.resize(hullNormals.size() + hull.GetFaceCount());
+        physics::ComputeHullFaceNormals(
+            std::span<const Vec3>(hullVertices.data() + shape.firstVertex, hull.vertices.size()), hull.triangles,
+            hullNormals.data() + shape.firstFace);
+        AppendMeshShape(shape, bounds, kBodyHull);
+    }
+
+    // The shape's bounds relative to the body position become its box: offset and half extents
+    // with identity axes, so broadphase bounds, sweeps and queries keep working on them.
+    void AppendMeshShape(const BodyMeshShape& shape, const physics::Aabb& bounds, std::uint16_t flag)
+    {
+        meshShape.back() = static_cast<std::uint32_t>(meshShapes.size());
+        meshShapes.push_back(shape);
+        flags.back() = static_cast<std::uint16_t>((flags.back() & ~kBodySphere) | flag);
+        offset.back() = Scale(Add(bounds.min, bounds.max), 0.5f);
+        halfExtents.back() = Scale(Sub(bounds.max, bounds.min), 0.5f);
+        const BoxAxes identity{ Vec3{ 1.0f, 0.0f, 0.0f }, Vec3{ 0.0f, 1.0f, 0.0f }, Vec3{ 0.0f, 0.0f, 1.0f } };
+        axes.back() = identity;
+        faceAxes.back() = identity;
+    }
+};
+
+Vec3 ColliderCenter(const BodyArrays& bodies, std::size_t body)
+{
+    return Add(bodies.position[body], bodies.offset[body]);
+}
+
+float BodyRadius(const BodyArrays& bodies, std::size_t body)
+{
+    return SphereRadius(bodies.halfExtents[body]);
+}
+
+physics::SweepShape MakeSweepShape(const BodyArrays& bodies, std::size_t body)
+{
+    physics::SweepShape shape;
+    shape.center = ColliderCenter(bodies, body);
+    shape.isSphere = bodies.Has(body, kBodySphere);
+    shape.radius = BodyRadius(bodies, body);
+    shape.halfExtents = bodies.halfExtents[body];
+    shape.axes = bodies.faceAxes[body];
+    return shape;
+}
+
+physics::Aabb ComputeBodyAabb(const BodyArrays& bodies, std::size_t body)
+{
+    const Vec3 center = ColliderCenter(bodies, body);
+    Vec3 half{};
+    if (bodies.Has(body, kBodySphere))
+    {
+        const float radius = BodyRadius(bodies, body);
+        half = Vec3{ radius, radius, radius };
+    }
+    else
+    {
+        half = RotatedAabbHalfExtents(bodies.halfExtents[body], bodies.axes[body]);
+    }
+    return physics::Aabb{ Sub(center, half), Add(center, half) };
+}
+
+// Gravity, damping and acceleration for one substep.
+Vec3 IntegrateVelocity(Vec3 velocity, const Vec3& acceleration, bool useGravity, float gravity, float damping, float stepDt)
+{
+    if (useGravity) velocity.y -= gravity * stepDt;
+    velocity.x *= damping;
+    velocity.z *= damping;
+    if (Abs(velocity.x) < 0.0005f) velocity.x = 0.0f;
+    if (Abs(velocity.z) < 0.0005f) velocity.z = 0.0f;
+    return Add(velocity, Scale(acceleration, stepDt));
+}
+
+// Below this approach speed contacts do not bounce, so resting bodies do not jitter.
+constexpr float kRestitutionVelocityThreshold = 0.5f;
+
+void ApplyContactImpulse(const physics::ContactManifold& contact, Vec3* velocities, const Vec3& impulse)
+{
+    if (contact.invMassA > 0.0f)
+        velocities[contact.bodyA] = Add(velocities[contact.bodyA], Scale(impulse, contact.invMassA));
+    if (contact.invMassB > 0.0f)
+        velocities[contact.bodyB] = Sub(velocities[contact.bodyB], Scale(impulse, contact.invMassB));
+}
+
+// One sequential-impulse pass: clamp the accumulated normal impulse to push only, then the
+// accumulated friction impulse (a vector in the tangent plane) to the Coulomb cone.
+void SolveContactVelocity(physics::ContactManifold& contact, Vec3* velocities)
+{
+    const float invMassSum = contact.invMassA + contact.invMassB;
+    if (invMassSum <= 0.0f)
+        return;
+    const float effectiveMass = 1.0f / invMassSum;
+
+    const float normalSpeed = Dot(Sub(velocities[contact.bodyA], velocities[contact.bodyB]), contact.normal);
+    const float previousNormal = contact.normalImpulse;
+    contact.normalImpulse = std::max(previousNormal - (normalSpeed - contact.velocityBias) * effectiveMass, 0.0f);
+    ApplyContactImpulse(contact, velocities, Scale(contact.normal, contact.normalImpulse - previousNormal));
+
+    const Vec3 relative = Sub(velocities[contact.bodyA], velocities[contact.bodyB]);
+    const Vec3 tangentVelocity = Sub(relative, Scale(contact.normal, Dot(relative, contact.normal)));
+    const Vec3 previousTangent = contact.tangentImpulse;
+    Vec3 tangent = Sub(previousTangent, Scale(tangentVelocity, effectiveMass));
+    const float maxFriction = contact.friction * contact.normalImpulse;
+    const float tangentLenSq = LengthSq(tangent);
+    if (tangentLenSq > maxFriction * maxFriction)
+        tangent = Scale(tangent, maxFriction / std::sqrt(tangentLenSq));
+    contact.tangentImpulse = tangent;
+    ApplyContactImpulse(contact, velocities, Sub(tangent, previousTangent));
+}
+
+std::uint32_t FindIslandRoot(std::pmr::vector<std::uint32_t>& parent, std::uint32_t index)
+{
+    while (parent[index] != index)
+    {
+        parent[index] = parent[parent[index]];
+        index = parent[index];
+    }
+    return index;
+}
+
+using ecs::ColliderType;
+using physics::ContactType;
+
+// Whether a pair can touch at all: both sides simulated or static, and not both static.
+bool CanCollide(const BodyArrays& bodies, std::size_t a, std::size_t b)
+{
+    if (!bodies.Has(a, kBodySimulated | kBodyStatic) || !bodies.Has(b, kBodySimulated | kBodyStatic))
+        return false;
+    return !(bodies.Has(a, kBodyStatic) && bodies.Has(b, kBodyStatic));
+}
+
+bool FinishContact(const BodyArrays& bodies, std::size_t a, std::size_t b, ContactType type, const Vec3& normal, float depth,
+    const Vec3& point, std::uint32_t featureId, physics::ContactManifold& out)
+{
+    out.type = type;
+    const std::uint32_t entityA = bodies.entity[a].index;
+    const std::uint32_t entityB = bodies.entity[b].index;
+    out.pairKey = physics::MakeContactPairKey(entityA, entityB);
+    // Impulses are stored relative to A; a pair seen in the other order must not reuse them.
+    out.featureId = featureId | (entityA > entityB ? 0x80000000u : 0u);
+    out.normal = normal;
+    out.depth = depth;
+    out.point = point;
+    return depth > 0.0f;
+}
+
+void PackBoxBox(physics::BoxBoxBatch& batch, const BodyArrays& bodies, std::size_t a, std::size_t b)
+{
+    const std::size_t lane = batch.count++;
+    batch.SetVec3(physics::BoxBoxBatch::Delta, lane, Sub(ColliderCenter(bodies, a), ColliderCenter(bodies, b)));
+    batch.SetVec3(physics::BoxBoxBatch::HalfA, lane, bodies.halfExtents[a]);
+    batch.SetVec3(physics::BoxBoxBatch::HalfB, lane, bodies.halfExtents[b]);
+    batch.SetAxes(physics::BoxBoxBatch::AxesA, lane, bodies.axes[a]);
+    batch.SetAxes(physics::BoxBoxBatch::AxesB, lane, bodies.axes[b]);
+    batch.SetAxes(physics::BoxBoxBatch::FaceAxesA, lane, bodies.faceAxes[a]);
+    batch.SetAxes(physics::BoxBoxBatch::FaceAxesB, lane, bodies.faceAxes[b]);
+}
+
+// Turns the SAT result into a contact; the winning axis is rebuilt exactly as the SAT built it.
+bool FinishBoxBox(const BodyArrays& bodies, std::size_t a, std::size_t b, const physics::BoxBoxSat& sat, physics::ContactManifold& out)
+{
+    if (sat.separated)
+        return false;
+    Vec3 normal{ 0.0f, 1.0f, 0.0f };
+    std::uint32_t featureId = 0;
+    if (sat.axisId != physics::kNoSatAxis)
+    {
+        Vec3 axis{};
+        if (sat.axisId < 3)
+            axis = AxisAt(bodies.faceAxes[a], sat.axisId);
+        else if (sat.axisId < 6)
+            axis = AxisAt(bodies.faceAxes[b], sat.axisId - 3);
+        else
+            axis = NormalizeSafe(Cross(AxisAt(bodies.axes[a], (sat.axisId - 6) / 3), AxisAt(bodies.axes[b], (sat.axisId - 6) % 3)));
+        normal = sat.positive ? axis : Scale(axis, -1.0f);
+        featureId = (sat.axisId << 1) | (sat.positive ? 0u : 1u);
+    }
+    const float rbNormal = ProjectedObbRadius(bodies.halfExtents[b], bodies.axes[b], normal);
+    const Vec3 point = Add(ColliderCenter(bodies, b), Scale(normal, rbNormal - sat.depth * 0.5f));
+    return FinishContact(bodies, a, b, ContactType::BoxBox, normal, sat.depth, point, featureId, out);
+}
+
+void PackBoxSphere(physics::BoxSphereBatch& batch, const BodyArrays& bodies, std::size_t a, std::size_t b)
+{
+    const std::size_t box = bodies.Has(a, kBodySphere) ? b : a;
+    const std::size_t sphere = bodies.Has(a, kBodySphere) ? a : b;
+    const std::size_t lane = batch.count++;
+    batch.SetVec3(physics::BoxSphereBatch::BoxCenter, lane, ColliderCenter(bodies, box));
+    batch.SetVec3(physics::BoxSphereBatch::SphereCenter, lane, ColliderCenter(bodies, sphere));
+    batch.SetVec3(physics::BoxSphereBatch::Half, lane, bodies.halfExtents[box]);
+    batch.SetAxes(physics::BoxSphereBatch::Axes, lane, bodies.axes[box]);
+}
+
+bool FinishBoxSphere(const BodyArrays& bodies, std::size_t a, std::size_t b, const physics::BoxSphereClosest& hit, physics::ContactManifold& out)
+{
+    const bool boxIsA = !bodies.Has(a, kBodySphere);
+    const std::size_t box = boxIsA ? a : b;
+    const std::size_t sphere = boxIsA ? b : a;
+    const float radius = BodyRadius(bodies, sphere);
+    if (hit.distanceSq > radius * radius)
+        return false;
+
+    const Vec3 boxHalf = bodies.halfExtents[box];
+    const BoxAxes& boxAxes = bodies.axes[box];
+    const float localX = hit.local[0];
+    const float localY = hit.local[1];
+    const float localZ = hit.local[2];
+    const float distance = std::sqrt(std::max(hit.distanceSq, 0.0f));
+    Vec3 normal{};
+    float minPen = 0.0f;
+    std::uint32_t featureId = 0;
+    if (distance > 0.000001f)
+    {
+        normal = NormalizeSafe(Sub(ColliderCenter(bodies, sphere), hit.closest));
+        minPen = radius - distance;
+        // Box region (face, edge or corner) the closest point lies on: 3 states per axis.
+        const auto region = [](float local, float half) { return local < -half ? 1u : (local > half ? 2u : 0u); };
+        featureId = region(localX, boxHalf.x) + 3 * region(localY, boxHalf.y) + 9 * region(localZ, boxHalf.z);
+    }
+    else
+    {
+        const float px = boxHalf.x - Abs(localX);
+        const float py = boxHalf.y - Abs(localY);
+        const float pz = boxHalf.z - Abs(localZ);
+        minPen = std::max(0.0f, radius + std::min(px, std::min(py, pz)));
+        if (px <= py && px <= pz)
+        {
+            normal = Scale(boxAxes.xAxis, (localX >= 0.0f) ? 1.0f : -1.0f);
+            featureId = 27 + ((localX >= 0.0f) ? 0u : 1u);
+        }
+        else if (py <= pz)
+        {
+            normal = Scale(boxAxes.yAxis, (localY >= 0.0f) ? 1.0f : -1.0f);
+            featureId = 29 + ((localY >= 0.0f) ? 0u : 1u);
+        }
+        else
+        {
+            normal = Scale(boxAxes.zAxis, (localZ >= 0.0f) ? 1.0f : -1.0f);
+            featureId = 31 + ((localZ >= 0.0f) ? 0u : 1u);
+        }
+    }
+    // normal points from the box to the sphere; flip it so it points from B to A.
+    if (boxIsA)
+        normal = Scale(normal, -1.0f);
+    return FinishContact(bodies, a, b, ContactType::BoxSphere, normal, minPen, hit.closest, featureId, out);
+}
+
+bool GenerateSphereSphere(const BodyArrays& bodies, std::size_t a, std::size_t b, physics::ContactManifold& out)
+{
+    const Vec3 bc = ColliderCenter(bodies, b);
+    const Vec3 d = Sub(ColliderCenter(bodies, a), bc);
+    const float ra = BodyRadius(bodies, a);
+    const float rb = BodyRadius(bodies, b);
+    const float distSq = LengthSq(d);
+    const float radiusSum = ra + rb;
+    if (distSq >= radiusSum * radiusSum)
+        return false;
+    const float distance = std::sqrt(std::max(distSq, 0.0f));
+    const Vec3 normal = (distance > 0.000001f) ? Scale(d, 1.0f / distance) : Vec3{ 1.0f, 0.0f, 0.0f };
+    const float minPen = radiusSum - distance;
+    const Vec3 point = Add(bc, Scale(normal, rb - minPen * 0.5f));
+    return FinishContact(bodies, a, b, ContactType::SphereSphere, normal, minPen, point, 0, out);
+}
+
+physics::ConvexView HullView(const BodyArrays& bodies, std::size_t body)
+{
+    const BodyMeshShape& shape = bodies.meshShapes[bodies.meshShape[body]];
+    return physics::ConvexView{
+        bodies.position[body],
+        std::span<const Vec3>(bodies.hullVertices.data() + shape.firstVertex, shape.hull->vertices.size()),
+        std::span<const Vec3>(bodies.hullNormals.data() + shape.firstFace, shape.hull->GetFaceCount()),
+        shape.hull->edges };
+}
+
+physics::BoxPolytope MakeBoxPolytope(const BodyArrays& bodies, std::size_t body)
+{
+    return physics::BoxPolytope(bodies.halfExtents[body], bodies.axes[body], bodies.faceAxes[body]);
+}
+
+// Spheres, boxes, hulls, triangle meshes: pairs are tested with the simpler shape first.
+int ShapeRank(const BodyArrays& bodies, std::size_t body)
+{
+    if (bodies.Has(body, kBodyTriangleMesh))
+        return 3;
+    if (bodies.Has(body, kBodyHull))
+        return 2;
+    return bodies.Has(body, kBodySphere) ? 0 : 1;
+}
+
+// Triangles of a mesh body whose bounds overlap the world bounds, with their world-relative
+// corners; the mesh is placed around the body position.
+template <typename Visitor>
+void ForEachMeshTriangle(const BodyArrays& bodies, std::size_t meshBody, const physics::Aabb& bounds, Visitor&& visitor)
+{
+    const physics::TriangleMesh& mesh = *bodies.meshShapes[bodies.meshShape[meshBody]].triangles;
+    const Vec3& origin = bodies.position[meshBody];
+    mesh.Query(physics::Aabb{ Sub(bounds.min, origin), Sub(bounds.max, origin) }, [&](std::uint32_t triangle)
+    {
+        visitor(triangle,
+            mesh.vertices[mesh.indices[triangle * 3]],
+            mesh.vertices[mesh.indices[triangle * 3 + 1]],
+            mesh.vertices[mesh.indices[triangle * 3 + 2]]);
+    });
+}
+
+// Contacts with a hull or triangle mesh. Triangle meshes are static; the other body is tested
+// against the triangles its bounds reach in the mesh BVH and the deepest contact wins, which
+// fits the one-point manifold the solver uses.
+bool GenerateMeshContact(const BodyArrays& bodies, std::size_t a, std::size_t b, physics::ContactManifold& out)
+{
+    const bool swapped = ShapeRank(bodies, a) > ShapeRank(bodies, b);
+    const std::size_t first = swapped ? b : a;
+    const std::size_t second = swapped ? a : b;
+    const bool firstIsSphere = bodies.Has(first, kBodySphere);
+    const bool firstIsHull = bodies.Has(first, kBodyHull);
+
+    physics::ConvexContact contact;
+    bool touching = false;
+    if (bodies.Has(second, kBodyTriangleMesh))
+    {
+        const Vec3 origin = bodies.position[second];
+        const physics::BoxPolytope box = MakeBoxPolytope(bodies, first);
+        const physics::ConvexView firstView = firstIsHull ? HullView(bodies, first) : box.View(ColliderCenter(bodies, first));
+        ForEachMeshTriangle(bodies, second, ComputeBodyAabb(bodies, first), [&](std::uint32_t triangle, const Vec3& p0, const Vec3& p1, const Vec3& p2)
+        {
+            physics::ConvexContact candidate;
+            bool hit = false;
+            if (firstIsSphere)
+                hit = physics::CollideSphereTriangle(ColliderCenter(bodies, first), BodyRadius(bodies, first), Add(origin, p0), Add(origin, p1), Add(origin, p2), candidate);
+            else
+                hit = physics::CollideConvex(firstView, physics::TrianglePolytope(p0, p1, p2).View(origin), candidate);
+            if (hit && candidate.depth > contact.depth)
+            {
+                contact = candidate;
+                contact.featureId = triangle;
+                touching = true;
+            }
+        });
+    }
+    else
+    {
+        const physics::ConvexView hull = HullView(bodies, second);
+        const std::span<const std::uint32_t> triangles = bodies.meshShapes[bodies.meshShape[second]].hull->triangles;
+        if (firstIsSphere)
+            touching = physics::CollideSphereHull(ColliderCenter(bodies, first), BodyRadius(bodies, first), hull, triangles, contact);
+        else if (firstIsHull)
+            touching = physics::CollideConvex(HullView(bodies, first), hull, contact);
+        else
+            touching = physics::CollideConvex(MakeBoxPolytope(bodies, first).View(ColliderCenter(bodies, first)), hull, contact);
+    }
+    if (!touching)
+        return false;
+    return FinishContact(bodies, a, b, ContactType::Convex, swapped ? Scale(contact.normal, -1.0f) : contact.normal,
+        contact.depth, contact.point, contact.featureId, out);
+}
+
+// Earliest fraction of motion (body relative to other) at which body reaches targetDepth into
+// other, for the continuous collision sweep.
+bool ComputeBodyTimeOfImpact(const BodyArrays& bodies, std::size_t body, std::size_t other, const Vec3& motion, float targetDepth, float& outFraction)
+{
+    if (!bodies.HasMeshShape(body) && !bodies.HasMeshShape(other))
+        return physics::ComputeTimeOfImpact(MakeSweepShape(bodies, body), MakeSweepShape(bodies, other), motion, targetDepth, outFraction);
+
+    const bool bodyIsSphere = bodies.Has(body, kBodySphere);
+    const physics::BoxPolytope bodyBox = MakeBoxPolytope(bodies, body);
+    const physics::ConvexView bodyView = bodies.Has(body, kBodyHull) ? HullView(bodies, body) : bodyBox.View(ColliderCenter(bodies, body));
+    if (bodies.Has(other, kBodyTriangleMesh))
+    {
+        const physics::Aabb start = ComputeBodyAabb(bodies, body);
+        const physics::Aabb swept = physics::Union(start, physics::Aabb{ Add(start.min, motion), Add(start.max, motion) });
+        const Vec3 origin = bodies.position[other];
+        bool hit = false;
+        ForEachMeshTriangle(bodies, other, swept, [&](std::uint32_t, const Vec3& p0, const Vec3& p1, const Vec3& p2)
+        {
+            const physics::TrianglePolytope triangle(p0, p1, p2);
+            float fraction = 1.0f;
+            const bool impact = bodyIsSphere
+                ? physics::ComputeSphereConvexTimeOfImpact(ColliderCenter(bodies, body), BodyRadius(bodies, body), triangle.View(origin), motion, targetDepth, fraction)
+                : physics::ComputeConvexTimeOfImpact(bodyView, triangle.View(origin), motion, targetDepth, fraction);
+            if (impact && (!hit || fraction < outFraction))
+            {
+                outFraction = fraction;
+                hit = true;
+            }
+        });
+        return hit;
+    }
+
+    if (bodies.Has(other, kBodySphere))
+        return physics::ComputeSphereConvexTimeOfImpact(ColliderCenter(bodies, other), BodyRadius(bodies, other), bodyView, Scale(motion, -1.0f), targetDepth, outFraction);
+    const physics::BoxPolytope otherBox = MakeBoxPolytope(bodies, other);
+    const physics::ConvexView otherView = bodies.Has(other, kBodyHull) ? HullView(bodies, other) : otherBox.View(ColliderCenter(bodies, other));
+    if (bodyIsSphere)
+        return physics::ComputeSphereConvexTimeOfImpact(ColliderCenter(bodies, body), BodyRadius(bodies, body), otherView, motion, targetDepth, outFraction);
+    return physics::ComputeConvexTimeOfImpact(bodyView, otherView, motion, targetDepth, outFraction);
+}
+
+// Narrowphase for one candidate pair through the scalar kernels. Reads body state only, so
+// pairs can run on any thread.
+bool GenerateContact(const BodyArrays& bodies, std::size_t a, std::size_t b, physics::ContactManifold& out)
+{
+    if (!CanCollide(bodies, a, b))
+        return false;
+    if (bodies.HasMeshShape(a) || bodies.HasMeshShape(b))
+        return GenerateMeshContact(bodies, a, b, out);
+
+    const bool boxA = !bodies.Has(a, kBodySphere);
+    const bool boxB = !bodies.Has(b, kBodySphere);
+    if (boxA && boxB)
+    {
+        physics::BoxBoxBatch batch;
+        physics::BoxBoxSat sat;
+        PackBoxBox(batch, bodies, a, b);
+        physics::TestBoxBoxBatchScalar(batch, &sat);
+        return FinishBoxBox(bodies, a, b, sat, out);
+    }
+    if (!boxA && !boxB)
+        return GenerateSphereSphere(bodies, a, b, out);
+
+    physics::BoxSphereBatch batch;
+    physics::BoxSphereClosest hit;
+    PackBoxSphere(batch, bodies, a, b);
+    physics::ClosestPointsBoxSphereBatchScalar(batch, &hit);
+    return FinishBoxSphere(bodies, a, b, hit, out);
+}
+
+// Narrowphase for a run of candidate pairs: box-box and box-sphere pairs are packed into
+// batches for the SIMD kernels, sphere and mesh pairs are tested directly, and contacts are appended
+// in pair order so the result matches GenerateContact pair by pair. Pairs that reach a test are
+// counted per contact type in tests.
+void GenerateContacts(
+    const BodyArrays& bodies,
+    const std::pair<std::size_t, std::size_t>* pairs,
+    std::size_t pairCount,
+    std::vector<physics::ContactManifold>& out,
+    std::array<std::uint32_t, physics::kContactTypeCount>& tests)
+{
+    constexpr std::size_t kWindow = 64;
+    constexpr std::size_t kWidth = physics::kNarrowphaseBatchWidth;
+    physics::ContactManifold contacts[kWindow];
+    bool touching[kWindow];
+    physics::BoxBoxBatch boxBoxBatch;
+    physics::BoxBoxSat boxBoxResults[kWidth];
+    std::size_t boxBoxSlots[kWidth];
+    physics::BoxSphereBatch boxSphereBatch;
+    physics::BoxSphereClosest boxSphereResults[kWidth];
+    std::size_t boxSphereSlots[kWidth];
+
+    for (std::size_t windowBegin = 0; windowBegin < pairCount; windowBegin += kWindow)
+    {
+        const std::size_t windowSize = std::min(kWindow, pairCount - windowBegin);
+        const auto pairAt = [&](std::size_t slot) -> const std::pair<std::size_t, std::size_t>&
+        {
+            return pairs[windowBegin + slot];
+        };
+        const auto flushBoxBox = [&]()
+        {
+            physics::TestBoxBoxBatch(boxBoxBatch, boxBoxResults);
+            for (std::size_t lane = 0; lane < boxBoxBatch.count; ++lane)
+            {
+                const std::size_t slot = boxBoxSlots[lane];
+                touching[slot] = FinishBoxBox(bodies, pairAt(slot).first, pairAt(slot).second, boxBoxResults[lane], contacts[slot]);
+            }
+            boxBoxBatch.count = 0;
+        };
+        const auto flushBoxSphere = [&]()
+        {
+            physics::ClosestPointsBoxSphereBatch(boxSphereBatch, boxSphereResults);
+            for (std::size_t lane = 0; lane < boxSphereBatch.count; ++lane)
+            {
+                const std::size_t slot = boxSphereSlots[lane];
+                touching[slot] = FinishBoxSphere(bodies, pairAt(slot).first, pairAt(slot).second, boxSphereResults[lane], contacts[slot]);
+            }
+            boxSphereBatch.count = 0;
+        };
+
+        for (std::size_t slot = 0; slot < windowSize; ++slot)
+        {
+            touching[slot] = false;
+            const std::size_t a = pairAt(slot).first;
+            const std::size_t b = pairAt(slot).second;
+            if (!CanCollide(bodies, a, b))
+                continue;
+            if (bodies.HasMeshShape(a) || bodies.HasMeshShape(b))
+            {
+                ++tests[static_cast<std::size_t>(ContactType::Convex)];
+                touching[slot] = GenerateMeshContact(bodies, a, b, contacts[slot]);
+                continue;
+            }
+            // Fat broadphase bounds pair many bodies that do not touch; a contact needs positive
+            // depth, which tight bounds that miss each other cannot have.
+            if (!physics::Overlaps(ComputeBodyAabb(bodies, a), ComputeBodyAabb(bodies, b)))
+                continue;
+            const bool boxA = !bodies.Has(a, kBodySphere);
+            const bool boxB = !bodies.Has(b, kBodySphere);
+            const ContactType type = boxA && boxB
+                ? ContactType::BoxBox
+                : (!boxA && !boxB ? ContactType::SphereSphere : ContactType::BoxSphere);
+            ++tests[static_cast<std::size_t>(type)];
+            if (boxA && boxB)
+            {
+                boxBoxSlots[boxBoxBatch.count] = slot;
+                PackBoxBox(boxBoxBatch, bodies, a, b);
+                if (boxBoxBatch.count == kWidth)
+                    flushBoxBox();
+            }
+            else if (!boxA && !boxB)
+            {
+                touching[slot] = GenerateSphereSphere(bodies, a, b, contacts[slot]);
+            }
+            else
+            {
+                boxSphereSlots[boxSphereBatch.count] = slot;
+                PackBoxSphere(boxSphereBatch, bodies, a, b);
+                if (boxSphereBatch.count == kWidth)
+                    flushBoxSphere();
+            }
+        }
+        if (boxBoxBatch.count > 0)
+            flushBoxBox();
+        if (boxSphereBatch.count > 0)
+            flushBoxSphere();
+
+        for (std::size_t slot = 0; slot < windowSize; ++slot)
+        {
+            if (!touching[slot])
+                continue;
+            physics::ContactManifold& contact = contacts[slot];
+            contact.bodyA = static_cast<std::uint32_t>(pairAt(slot).first);
+            contact.bodyB = static_cast<std::uint32_t>(pairAt(slot).second);
+            out.push_back(contact);
+        }
+    }
+}
+
+// Adds the time since the previous lap to one phase of the step stats.
+class PhaseClock
+{
+public:
+    explicit PhaseClock(ecs::PhysicsStepStats& stats)
+        : m_Stats(stats)
+        , m_Start(std::chrono::steady_clock::now())
+        , m_Lap(m_Start)
+    {
+    }
+
+    void Lap(ecs::PhysicsPhase phase)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        m_Stats.phaseMs[static_cast<std::size_t>(phase)] += std::chrono::duration<double, std::milli>(now - m_Lap).count();
+        m_Stats.totalMs = std::chrono::duration<double, std::milli>(now - m_Start).count();
+        m_Lap = now;
+    }
+
+private:
+    ecs::PhysicsStepStats& m_Stats;
+    std::chrono::steady_clock::time_point m_Start;
+    std::chrono::steady_clock::time_point m_Lap;
 };
 }
 
 namespace ecs {
+const char* PhysicsSystem::PhaseName(PhysicsPhase phase)
+{
+    switch (phase)
+    {
+    case PhysicsPhase::Sync:          return "sync";
+    case PhysicsPhase::Broadphase:    return "broadphase";
+    case PhysicsPhase::Narrowphase:   return "narrowphase";
+    case PhysicsPhase::Solver:        return "solver";
+    case PhysicsPhase::Continuous:    return "continuous";
+    case PhysicsPhase::PositionSolve: return "position_solve";
+    case PhysicsPhase::Finalize:      return "finalize";
+    default:                          return "unknown";
+    }
+}
+
+void PhysicsSystem::CaptureSnapshot(World& world, std::vector<std::uint8_t>& outBlob) const
+{
+    outBlob.clear();
+    SnapshotHeader header;
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.nextSleepIsland = m_NextSleepIsland;
+    header.sleepingBodyCount = m_SleepingBodyCount;
+    header.awakeIslandCount = m_AwakeIslandCount;
+    header.lodFrame = m_LodFrame;
+    AppendBlob(outBlob, &header, 1);
+
+    // Counts are patched into the header once the sections are written.
+    world.ForEach<TransformComponent, RigidbodyComponent>([&](Entity e, TransformComponent& t, RigidbodyComponent& rb)
+    {
+        const SnapshotBody body{ e, t.position, t.rotation, rb.velocity, rb.isSleeping ? 1u : 0u };
+        AppendBlob(outBlob, &body, 1);
+        ++header.bodyCount;
+    });
+    for (std::size_t index = 0; index < m_ProxySlots.size(); ++index)
+    {
+        const ProxySlot& slot = m_ProxySlots[index];
+        if (slot.proxy == physics::kNullProxy)
+            continue;
+        const SnapshotSlot record{
+            static_cast<std::uint32_t>(index), slot.generation, slot.sleepIsland, slot.sleepTimer,
+            static_cast<std::uint32_t>(slot.lodLevel), slot.lodPendingTime, slot.position, slot.rotation, slot.halfExtents, slot.offset };
+        AppendBlob(outBlob, &record, 1);
+        ++header.slotCount;
+    }
+    const std::span<const physics::ContactCache::Entry> cache = m_ContactCache.GetEntries();
+    AppendBlob(outBlob, cache.data(), cache.size());
+    header.cacheCount = static_cast<std::uint32_t>(cache.size());
+    AppendBlob(outBlob, m_TouchingPairs.data(), m_TouchingPairs.size());
+    header.pairCount = static_cast<std::uint32_t>(m_TouchingPairs.size());
+
+    std::memcpy(outBlob.data(), &header, sizeof(header));
+}
+
+bool PhysicsSystem::RestoreSnapshot(World& world, std::span<const std::uint8_t> blob)
+{
+    std::size_t offset = 0;
+    SnapshotHeader header;
+    if (!ReadBlob(blob, offset, &header, 1) ||
+        std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header.version != kSnapshotVersion)
+    {
+        return false;
+    }
+    const std::size_t expectedSize = sizeof(SnapshotHeader) +
+        sizeof(SnapshotBody) * header.bodyCount +
+        sizeof(SnapshotSlot) * header.slotCount +
+        sizeof(physics::ContactCache::Entry) * header.cacheCount +
+        sizeof(TouchingPair) * header.pairCount;
+    if (blob.size() != expectedSize)
+        return false;
+
+    for (std::uint32_t i = 0; i < header.bodyCount; ++i)
+    {
+        SnapshotBody body;
+        (void)ReadBlob(blob, offset, &body, 1);
+        if (!world.IsAlive(body.entity))
+            continue;
+        auto* transform = world.GetComponent<TransformComponent>(body.entity);
+        auto* rigidbody = world.GetComponent<RigidbodyComponent>(body.entity);
+        if (transform == nullptr || rigidbody == nullptr)
+            continue;
+        transform->position = body.position;
+        transform->rotation = body.rotation;
+        rigidbody->velocity = body.velocity;
+        rigidbody->isSleeping = body.sleeping != 0;
+    }
+    for (std::uint32_t i = 0; i < header.slotCount; ++i)
+    {
+        SnapshotSlot record;
+        (void)ReadBlob(blob, offset, &record, 1);
+        // A slot whose entity index was recycled belongs to another body now.
+        if (record.index >= m_ProxySlots.size() || m_ProxySlots[record.index].generation != record.generation)
+            continue;
+        ProxySlot& slot = m_ProxySlots[record.index];
+        slot.sleepIsland = record.sleepIsland;
+        slot.sleepTimer = record.sleepTimer;
+        slot.lodLevel = record.lodLevel < physics::kLodLevelCount ? static_cast<physics::LodLevel>(record.lodLevel) : physics::LodLevel::Full;
+        slot.lodPendingTime = record.lodPendingTime;
+        slot.position = record.position;
+        slot.rotation = record.rotation;
+        slot.halfExtents = record.halfExtents;
+        slot.offset = record.offset;
+    }
+    std::vector<physics::ContactCache::Entry> cache(header.cacheCount);
+    (void)ReadBlob(blob, offset, cache.data(), cache.size());
+    m_ContactCache.SetEntries(cache);
+    m_TouchingPairs.resize(header.pairCount);
+    (void)ReadBlob(blob, offset, m_TouchingPairs.data(), m_TouchingPairs.size());
+
+    m_NextSleepIsland = header.nextSleepIsland;
+    m_SleepingBodyCount = static_cast<std::size_t>(header.sleepingBodyCount);
+    m_AwakeIslandCount = static_cast<std::size_t>(header.awakeIslandCount);
+    m_LodFrame = header.lodFrame;
+    m_ResyncProxies = true;
+    return true;
+}
+
+const physics::TriangleMesh* PhysicsSystem::PlaceTriangleMesh(
+    Entity entity,
+    const TransformComponent& transform,
+    const ColliderComponent& collider,
+    const RigidbodyComponent& rigidbody)
+{
+    // Dynamic triangle-mesh colliders collide through their hull instead.
+    const bool usesTriangles =
+        collider.type == ColliderType::TriangleMesh && rigidbody.isStatic &&
+        collider.meshShape != nullptr && collider.meshShape->triangles.IsValid();
+    if (!usesTriangles)
+    {
+        if (entity.index < m_ProxySlots.size())
+            m_ProxySlots[entity.index].placedMesh.reset();
+        return nullptr;
+    }
+
+    if (entity.index >= m_ProxySlots.size())
+        m_ProxySlots.resize(static_cast<std::size_t>(entity.index) + 1);
+    std::unique_ptr<PlacedTriangleMesh>& placed = m_ProxySlots[entity.index].placedMesh;
+    if (placed == nullptr)
+        placed = std::make_unique<PlacedTriangleMesh>();
+    // Only a new mesh, rotation or scale re-places the triangles; moving the body does not.
+    if (placed->shape != collider.meshShape || !SameVec3(placed->rotation, transform.rotation) || !SameVec3(placed->scale, transform.scale))
+    {
+        placed->shape = collider.meshShape;
+        placed->rotation = transform.rotation;
+        placed->scale = transform.scale;
+        placed->triangles = physics::TransformTriangleMesh(collider.meshShape->triangles, physics::BuildBoxAxes(transform.rotation), transform.scale);
+    }
+    return &placed->triangles;
+}
+
 void PhysicsSystem::Update(World& world, float dt)
 {
-    if (!m_Enabled)
-        return;
+    m_ContactEvents.clear();
+    m_StepStats = PhysicsStepStats{};
+    PhaseClock clock(m_StepStats);
+    AllocationScope allocationScope(AllocationTag::Physics, "PhysicsSystem::Update");
 
-    if (dt <= 0.0f)
-        return;
-    if (dt > 0.05f)
-        dt = 0.05f;
+    // Disabled or paused updates only sync proxies and query colliders; nothing moves.
+    const bool stepping = m_Enabled && dt > 0.0f;
+    if (dt > kMaxUpdateTime)
+        dt = kMaxUpdateTime;
     const float gravity = m_Gravity;
-    const float baseStep = 1.0f / 240.0f;
-    const int dynamicSubsteps = static_cast<int>(std::ceil(dt / baseStep));
-    const int configuredSubsteps = m_Substeps > 0 ? m_Substeps : 1;
-    const int substeps = std::max(configuredSubsteps, std::min(dynamicSubsteps, 64));
-    const float stepDt = dt / static_cast<float>(substeps);
+    // Fast bodies flagged for CCD are swept below, so the substep count no longer scales with dt.
+    int substeps = m_Substeps > 0 ? m_Substeps : 1;
+    float stepDt = dt / static_cast<float>(substeps);
     const float dampingPerStep = std::pow(std::max(m_LinearDamping, 0.0f), stepDt * 60.0f);
     const int solverIterations = std::max(m_SolverIterations, 1);
-    std::vector<BodyRef> bodies;
-    bodies.reserve(128);
+    // Node containers recycle through the pool; the pool itself draws from the frame arena.
+    std::pmr::unsynchronized_pool_resource scratch(&FrameArena::ForThisThread());
+    BodyArrays bodies(&scratch);
+    bodies.Reserve(128);
     world.ForEach<ColliderComponent, TransformComponent, RigidbodyComponent>([&](Entity e, ColliderComponent& c, TransformComponent& t, RigidbodyComponent& rb){
-        bodies.push_back(BodyRef{ e, &t, &c, &rb });
+        bodies.Append(e, t, c, rb, dampingPerStep, PlaceTriangleMesh(e, t, c, rb));
     });
 
-    for (int step = 0; step < substeps; ++step)
-    {
-    world.ForEach<TransformComponent, RigidbodyComponent>([&](Entity, TransformComponent& t, RigidbodyComponent& rb){
-        if (rb.isStatic || !rb.simulatePhysics) return;
-        if (rb.useGravity) rb.velocity.y -= gravity * stepDt;
+    // Rigidbodies without a collider touch nothing; they only integrate.
+    world.ForEach<TransformComponent, RigidbodyComponent>([&](Entity e, TransformComponent& t, RigidbodyComponent& rb){
+        if (!stepping || rb.isStatic || !rb.simulatePhysics || rb.isSleeping || world.HasComponent<ColliderComponent>(e)) return;
         const float bodyDamping = std::pow(dampingPerStep, std::max(rb.linearDampingMultiplier, 0.0f));
-        rb.velocity.x *= bodyDamping;
-        rb.velocity.z *= bodyDamping;
-        if (Abs(rb.velocity.x) < 0.0005f) rb.velocity.x = 0.0f;
-        if (Abs(rb.velocity.z) < 0.0005f) rb.velocity.z = 0.0f;
-        rb.velocity = Add(rb.velocity, Scale(rb.acceleration, stepDt));
-        t.position = Add(t.position, Scale(rb.velocity, stepDt));
+        for (int step = 0; step < substeps; ++step)
+        {
+            rb.velocity = IntegrateVelocity(rb.velocity, rb.acceleration, rb.useGravity, gravity, bodyDamping, stepDt);
+            t.position = Add(t.position, Scale(rb.velocity, stepDt));
+        }
     });
 
-    std::vector<std::pair<std::size_t, std::size_t>> candidatePairs;
-    candidatePairs.reserve(bodies.size() * 3);
-    std::unordered_set<std::uint64_t> pairDedup;
-    pairDedup.reserve(bodies.size() * 8);
-    std::unordered_map<std::uint64_t, std::vector<std::size_t>> grid;
-    grid.reserve(bodies.size() * 2);
-    std::vector<std::size_t> dynamicBodies;
-    std::vector<std::size_t> staticBoxes;
-    dynamicBodies.reserve(bodies.size());
-    staticBoxes.reserve(16);
-    const float cellSize = 0.6f;
-    for (std::size_t i = 0; i < bodies.size(); ++i)
-    {
-        const BodyRef& body = bodies[i];
-        if ((!body.rigidbody->simulatePhysics && !body.rigidbody->isStatic))
-            continue;
-        if (!body.rigidbody->isStatic)
-            dynamicBodies.push_back(i);
-        else if (body.collider->type == ColliderType::Box)
-            staticBoxes.push_back(i);
-        const Vec3 c = Add(body.transform->position, body.collider->offset);
-        const int cx = CellCoord(c.x, cellSize);
-        const int cy = CellCoord(c.y, cellSize);
-        const int cz = CellCoord(c.z, cellSize);
-        grid[CellKey(cx, cy, cz)].push_back(i);
-    }
-
-    // Always test dynamic bodies against static boxes (plane/ramp support)
-    // to avoid broadphase misses for large static colliders occupying many cells.
-    for (const std::size_t i : dynamicBodies)
-    {
-        const BodyRef& a = bodies[i];
-        const Vec3 ac = Add(a.transform->position, a.collider->offset);
-        for (const std::size_t j : staticBoxes)
-        {
-            if (i == j)
-                continue;
-            const std::uint64_t pkey = PairKey(i, j);
-            if (!pairDedup.insert(pkey).second)
+    // Sleeping islands wake as a whole: collect their ids, then flip every member in one pass.
+    std::pmr::vector<std::uint32_t> wakeIslands(&scratch);
+    const auto wakeMarkedIslands = [&]()
+    {
+        if (wakeIslands.empty())
+            return;
+        std::sort(wakeIslands.begin(), wakeIslands.end());
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            ProxySlot& slot = m_ProxySlots[bodies.entity[i].index];
+            if (slot.sleepIsland == 0 || !std::binary_search(wakeIslands.begin(), wakeIslands.end(), slot.sleepIsland))
                 continue;
-            const BodyRef& b = bodies[j];
-            const Vec3 bc = Add(b.transform->position, b.collider->offset);
-            const Vec3 d = Sub(ac, bc);
-            const float ra = BoundingRadius(*a.collider);
-            const float rb = BoundingRadius(*b.collider);
-            const float broadphasePad = 0.10f;
-            const float range = ra + rb + broadphasePad;
-            if (LengthSq(d) <= range * range)
-                candidatePairs.emplace_back(std::min(i, j), std::max(i, j));
+            slot.sleepIsland = 0;
+            slot.sleepTimer = 0.0f;
+            bodies.flags[i] &= ~kBodySleeping;
         }
+        wakeIslands.clear();
+    };
+
+    // Anything that changed a collider since the last update (editor, gameplay, autofit) counts
+    // as an edit, including a new layer or mask; a sleeping body that was edited or given a
+    // velocity wakes its island.
+    std::pmr::vector<std::uint8_t> poseEdited(bodies.Size(), 0, &scratch);
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+    {
+        const Entity entity = bodies.entity[i];
+        if (entity.index >= m_ProxySlots.size())
+            m_ProxySlots.resize(static_cast<std::size_t>(entity.index) + 1);
+
+        const ProxySlot& slot = m_ProxySlots[entity.index];
+        const bool edited =
+            !SameVec3(slot.position, bodies.position[i]) ||
+            !SameVec3(slot.rotation, bodies.rotation[i]) ||
+            !SameVec3(slot.halfExtents, bodies.halfExtents[i]) ||
+            !SameVec3(slot.offset, bodies.offset[i]) ||
+            slot.layer != bodies.layer[i] ||
+            slot.mask != bodies.mask[i];
+        poseEdited[i] = edited ? 1 : 0;
+
+        if (!bodies.Has(i, kBodySleeping))
+            continue;
+        const bool keepsSleeping =
+            bodies.Has(i, kBodySimulated) && !bodies.Has(i, kBodyStatic) && !edited &&
+            slot.sleepIsland != 0 && slot.generation == entity.generation &&
+            LengthSq(bodies.velocity[i]) == 0.0f;
+        if (keepsSleeping)
+            continue;
+        bodies.flags[i] &= ~kBodySleeping;
+        if (slot.sleepIsland != 0 && slot.generation == entity.generation)
+            wakeIslands.push_back(slot.sleepIsland);
     }
 
-    for (std::size_t i = 0; i < bodies.size(); ++i)
+    // Proxies persist across frames; sync them once here instead of rebuilding a grid per substep.
+    ++m_BroadphaseFrame;
+    std::pmr::vector<physics::ProxyId> bodyProxies(bodies.Size(), physics::kNullProxy, &scratch);
+    std::pmr::vector<physics::Aabb> editedStaticBounds(&scratch);
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
     {
-        const BodyRef& a = bodies[i];
-        if ((!a.rigidbody->simulatePhysics && !a.rigidbody->isStatic))
+        const Entity entity = bodies.entity[i];
+        const bool isStatic = bodies.Has(i, kBodyStatic);
+        ProxySlot& slot = m_ProxySlots[entity.index];
+        const bool participates = bodies.Has(i, kBodySimulated | kBodyStatic);
+        if (slot.proxy != physics::kNullProxy &&
+            (!participates || slot.generation != entity.generation || slot.isStatic != isStatic))
+        {
+            m_Broadphase.DestroyProxy(slot.proxy);
+            if (slot.proxy < m_QueryColliders.size())
+                m_QueryColliders[slot.proxy].entity = Entity{};
+            slot.proxy = physics::kNullProxy;
+            if (slot.sleepIsland != 0)
+                wakeIslands.push_back(slot.sleepIsland);
+            slot.sleepIsland = 0;
+            slot.sleepTimer = 0.0f;
+        }
+        if (!participates)
+            continue;
+
+        // Unedited static and sleeping bodies have not moved; keep their proxies untouched.
+        if (slot.proxy != physics::kNullProxy && !poseEdited[i] && !bodies.IsAwakeDynamic(i) && !m_ResyncProxies)
+        {
+            m_Broadphase.SetUserData(slot.proxy, static_cast<std::uint32_t>(i));
+            m_Broadphase.SetFilter(slot.proxy, bodies.layer[i], bodies.mask[i]);
+            slot.lastSeenFrame = m_BroadphaseFrame;
+            bodyProxies[i] = slot.proxy;
             continue;
-        const Vec3 ac = Add(a.transform->position, a.collider->offset);
-        const int cx = CellCoord(ac.x, cellSize);
-        const int cy = CellCoord(ac.y, cellSize);
-        const int cz = CellCoord(ac.z, cellSize);
-        for (int ox = -1; ox <= 1; ++ox)
-        for (int oy = -1; oy <= 1; ++oy)
-        for (int oz = -1; oz <= 1; ++oz)
-        {
-            const auto it = grid.find(CellKey(cx + ox, cy + oy, cz + oz));
-            if (it == grid.end())
+        }
+
+        const physics::Aabb bounds = ComputeBodyAabb(bodies, i);
+        if (slot.proxy == physics::kNullProxy)
+        {
+            slot.proxy = m_Broadphase.CreateProxy(bounds, static_cast<std::uint32_t>(i), isStatic, bodies.layer[i], bodies.mask[i]);
+            slot.generation = entity.generation;
+            slot.isStatic = isStatic;
+            slot.lodLevel = physics::LodLevel::Full;
+            slot.lodPendingTime = 0.0f;
+        }
+        else
+        {
+            m_Broadphase.SetUserData(slot.proxy, static_cast<std::uint32_t>(i));
+            m_Broadphase.SetFilter(slot.proxy, bodies.layer[i], bodies.mask[i]);
+            // Static colliders moved by an edit may have left bodies resting on them, or been
+            // pushed into sleeping ones; wake whatever touches the old or new bounds.
+            if (isStatic && poseEdited[i])
+                editedStaticBounds.push_back(m_Broadphase.GetFatAabb(slot.proxy));
+            (void)m_Broadphase.MoveProxy(slot.proxy, bounds, Vec3{});
+            if (isStatic && poseEdited[i])
+                editedStaticBounds.push_back(m_Broadphase.GetFatAabb(slot.proxy));
+        }
+        slot.lastSeenFrame = m_BroadphaseFrame;
+        bodyProxies[i] = slot.proxy;
+    }
+    m_ResyncProxies = false;
+    for (ProxySlot& slot : m_ProxySlots)
+    {
+        if (slot.proxy != physics::kNullProxy && slot.lastSeenFrame != m_BroadphaseFrame)
+        {
+            slot.placedMesh.reset();
+            m_Broadphase.DestroyProxy(slot.proxy);
+            if (slot.proxy < m_QueryColliders.size())
+                m_QueryColliders[slot.proxy].entity = Entity{};
+            slot.proxy = physics::kNullProxy;
+            if (slot.sleepIsland != 0)
+                wakeIslands.push_back(slot.sleepIsland);
+            slot.sleepIsland = 0;
+            slot.sleepTimer = 0.0f;
+        }
+    }
+    for (const physics::Aabb& staticBounds : editedStaticBounds)
+    {
+        m_Broadphase.GetDynamicTree().Query(staticBounds, [&](std::uint32_t proxy)
+        {
+            const std::uint32_t bodyIndex = m_Broadphase.GetUserData(static_cast<physics::ProxyId>(proxy));
+            const ProxySlot& slot = m_ProxySlots[bodies.entity[bodyIndex].index];
+            if (slot.sleepIsland != 0)
+                wakeIslands.push_back(slot.sleepIsland);
+        });
+    }
+    wakeMarkedIslands();
+
+    // Query colliders follow the bodies; dynamic proxies are refit first so the trees enclose
+    // the final positions rather than the last substep's prediction.
+    const auto publishQueryColliders = [&]()
+    {
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            const physics::ProxyId proxy = bodyProxies[i];
+            if (proxy == physics::kNullProxy)
                 continue;
-            for (const std::size_t j : it->second)
-            {
-                if (i >= j)
-                    continue;
-                const BodyRef& b = bodies[j];
-                if ((!b.rigidbody->simulatePhysics && !b.rigidbody->isStatic))
-                    continue;
-                if (a.rigidbody->isStatic && b.rigidbody->isStatic)
-                    continue;
-                const std::uint64_t pkey = PairKey(i, j);
-                if (!pairDedup.insert(pkey).second)
-                    continue;
-                const Vec3 bc = Add(b.transform->position, b.collider->offset);
-                const Vec3 d = Sub(ac, bc);
-                const float ra = BoundingRadius(*a.collider);
-                const float rb = BoundingRadius(*b.collider);
-                const float broadphasePad = 0.05f;
-                const float range = ra + rb + broadphasePad;
-                if (LengthSq(d) <= range * range)
-                    candidatePairs.emplace_back(i, j);
-            }
+            if (bodies.IsAwakeDynamic(i))
+                (void)m_Broadphase.MoveProxy(proxy, ComputeBodyAabb(bodies, i), Vec3{});
+            if (proxy >= m_QueryColliders.size())
+                m_QueryColliders.resize(static_cast<std::size_t>(proxy) + 1);
+            physics::QueryCollider& collider = m_QueryColliders[proxy];
+            collider.entity = bodies.entity[i];
+            collider.center = ColliderCenter(bodies, i);
+            collider.halfExtents = bodies.halfExtents[i];
+            collider.axes = bodies.faceAxes[i];
+            collider.radius = BodyRadius(bodies, i);
+            collider.isSphere = bodies.Has(i, kBodySphere);
+            collider.isStatic = bodies.Has(i, kBodyStatic);
+            collider.layer = bodies.layer[i];
         }
+    };
+    m_StepStats.bodies = static_cast<std::uint32_t>(bodies.Size());
+    m_StepStats.proxies = static_cast<std::uint32_t>(m_Broadphase.GetProxyCount());
+    m_StepStats.staticTreeHeight = static_cast<std::uint32_t>(m_Broadphase.GetStaticTree().GetHeight());
+    m_StepStats.dynamicTreeHeight = static_cast<std::uint32_t>(m_Broadphase.GetDynamicTree().GetHeight());
+    if (!stepping)
+    {
+        publishQueryColliders();
+        bodies.WriteBack();
+        clock.Lap(PhysicsPhase::Sync);
+        return;
     }
 
-    for (int iter = 0; iter < solverIterations; ++iter)
+    // Every awake body steps once per stride substeps and then advances by all the substeps it
+    // skipped, so it still covers dt; the last substep steps everyone. Bodies joined by a
+    // broadphase pair share the smaller stride, so bodies that may touch step together.
+    std::pmr::vector<std::uint16_t> bodyStride(bodies.Size(), 1, &scratch);
+    // Substeps each body has covered, and how many it advances in the current one (0: none).
+    std::pmr::vector<std::uint16_t> bodyStepsDone(bodies.Size(), 0, &scratch);
+    std::pmr::vector<std::uint16_t> stepSpan(bodies.Size(), 0, &scratch);
+    std::pmr::vector<std::uint32_t> strideParent(&scratch);
+    bool mixedStrides = false;
+    // Pairs of proxies destroyed since the last UpdatePairs do not map to a body.
+    const auto pairBodies = [&](const physics::BroadphasePair& pair, std::size_t& i, std::size_t& j)
     {
-    for (const auto& pair : candidatePairs)
+        i = m_Broadphase.GetUserData(pair.a);
+        j = m_Broadphase.GetUserData(pair.b);
+        return i < bodies.Size() && j < bodies.Size() && bodyProxies[i] == pair.a && bodyProxies[j] == pair.b;
+    };
+    const auto updatePairs = [&]()
+    {
+        m_Broadphase.UpdatePairs();
+        const physics::BroadphaseUpdateStats& pairStats = m_Broadphase.GetLastUpdateStats();
+        m_StepStats.movedProxies += pairStats.movedProxies;
+        m_StepStats.candidatePairs += pairStats.candidates;
+        m_StepStats.duplicatePairs += pairStats.duplicates;
+    };
+    const auto shareStrides = [&]()
+    {
+        strideParent.resize(bodies.Size());
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+            strideParent[i] = static_cast<std::uint32_t>(i);
+        for (const physics::BroadphasePair& pair : m_Broadphase.GetPairs())
+        {
+            std::size_t i = 0;
+            std::size_t j = 0;
+            if (!pairBodies(pair, i, j) || !bodies.IsAwakeDynamic(i) || !bodies.IsAwakeDynamic(j))
+                continue;
+            const std::uint32_t rootI = FindIslandRoot(strideParent, static_cast<std::uint32_t>(i));
+            const std::uint32_t rootJ = FindIslandRoot(strideParent, static_cast<std::uint32_t>(j));
+            if (rootI != rootJ)
+                strideParent[std::max(rootI, rootJ)] = std::min(rootI, rootJ);
+        }
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            const std::uint32_t root = FindIslandRoot(strideParent, static_cast<std::uint32_t>(i));
+            bodyStride[root] = std::min(bodyStride[root], bodyStride[i]);
+        }
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+            bodyStride[i] = bodyStride[FindIslandRoot(strideParent, static_cast<std::uint32_t>(i))];
+    };
+    // Distance LOD works on islands of awake bodies joined by broadphase pairs, so bodies that
+    // may touch share a level: the one of the body closest to the focus.
+    std::pmr::vector<physics::LodLevel> bodyLod(bodies.Size(), physics::LodLevel::Full, &scratch);
+    // Multiplies the time a body covers per step; a Distant island that skipped updates catches up.
+    std::pmr::vector<float> bodyTimeScale(bodies.Size(), 1.0f, &scratch);
+    bool lodActive = false;
+    if (m_Lod.enabled)
     {
-            const std::size_t i = pair.first;
-            const std::size_t j = pair.second;
-            BodyRef& a = bodies[i];
-            BodyRef& b = bodies[j];
-            if ((!a.rigidbody->simulatePhysics && !a.rigidbody->isStatic) ||
-                (!b.rigidbody->simulatePhysics && !b.rigidbody->isStatic))
+        updatePairs();
+        ++m_LodFrame;
+        std::pmr::vector<std::uint32_t> lodParent(bodies.Size(), 0, &scratch);
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+            lodParent[i] = static_cast<std::uint32_t>(i);
+        for (const physics::BroadphasePair& pair : m_Broadphase.GetPairs())
+        {
+            std::size_t i = 0;
+            std::size_t j = 0;
+            if (!pairBodies(pair, i, j) || !bodies.IsAwakeDynamic(i) || !bodies.IsAwakeDynamic(j))
                 continue;
-            if (a.rigidbody->isStatic && b.rigidbody->isStatic)
+            const std::uint32_t rootI = FindIslandRoot(lodParent, static_cast<std::uint32_t>(i));
+            const std::uint32_t rootJ = FindIslandRoot(lodParent, static_cast<std::uint32_t>(j));
+            if (rootI != rootJ)
+                lodParent[std::max(rootI, rootJ)] = std::min(rootI, rootJ);
+        }
+        std::pmr::vector<physics::LodLevel> islandLod(bodies.Size(), physics::LodLevel::Count, &scratch);
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            if (!bodies.IsAwakeDynamic(i))
                 continue;
-
-            Vec3 ac = Add(a.transform->position, a.collider->offset);
-            Vec3 bc = Add(b.transform->position, b.collider->offset);
-            Vec3 d = Sub(ac, bc);
-            const Vec3 aHalf = RotatedAabbHalfExtents(a.collider->halfExtents, a.transform->rotation);
-            const Vec3 bHalf = RotatedAabbHalfExtents(b.collider->halfExtents, b.transform->rotation);
-            const BoxAxes axesA = BuildBoxAxes(a.transform->rotation);
-            const BoxAxes axesB = BuildBoxAxes(b.transform->rotation);
-            float minPen = 0.0f;
-            int axis = 1;
-            Vec3 normal{ 0.0f, 1.0f, 0.0f };
-            ContactType contactType = ContactType::None;
-
-            if (a.collider->type == ColliderType::Box && b.collider->type == ColliderType::Box)
+            const ProxySlot& slot = m_ProxySlots[bodies.entity[i].index];
+            const float distance = Length(Sub(ColliderCenter(bodies, i), m_LodFocus));
+            const std::uint32_t root = FindIslandRoot(lodParent, static_cast<std::uint32_t>(i));
+            islandLod[root] = std::min(islandLod[root], physics::NextLodLevel(m_Lod, slot.lodLevel, distance));
+        }
+        const int distantInterval = std::max(m_Lod.distantInterval, 1);
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            if (!bodies.IsAwakeDynamic(i))
+                continue;
+            ProxySlot& slot = m_ProxySlots[bodies.entity[i].index];
+            const std::uint32_t root = FindIslandRoot(lodParent, static_cast<std::uint32_t>(i));
+            const physics::LodLevel level = islandLod[root];
+            slot.lodLevel = level;
+            bodyLod[i] = level;
+            ++m_StepStats.lodBodies[static_cast<std::size_t>(level)];
+            // Promoted bodies drop the time they skipped instead of making it up in one jump.
+            if (level != physics::LodLevel::Distant)
+                slot.lodPendingTime = 0.0f;
+            if (level == physics::LodLevel::Full)
+                continue;
+            lodActive = true;
+            if (level == physics::LodLevel::Distant)
             {
-                Vec3 candidateAxes[15];
-                int axisCount = 0;
-                candidateAxes[axisCount++] = NormalizeSafe(axesA.xAxis);
-                candidateAxes[axisCount++] = NormalizeSafe(axesA.yAxis);
-                candidateAxes[axisCount++] = NormalizeSafe(axesA.zAxis);
-                candidateAxes[axisCount++] = NormalizeSafe(axesB.xAxis);
-                candidateAxes[axisCount++] = NormalizeSafe(axesB.yAxis);
-                candidateAxes[axisCount++] = NormalizeSafe(axesB.zAxis);
-
-                const Vec3 axesALocal[] = { axesA.xAxis, axesA.yAxis, axesA.zAxis };
-                const Vec3 axesBLocal[] = { axesB.xAxis, axesB.yAxis, axesB.zAxis };
-                for (const Vec3& axA : axesALocal)
-                {
-                    for (const Vec3& axB : axesBLocal)
-                    {
-                        const Vec3 crossAxis = Cross(axA, axB);
-                        if (LengthSq(crossAxis) > 0.000001f)
-                            candidateAxes[axisCount++] = NormalizeSafe(crossAxis);
-                    }
-                }
-
-                minPen = 1.0e9f;
-                bool separated = false;
-                for (int idx = 0; idx < axisCount; ++idx)
+                // Islands take turns by their first body's entity, so the work spreads over
+                // the interval instead of arriving all in one update.
+                if ((m_LodFrame + bodies.entity[root].index) % static_cast<std::uint64_t>(distantInterval) != 0)
                 {
-                    const Vec3& testAxis = candidateAxes[idx];
-                    const float dist = Abs(Dot(d, testAxis));
-                    const float ra = ProjectedObbRadius(a.collider->halfExtents, axesA, testAxis);
-                    const float rb = ProjectedObbRadius(b.collider->halfExtents, axesB, testAxis);
-                    const float overlap = (ra + rb) - dist;
-                    if (overlap <= 0.0f)
-                    {
-                        separated = true;
-                        break;
-                    }
-                    if (overlap < minPen)
-                    {
-                        minPen = overlap;
-                        normal = (Dot(d, testAxis) >= 0.0f) ? testAxis : Scale(testAxis, -1.0f);
-                    }
-                }
-                if (separated)
+                    slot.lodPendingTime += dt;
+                    bodies.flags[i] |= kBodyFrozen;
                     continue;
-                axis = 1;
-                contactType = ContactType::BoxBox;
+                }
+                // The catch-up step is held to the update limit too; longer ones shake stacks.
+                bodyTimeScale[i] = std::max(std::min(slot.lodPendingTime + dt, kMaxUpdateTime), dt) / dt;
+                slot.lodPendingTime = 0.0f;
             }
-            else if (a.collider->type == ColliderType::Sphere && b.collider->type == ColliderType::Sphere)
+            else if (level == physics::LodLevel::Frozen)
             {
-                const float ra = SphereRadius(*a.collider);
-                const float rb = SphereRadius(*b.collider);
-                const float distSq = LengthSq(d);
-                const float radiusSum = ra + rb;
-                if (distSq >= radiusSum * radiusSum)
-                    continue;
-                const float distance = std::sqrt(std::max(distSq, 0.0f));
-                normal = (distance > 0.000001f) ? Scale(d, 1.0f / distance) : Vec3{ 1.0f, 0.0f, 0.0f };
-                minPen = radiusSum - distance;
-                contactType = ContactType::SphereSphere;
+                bodies.flags[i] |= kBodyFrozen;
             }
-            else
+        }
+    }
+    if (m_AdaptiveSubsteps)
+    {
+        // A body needs enough substeps to move at most a fraction of its size per substep.
+        // Bodies paired with another dynamic body keep the configured count: stacks and piles
+        // need the substeps to carry support through the contact chain. Pairs are refreshed
+        // first so proxies created or edited above count too.
+        updatePairs();
+        std::pmr::vector<std::uint8_t> nearDynamic(bodies.Size(), 0, &scratch);
+        for (const physics::BroadphasePair& pair : m_Broadphase.GetPairs())
+        {
+            std::size_t i = 0;
+            std::size_t j = 0;
+            if (!pairBodies(pair, i, j) || bodies.Has(i, kBodyStatic) || bodies.Has(j, kBodyStatic))
+                continue;
+            nearDynamic[i] = nearDynamic[j] = 1;
+        }
+        const int maxSubsteps = std::clamp(m_MaxSubsteps, 1, static_cast<int>(std::numeric_limits<std::uint16_t>::max()));
+        std::pmr::vector<std::uint16_t> bodySubsteps(bodies.Size(), 1, &scratch);
+        int stepCount = 1;
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            if (!bodies.IsAwakeDynamic(i))
+                continue;
+            const Vec3& half = bodies.halfExtents[i];
+            const float size = std::max(bodies.Has(i, kBodySphere) ? BodyRadius(bodies, i) : std::min(half.x, std::min(half.y, half.z)), 0.01f);
+            const float speed = Length(bodies.velocity[i]) +
+                (bodies.Has(i, kBodyGravity) ? gravity * dt : 0.0f) + Length(bodies.acceleration[i]) * dt;
+            // Bodies flagged for CCD are swept instead; their speed does not add substeps.
+            int needed = bodies.Has(i, kBodyContinuous) ? 1 : static_cast<int>(std::ceil(speed * dt / (kAdaptiveTravelFraction * size)));
+            if (nearDynamic[i])
+                needed = std::max(needed, substeps);
+            needed = std::clamp(needed, 1, maxSubsteps);
+            bodySubsteps[i] = static_cast<std::uint16_t>(needed);
+            stepCount = std::max(stepCount, needed);
+        }
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            bodyStride[i] = static_cast<std::uint16_t>(stepCount / bodySubsteps[i]);
+            if (stepCount != substeps)
+                bodies.damping[i] = std::pow(bodies.damping[i], static_cast<float>(substeps) / static_cast<float>(stepCount));
+        }
+        shareStrides();
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+            mixedStrides = mixedStrides || (bodies.IsAwakeDynamic(i) && bodyStride[i] > 1);
+        substeps = stepCount;
+        stepDt = dt / static_cast<float>(substeps);
+    }
+    // Reduced and Distant bodies step once, on the last substep. Contacts stop after the
+    // iterations of the more detailed of their two bodies; static bodies do not count.
+    std::pmr::vector<std::uint16_t> bodyIterations(&scratch);
+    const int reducedIterations = std::clamp(m_Lod.reducedSolverIterations, 1, solverIterations);
+    if (lodActive)
+    {
+        bodyIterations.assign(bodies.Size(), 0);
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            if (!bodies.IsAwakeDynamic(i))
+                continue;
+            if (bodyLod[i] == physics::LodLevel::Full)
             {
-                BodyRef* box = &a;
-                BodyRef* sphere = &b;
-                Vec3 boxCenter = ac;
-                Vec3 sphereCenter = bc;
-                Vec3 boxHalf = box->collider->halfExtents;
-                if (a.collider->type == ColliderType::Sphere)
-                {
-                    box = &b;
-                    sphere = &a;
-                    boxCenter = bc;
-                    sphereCenter = ac;
-                    boxHalf = box->collider->halfExtents;
-                }
-                const float radius = SphereRadius(*sphere->collider);
-                const BoxAxes axes = BuildBoxAxes(box->transform->rotation);
-                const Vec3 boxToSphere = Sub(sphereCenter, boxCenter);
-                const float localX = Dot(boxToSphere, axes.xAxis);
-                const float localY = Dot(boxToSphere, axes.yAxis);
-                const float localZ = Dot(boxToSphere, axes.zAxis);
-                const float clampedX = Clamp(localX, -boxHalf.x, boxHalf.x);
-                const float clampedY = Clamp(localY, -boxHalf.y, boxHalf.y);
-                const float clampedZ = Clamp(localZ, -boxHalf.z, boxHalf.z);
-                Vec3 closest = Add(
-                    Add(
-                        Add(boxCenter, Scale(axes.xAxis, clampedX)),
-                        Scale(axes.yAxis, clampedY)),
-                    Scale(axes.zAxis, clampedZ));
-                Vec3 delta = Sub(sphereCenter, closest);
-                const float distSq = LengthSq(delta);
-                if (distSq > radius * radius)
-                    continue;
-                const float distance = std::sqrt(std::max(distSq, 0.0f));
-                if (distance > 0.000001f)
-                {
-                    normal = NormalizeSafe(delta);
-                    minPen = radius - distance;
-                }
-                else
-                {
-                    const float px = boxHalf.x - Abs(localX);
-                    const float py = boxHalf.y - Abs(localY);
-                    const float pz = boxHalf.z - Abs(localZ);
-                    minPen = std::max(0.0f, radius + std::min(px, std::min(py, pz)));
-                    if (px <= py && px <= pz) normal = Scale(axes.xAxis, (localX >= 0.0f) ? 1.0f : -1.0f);
-                    else if (py <= pz) normal = Scale(axes.yAxis, (localY >= 0.0f) ? 1.0f : -1.0f);
-                    else normal = Scale(axes.zAxis, (localZ >= 0.0f) ? 1.0f : -1.0f);
-                }
-                if (a.collider->type == ColliderType::Sphere)
-                    normal = Scale(normal, -1.0f);
-                contactType = ContactType::BoxSphere;
+                bodyIterations[i] = static_cast<std::uint16_t>(solverIterations);
+                continue;
             }
+            bodyIterations[i] = static_cast<std::uint16_t>(reducedIterations);
+            bodyStride[i] = static_cast<std::uint16_t>(substeps);
+        }
+        mixedStrides = true;
+    }
+    const auto contactIterations = [&](const physics::ContactManifold& contact)
+    {
+        return std::max<int>(std::max(bodyIterations[contact.bodyA], bodyIterations[contact.bodyB]), 1);
+    };
+    const auto stepDtOf = [&](std::size_t body) { return stepDt * static_cast<float>(stepSpan[body]) * bodyTimeScale[body]; };
+    m_StepStats.substeps = static_cast<std::uint32_t>(substeps);
+    clock.Lap(PhysicsPhase::Sync);
 
-            Vec3 sep = Scale(normal, minPen);
-            if (minPen <= 0.0f)
-                continue;
+    std::pmr::vector<std::pair<std::size_t, std::size_t>> candidatePairs(&scratch);
+    std::pmr::vector<std::pair<std::size_t, Vec3>> ccdStops(&scratch);
+    std::pmr::vector<std::pair<std::size_t, float>> ccdHits(&scratch);
 
-            const float invMassA = (a.rigidbody->isStatic || a.rigidbody->mass <= 0.0001f) ? 0.0f : (1.0f / a.rigidbody->mass);
-            const float invMassB = (b.rigidbody->isStatic || b.rigidbody->mass <= 0.0001f) ? 0.0f : (1.0f / b.rigidbody->mass);
-            const float invMassSum = invMassA + invMassB;
-            if (invMassSum <= 0.0f)
+    for (int step = 0; step < substeps; ++step)
+    {
+    // Pairs found in the last substep may join groups of different strides.
+    if (mixedStrides && step > 0)
+        shareStrides();
+    const auto stepsDone = static_cast<std::uint16_t>(step + 1);
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+    {
+        stepSpan[i] = 0;
+        if (!bodies.IsAwakeDynamic(i))
+        {
+            bodyStepsDone[i] = stepsDone;
+            continue;
+        }
+        if (stepsDone % bodyStride[i] != 0 && step + 1 != substeps)
+            continue;
+        stepSpan[i] = static_cast<std::uint16_t>(stepsDone - bodyStepsDone[i]);
+        bodyStepsDone[i] = stepsDone;
+        ++m_StepStats.bodySteps;
+    }
+
+    // Forces first; positions only advance after contacts have constrained the velocities.
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+    {
+        if (stepSpan[i] == 0)
+            continue;
+        const float steps = static_cast<float>(stepSpan[i]) * bodyTimeScale[i];
+        const float damping = steps == 1.0f ? bodies.damping[i] : std::pow(bodies.damping[i], steps);
+        bodies.velocity[i] = IntegrateVelocity(
+            bodies.velocity[i], bodies.acceleration[i], bodies.Has(i, kBodyGravity), gravity, damping, stepDtOf(i));
+    }
+
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+    {
+        if (bodyProxies[i] == physics::kNullProxy || stepSpan[i] == 0)
+            continue;
+        (void)m_Broadphase.MoveProxy(bodyProxies[i], ComputeBodyAabb(bodies, i), Scale(bodies.velocity[i], stepDtOf(i)));
+    }
+    updatePairs();
+    m_StepStats.broadphasePairs += m_Broadphase.GetPairs().size();
+
+    candidatePairs.clear();
+    candidatePairs.reserve(m_Broadphase.GetPairs().size());
+    for (const physics::BroadphasePair& pair : m_Broadphase.GetPairs())
+    {
+        const std::size_t i = m_Broadphase.GetUserData(pair.a);
+        const std::size_t j = m_Broadphase.GetUserData(pair.b);
+        // Pairs without a body that steps in this substep cannot change.
+        if (stepSpan[i] == 0 && stepSpan[j] == 0)
+            continue;
+        candidatePairs.emplace_back(std::min(i, j), std::max(i, j));
+    }
+    m_StepStats.pairsTested += candidatePairs.size();
+    clock.Lap(PhysicsPhase::Broadphase);
+
+    // Contact generation runs once per substep, split into fixed-size chunks across the job
+    // pool; chunk outputs are concatenated in chunk order so results never depend on threads.
+    const std::size_t chunkCount = (candidatePairs.size() + kNarrowphaseGrain - 1) / kNarrowphaseGrain;
+    if (m_ContactChunks.size() < chunkCount)
+    {
+        m_ContactChunks.resize(chunkCount);
+        m_ContactChunkTests.resize(chunkCount);
+    }
+    JobSystem::Get().ParallelFor(candidatePairs.size(), kNarrowphaseGrain, [&](std::size_t begin, std::size_t end)
+    {
+        AllocationScope chunkScope(AllocationTag::Physics, "PhysicsSystem::Narrowphase");
+        std::vector<physics::ContactManifold>& chunk = m_ContactChunks[begin / kNarrowphaseGrain];
+        chunk.clear();
+        std::array<std::uint32_t, physics::kContactTypeCount>& tests = m_ContactChunkTests[begin / kNarrowphaseGrain];
+        tests.fill(0);
+        GenerateContacts(bodies, candidatePairs.data() + begin, end - begin, chunk, tests);
+    });
+    m_Contacts.clear();
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        m_Contacts.insert(m_Contacts.end(), m_ContactChunks[chunk].begin(), m_ContactChunks[chunk].end());
+        for (std::size_t type = 0; type < physics::kContactTypeCount; ++type)
+            m_StepStats.narrowphaseTests[type] += m_ContactChunkTests[chunk][type];
+    }
+    for (const physics::ContactManifold& contact : m_Contacts)
+    {
+        const Entity a = bodies.entity[contact.bodyA];
+        const Entity b = bodies.entity[contact.bodyB];
+        m_FrameTouchingPairs.push_back(a.index < b.index
+            ? TouchingPair{ contact.pairKey, a, b }
+            : TouchingPair{ contact.pairKey, b, a });
+    }
+
+    // Touching an awake body wakes a sleeping island; it joins the solve from here on.
+    for (const physics::ContactManifold& contact : m_Contacts)
+    {
+        for (const std::uint32_t bodyIndex : { contact.bodyA, contact.bodyB })
+        {
+            if (bodies.Has(bodyIndex, kBodySleeping))
+                wakeIslands.push_back(m_ProxySlots[bodies.entity[bodyIndex].index].sleepIsland);
+        }
+    }
+    if (!wakeIslands.empty())
+    {
+        wakeMarkedIslands();
+        // Woken bodies step from here on, at the full rate.
+        for (std::size_t i = 0; i < bodies.Size(); ++i)
+        {
+            if (stepSpan[i] != 0 || bodyStepsDone[i] != stepsDone || !bodies.IsAwakeDynamic(i))
                 continue;
+            stepSpan[i] = 1;
+            bodyStride[i] = 1;
+            ++m_StepStats.bodySteps;
+        }
+    }
+    m_StepStats.contacts += m_Contacts.size();
+    clock.Lap(PhysicsPhase::Narrowphase);
+
+    // Sequential impulses on velocities, warm-started with the impulses the same pair and
+    // feature accumulated last substep; resting stacks then start close to their solution.
+    m_StepStats.warmStartedContacts += m_ContactCache.WarmStart(m_Contacts);
+    for (physics::ContactManifold& contact : m_Contacts)
+    {
+        const std::size_t a = contact.bodyA;
+        const std::size_t b = contact.bodyB;
+        contact.invMassA = bodies.invMass[a];
+        contact.invMassB = bodies.invMass[b];
+        contact.friction = (bodies.friction[a] + bodies.friction[b]) > 0.0f
+            ? (bodies.friction[a] + bodies.friction[b]) * 0.5f
+            : m_DefaultFriction;
+        if (contact.type == ContactType::BoxSphere)
+            contact.friction *= 0.18f;
+        const float restitution = (bodies.restitution[a] + bodies.restitution[b]) > 0.0f
+            ? (bodies.restitution[a] + bodies.restitution[b]) * 0.5f
+            : m_DefaultRestitution;
+        const float approachSpeed = -Dot(Sub(bodies.velocity[a], bodies.velocity[b]), contact.normal);
+        contact.velocityBias = approachSpeed > kRestitutionVelocityThreshold ? restitution * approachSpeed : 0.0f;
+
+        contact.tangentImpulse = Sub(contact.tangentImpulse, Scale(contact.normal, Dot(contact.tangentImpulse, contact.normal)));
+        ApplyContactImpulse(contact, bodies.velocity.data(), Add(Scale(contact.normal, contact.normalImpulse), contact.tangentImpulse));
+    }
+
+    // Greedy graph coloring: no two contacts of one color write the same body (static bodies
+    // are never written), so a color's contacts solve in parallel and the result does not depend
+    // on the thread count. Contacts that find no free color go to a last, serial batch.
+    std::pmr::vector<std::uint32_t> bodyColorMasks(bodies.Size(), 0, &scratch);
+    std::pmr::vector<std::uint8_t> contactColors(m_Contacts.size(), 0, &scratch);
+    m_ContactColorOffsets.assign(kContactColorCount + 1, 0);
+    for (std::size_t index = 0; index < m_Contacts.size(); ++index)
+    {
+        const physics::ContactManifold& contact = m_Contacts[index];
+        const bool writesA = !bodies.Has(contact.bodyA, kBodyStatic);
+        const bool writesB = !bodies.Has(contact.bodyB, kBodyStatic);
+        const std::uint32_t used =
+            (writesA ? bodyColorMasks[contact.bodyA] : 0u) | (writesB ? bodyColorMasks[contact.bodyB] : 0u);
+        const std::uint32_t color = std::min<std::uint32_t>(
+            static_cast<std::uint32_t>(std::countr_one(used)), kOverflowContactColor);
+        if (color != kOverflowContactColor)
+        {
+            if (writesA)
+                bodyColorMasks[contact.bodyA] |= 1u << color;
+            if (writesB)
+                bodyColorMasks[contact.bodyB] |= 1u << color;
+        }
+        contactColors[index] = static_cast<std::uint8_t>(color);
+        ++m_ContactColorOffsets[color + 1];
+    }
+    for (std::size_t color = 0; color < kContactColorCount; ++color)
+        m_ContactColorOffsets[color + 1] += m_ContactColorOffsets[color];
+    m_ColoredContacts.resize(m_Contacts.size());
+    {
+        std::pmr::vector<std::uint32_t> cursor(m_ContactColorOffsets.begin(), m_ContactColorOffsets.end() - 1, &scratch);
+        for (std::size_t index = 0; index < m_Contacts.size(); ++index)
+            m_ColoredContacts[cursor[contactColors[index]]++] = m_Contacts[index];
+    }
+    m_Contacts.swap(m_ColoredContacts);
 
-            const bool singleStaticContact = (invMassA == 0.0f) != (invMassB == 0.0f);
-            const bool dynamicBoxSphere = (contactType == ContactType::BoxSphere) && !singleStaticContact;
-            const float slop = dynamicBoxSphere ? 0.0f : (singleStaticContact ? 0.0005f : 0.0025f);
-            const float percent = dynamicBoxSphere ? m_DynamicBoxSphereCorrectionPercent : (singleStaticContact ? 0.9f : 0.65f);
-            const float correctionScale = std::max(minPen - slop, 0.0f) * percent / invMassSum;
-            const Vec3 correction = Scale(sep, correctionScale / (minPen > 0.0f ? minPen : 1.0f));
-            if (invMassA > 0.0f)
-                a.transform->position = Add(a.transform->position, Scale(correction, invMassA));
-            if (invMassB > 0.0f)
-                b.transform->position = Sub(b.transform->position, Scale(correction, invMassB));
-
-            // Extra depenetration for dynamic box-sphere contacts to avoid
-            // persistent interpenetration ("sphere absorbing cubes").
-            if (dynamicBoxSphere)
+    const auto forEachContactColor = [&](auto&& solveRange)
+    {
+        for (std::size_t color = 0; color < kContactColorCount; ++color)
+        {
+            const std::size_t begin = m_ContactColorOffsets[color];
+            const std::size_t end = m_ContactColorOffsets[color + 1];
+            if (color == kOverflowContactColor)
             {
-                BodyRef* sphereBody = (a.collider->type == ColliderType::Sphere) ? &a : &b;
-                BodyRef* boxBody = (a.collider->type == ColliderType::Box) ? &a : &b;
-                if (sphereBody->rigidbody->useAdvancedSphereStabilization)
-                {
-                    const float radius = SphereRadius(*sphereBody->collider);
-                    const Vec3 boxCenter = Add(boxBody->transform->position, boxBody->collider->offset);
-                    const BoxAxes boxAxes = BuildBoxAxes(boxBody->transform->rotation);
-                    const Vec3 sphereCenter = Add(sphereBody->transform->position, sphereBody->collider->offset);
-                    const Vec3 toSphere = Sub(sphereCenter, boxCenter);
-                    const float lx = Dot(toSphere, boxAxes.xAxis);
-                    const float ly = Dot(toSphere, boxAxes.yAxis);
-                    const float lz = Dot(toSphere, boxAxes.zAxis);
-                    const Vec3 half = boxBody->collider->halfExtents;
-                    const float clx = Clamp(lx, -half.x, half.x);
-                    const float cly = Clamp(ly, -half.y, half.y);
-                    const float clz = Clamp(lz, -half.z, half.z);
-                    const Vec3 closestPoint = Add(Add(Add(boxCenter, Scale(boxAxes.xAxis, clx)), Scale(boxAxes.yAxis, cly)), Scale(boxAxes.zAxis, clz));
-                    const Vec3 delta = Sub(sphereCenter, closestPoint);
-                    const float distSq = LengthSq(delta);
-                    if (distSq < radius * radius)
-                    {
-                        const float distance = std::sqrt(std::max(distSq, 0.0f));
-                        const Vec3 outNormal = (distance > 0.000001f) ? Scale(delta, 1.0f / distance) : normal;
-                        const float extraPen = radius - distance + 0.001f;
-                        // For gameplay feel, do not "catapult" nearby cubes by splitting
-                        // dynamic box-sphere extra depenetration. Move sphere only.
-                        const float moveSphere = 1.0f;
-                        const float moveBox = 0.0f;
-                        if (!sphereBody->rigidbody->isStatic)
-                            sphereBody->transform->position = Add(sphereBody->transform->position, Scale(outNormal, extraPen * moveSphere));
-                        if (!boxBody->rigidbody->isStatic)
-                            boxBody->transform->position = Sub(boxBody->transform->position, Scale(outNormal, extraPen * moveBox));
-                    }
-                }
+                solveRange(begin, end);
+                continue;
             }
+            JobSystem::Get().ParallelFor(end - begin, kSolverGrain, [&](std::size_t chunkBegin, std::size_t chunkEnd)
+            {
+                solveRange(begin + chunkBegin, begin + chunkEnd);
+            });
+        }
+    };
 
-            // Keep dynamic spheres on the surface of static boxes to avoid deep embedding
-            // on sloped ramps when frame time spikes.
-            if (contactType == ContactType::BoxSphere && singleStaticContact)
+    for (int iter = 0; iter < solverIterations; ++iter)
+    {
+        forEachContactColor([&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t index = begin; index < end; ++index)
             {
-                BodyRef* sphereBody = (a.collider->type == ColliderType::Sphere) ? &a : &b;
-                BodyRef* boxBody = (a.collider->type == ColliderType::Box) ? &a : &b;
-                if ((sphereBody->rigidbody->mass > 0.0f) && !sphereBody->rigidbody->isStatic)
-                {
-                    const float radius = SphereRadius(*sphereBody->collider);
-                    const float skin = 0.002f;
-                    const Vec3 boxCenter = Add(boxBody->transform->position, boxBody->collider->offset);
-                    const BoxAxes boxAxes = BuildBoxAxes(boxBody->transform->rotation);
-                    const Vec3 sphereCenter = Add(sphereBody->transform->position, sphereBody->collider->offset);
-                    const Vec3 toSphere = Sub(sphereCenter, boxCenter);
-                    const float lx = Dot(toSphere, boxAxes.xAxis);
-                    const float ly = Dot(toSphere, boxAxes.yAxis);
-                    const float lz = Dot(toSphere, boxAxes.zAxis);
-                    const Vec3 half = boxBody->collider->halfExtents;
-                    const float clx = Clamp(lx, -half.x, half.x);
-                    const float cly = Clamp(ly, -half.y, half.y);
-                    const float clz = Clamp(lz, -half.z, half.z);
-                    const Vec3 closestPoint = Add(Add(Add(boxCenter, Scale(boxAxes.xAxis, clx)), Scale(boxAxes.yAxis, cly)), Scale(boxAxes.zAxis, clz));
-                    const Vec3 snappedCenter = Add(closestPoint, Scale(normal, radius + skin));
-                    sphereBody->transform->position = Sub(snappedCenter, sphereBody->collider->offset);
-                }
+                if (lodActive && iter >= contactIterations(m_Contacts[index]))
+                    continue;
+                SolveContactVelocity(m_Contacts[index], bodies.velocity.data());
             }
+        });
+    }
+    if (lodActive)
+    {
+        for (const physics::ContactManifold& contact : m_Contacts)
+            m_StepStats.contactSolves += static_cast<std::uint64_t>(std::min(contactIterations(contact), solverIterations));
+    }
+    else
+    {
+        m_StepStats.contactSolves += static_cast<std::uint64_t>(m_Contacts.size()) * static_cast<std::uint64_t>(solverIterations);
+    }
+    if (mixedStrides)
+    {
+        // Pairs whose awake bodies skipped this substep keep their impulses for their next step.
+        const auto skippedBody = [&](std::uint32_t entityIndex, bool& awake)
+        {
+            if (entityIndex >= m_ProxySlots.size() || m_ProxySlots[entityIndex].proxy == physics::kNullProxy)
+                return false;
+            const physics::ProxyId proxy = m_ProxySlots[entityIndex].proxy;
+            const std::size_t body = m_Broadphase.GetUserData(proxy);
+            if (body >= bodies.Size() || bodyProxies[body] != proxy || stepSpan[body] != 0)
+                return false;
+            awake = awake || bodies.IsAwakeDynamic(body) || bodies.Has(body, kBodyFrozen);
+            return true;
+        };
+        m_ContactCache.Store(m_Contacts, [&](const physics::ContactCache::Entry& entry)
+        {
+            bool awake = false;
+            return skippedBody(static_cast<std::uint32_t>(entry.pairKey >> 32), awake) &&
+                skippedBody(static_cast<std::uint32_t>(entry.pairKey), awake) && awake;
+        });
+    }
+    else
+    {
+        m_ContactCache.Store(m_Contacts);
+    }
+    clock.Lap(PhysicsPhase::Solver);
+
+    // Continuous collision: a flagged body that would move further than a fraction of its size
+    // is swept against both broadphase trees and stops at its first time of impact, just inside
+    // the obstacle, so the next substep's narrowphase and solver take over. The dynamic tree is
+    // queried with the sweep grown by the largest motion of any stepping body, so a moving
+    // obstacle outside the sweep at the start of the step is still found; impacts are computed
+    // on relative motion and both bodies stop at that fraction of their own motion.
+    ccdStops.clear();
+    ccdHits.clear();
+    std::uint32_t ccdHitBodies = 0;
+    bool maxMotionKnown = false;
+    Vec3 maxMotion{};
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+    {
+        if (!bodies.Has(i, kBodyContinuous) || bodyProxies[i] == physics::kNullProxy || stepSpan[i] == 0)
+            continue;
+        const Vec3 motion = Scale(bodies.velocity[i], stepDtOf(i));
+        const Vec3& half = bodies.halfExtents[i];
+        const float size = bodies.Has(i, kBodySphere) ? BodyRadius(bodies, i) : std::min(half.x, std::min(half.y, half.z));
+        if (LengthSq(motion) <= (kCcdMotionThreshold * size) * (kCcdMotionThreshold * size))
+            continue;
+        ++m_StepStats.ccdSweeps;
 
-            const float restitution = (a.collider->restitution + b.collider->restitution) > 0.0f
-                ? (a.collider->restitution + b.collider->restitution) * 0.5f
-                : m_DefaultRestitution;
-            float friction = (a.collider->friction + b.collider->friction) > 0.0f
-                ? (a.collider->friction + b.collider->friction) * 0.5f
-                : m_DefaultFriction;
-            if (contactType == ContactType::BoxSphere)
-                friction *= 0.18f;
-            const Vec3 rv = Sub(a.rigidbody->velocity, b.rigidbody->velocity);
-            const float velAlongNormal = Dot(rv, normal);
-            if (velAlongNormal < 0.0f)
+        if (!maxMotionKnown)
+        {
+            for (std::size_t j = 0; j < bodies.Size(); ++j)
             {
-                const float j = -(1.0f + restitution) * velAlongNormal / invMassSum;
-                const Vec3 impulse = Scale(normal, j);
-                if (invMassA > 0.0f)
-                    a.rigidbody->velocity = Add(a.rigidbody->velocity, Scale(impulse, invMassA));
-                if (invMassB > 0.0f)
-                    b.rigidbody->velocity = Sub(b.rigidbody->velocity, Scale(impulse, invMassB));
+                if (stepSpan[j] == 0)
+                    continue;
+                const Vec3 bodyMotion = Scale(bodies.velocity[j], stepDtOf(j));
+                maxMotion = Vec3{ std::max(maxMotion.x, Abs(bodyMotion.x)), std::max(maxMotion.y, Abs(bodyMotion.y)), std::max(maxMotion.z, Abs(bodyMotion.z)) };
             }
+            maxMotionKnown = true;
+        }
 
-            const Vec3 rvAfter = Sub(a.rigidbody->velocity, b.rigidbody->velocity);
-            Vec3 tangent = Sub(rvAfter, Scale(normal, Dot(rvAfter, normal)));
-            const float tangentLenSq = Dot(tangent, tangent);
-            if (tangentLenSq > 0.000001f)
+        const physics::Aabb start = ComputeBodyAabb(bodies, i);
+        const physics::Aabb swept{
+            Vec3{ std::min(start.min.x, start.min.x + motion.x), std::min(start.min.y, start.min.y + motion.y), std::min(start.min.z, start.min.z + motion.z) },
+            Vec3{ std::max(start.max.x, start.max.x + motion.x), std::max(start.max.y, start.max.y + motion.y), std::max(start.max.z, start.max.z + motion.z) } };
+        float fraction = 1.0f;
+        std::size_t hitBody = i;
+        const auto sweepAgainst = [&](std::uint32_t proxy)
+        {
+            const std::size_t other = m_Broadphase.GetUserData(static_cast<physics::ProxyId>(proxy));
+            if (other == i || !CanCollide(bodies, i, other) || !m_Broadphase.ShouldCollide(bodyProxies[i], static_cast<physics::ProxyId>(proxy)))
+                return;
+            const Vec3 otherMotion = stepSpan[other] != 0 ? Scale(bodies.velocity[other], stepDtOf(other)) : Vec3{};
+            float hit = 1.0f;
+            if (ComputeBodyTimeOfImpact(bodies, i, other, Sub(motion, otherMotion), kCcdTargetDepth, hit) && hit < fraction)
             {
-                const float invTangentLen = 1.0f / std::sqrt(tangentLenSq);
-                tangent = Scale(tangent, invTangentLen);
-                const float jt = -Dot(rvAfter, tangent) / invMassSum;
-                const float normalImpulseMag = std::max(-(1.0f + restitution) * velAlongNormal / invMassSum, 0.0f);
-                const float maxFriction = friction * normalImpulseMag;
-                const float clampedJt = std::max(-maxFriction, std::min(jt, maxFriction));
-                const Vec3 frictionImpulse = Scale(tangent, clampedJt);
-                if (invMassA > 0.0f)
-                    a.rigidbody->velocity = Add(a.rigidbody->velocity, Scale(frictionImpulse, invMassA));
-                if (invMassB > 0.0f)
-                    b.rigidbody->velocity = Sub(b.rigidbody->velocity, Scale(frictionImpulse, invMassB));
+                fraction = hit;
+                hitBody = other;
             }
+        };
+        m_Broadphase.GetStaticTree().Query(swept, sweepAgainst);
+        m_Broadphase.GetDynamicTree().Query(physics::Aabb{ Sub(swept.min, maxMotion), Add(swept.max, maxMotion) }, sweepAgainst);
+        if (fraction < 1.0f)
+        {
+            ++ccdHitBodies;
+            ccdHits.emplace_back(i, fraction);
+            if (stepSpan[hitBody] != 0 && !bodies.Has(hitBody, kBodyStatic))
+                ccdHits.emplace_back(hitBody, fraction);
+        }
+    }
+    // A body stopped by several sweeps keeps the earliest impact.
+    std::sort(ccdHits.begin(), ccdHits.end());
+    for (std::size_t h = 0; h < ccdHits.size(); ++h)
+    {
+        const auto [bodyIndex, fraction] = ccdHits[h];
+        if (h > 0 && ccdHits[h - 1].first == bodyIndex)
+            continue;
+        ccdStops.emplace_back(bodyIndex, Add(bodies.position[bodyIndex], Scale(Scale(bodies.velocity[bodyIndex], stepDtOf(bodyIndex)), fraction)));
+    }
+
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+    {
+        if (stepSpan[i] != 0)
+            bodies.position[i] = Add(bodies.position[i], Scale(bodies.velocity[i], stepDtOf(i)));
+    }
+    for (const auto& [bodyIndex, position] : ccdStops)
+        bodies.position[bodyIndex] = position;
+    m_StepStats.ccdHits += ccdHitBodies;
+    clock.Lap(PhysicsPhase::Continuous);
+
+    // Position pass: push remaining penetration out without touching velocities.
+    const auto solveContactPosition = [&](const physics::ContactManifold& contact, int iter)
+    {
+        const std::size_t a = contact.bodyA;
+        const std::size_t b = contact.bodyB;
+        // The first pass advances the parallel result by the step's relative motion; later
+        // passes refresh the geometry after earlier corrections, only for touching pairs.
+        physics::ContactManifold current = contact;
+        if (iter == 0 && (m_AdaptiveSubsteps || lodActive))
+            current.depth -= Dot(Sub(Scale(bodies.velocity[a], stepDtOf(a)), Scale(bodies.velocity[b], stepDtOf(b))), current.normal);
+        else if (iter == 0)
+            current.depth -= Dot(Sub(bodies.velocity[a], bodies.velocity[b]), current.normal) * stepDt;
+        else if (!GenerateContact(bodies, a, b, current))
+            return;
+        const ContactType contactType = current.type;
+        const Vec3& normal = current.normal;
+        const float minPen = current.depth;
+        Vec3 sep = Scale(normal, minPen);
+        if (minPen <= 0.0f)
+            return;
 
-            if (invMassA > 0.0f && invMassB == 0.0f)
+        const float invMassA = contact.invMassA;
+        const float invMassB = contact.invMassB;
+        const float invMassSum = invMassA + invMassB;
+        if (invMassSum <= 0.0f)
+            return;
+
+        const bool singleStaticContact = (invMassA == 0.0f) != (invMassB == 0.0f);
+        const bool dynamicBoxSphere = (contactType == ContactType::BoxSphere) && !singleStaticContact;
+        const float slop = dynamicBoxSphere ? 0.0f : (singleStaticContact ? 0.0005f : 0.0025f);
+        const float percent = dynamicBoxSphere ? m_DynamicBoxSphereCorrectionPercent : (singleStaticContact ? 0.9f : 0.65f);
+        const float correctionScale = std::max(minPen - slop, 0.0f) * percent / invMassSum;
+        const Vec3 correction = Scale(sep, correctionScale / (minPen > 0.0f ? minPen : 1.0f));
+        if (invMassA > 0.0f)
+            bodies.position[a] = Add(bodies.position[a], Scale(correction, invMassA));
+        if (invMassB > 0.0f)
+            bodies.position[b] = Sub(bodies.position[b], Scale(correction, invMassB));
+
+        const std::size_t sphereBody = bodies.Has(a, kBodySphere) ? a : b;
+        const std::size_t boxBody = bodies.Has(a, kBodySphere) ? b : a;
+
+        // Extra depenetration for dynamic box-sphere contacts to avoid
+        // persistent interpenetration ("sphere absorbing cubes").
+        if (dynamicBoxSphere)
+        {
+            const Vec3 boxToSphere = (sphereBody == a) ? normal : Scale(normal, -1.0f);
+            if (bodies.Has(sphereBody, kBodySphereStabilization))
             {
-                const float vnA = Dot(a.rigidbody->velocity, normal);
-                if (vnA < 0.0f)
-                    a.rigidbody->velocity = Sub(a.rigidbody->velocity, Scale(normal, vnA));
+                const float radius = BodyRadius(bodies, sphereBody);
+                const Vec3 boxCenter = ColliderCenter(bodies, boxBody);
+                const BoxAxes& boxAxes = bodies.axes[boxBody];
+                const Vec3 sphereCenter = ColliderCenter(bodies, sphereBody);
+                const Vec3 toSphere = Sub(sphereCenter, boxCenter);
+                const float lx = Dot(toSphere, boxAxes.xAxis);
+                const float ly = Dot(toSphere, boxAxes.yAxis);
+                const float lz = Dot(toSphere, boxAxes.zAxis);
+                const Vec3 half = bodies.halfExtents[boxBody];
+                const float clx = Clamp(lx, -half.x, half.x);
+                const float cly = Clamp(ly, -half.y, half.y);
+                const float clz = Clamp(lz, -half.z, half.z);
+                const Vec3 closestPoint = Add(Add(Add(boxCenter, Scale(boxAxes.xAxis, clx)), Scale(boxAxes.yAxis, cly)), Scale(boxAxes.zAxis, clz));
+                const Vec3 delta = Sub(sphereCenter, closestPoint);
+                const float distSq = LengthSq(delta);
+                if (distSq < radius * radius)
+                {
+                    const float distance = std::sqrt(std::max(distSq, 0.0f));
+                    const Vec3 outNormal = (distance > 0.000001f) ? Scale(delta, 1.0f / distance) : boxToSphere;
+                    const float extraPen = radius - distance + 0.001f;
+                    // For gameplay feel, do not "catapult" nearby cubes by splitting
+                    // dynamic box-sphere extra depenetration. Move sphere only.
+                    const float moveSphere = 1.0f;
+                    const float moveBox = 0.0f;
+                    if (!bodies.Has(sphereBody, kBodyStatic))
+                        bodies.position[sphereBody] = Add(bodies.position[sphereBody], Scale(outNormal, extraPen * moveSphere));
+                    if (!bodies.Has(boxBody, kBodyStatic))
+                        bodies.position[boxBody] = Sub(bodies.position[boxBody], Scale(outNormal, extraPen * moveBox));
+                }
             }
-            else if (invMassB > 0.0f && invMassA == 0.0f)
+        }
+
+        // Keep dynamic spheres on the surface of static boxes to avoid deep embedding
+        // on sloped ramps when frame time spikes.
+        if (contactType == ContactType::BoxSphere && singleStaticContact)
+        {
+            if (bodies.Has(sphereBody, kBodyHasMass) && !bodies.Has(sphereBody, kBodyStatic))
             {
-                const float vnB = Dot(b.rigidbody->velocity, normal);
-                if (vnB > 0.0f)
-                    b.rigidbody->velocity = Sub(b.rigidbody->velocity, Scale(normal, vnB));
+                const float radius = BodyRadius(bodies, sphereBody);
+                const float skin = 0.002f;
+                const Vec3 boxCenter = ColliderCenter(bodies, boxBody);
+                const BoxAxes& boxAxes = bodies.axes[boxBody];
+                const Vec3 sphereCenter = ColliderCenter(bodies, sphereBody);
+                const Vec3 toSphere = Sub(sphereCenter, boxCenter);
+                const float lx = Dot(toSphere, boxAxes.xAxis);
+                const float ly = Dot(toSphere, boxAxes.yAxis);
+                const float lz = Dot(toSphere, boxAxes.zAxis);
+                const Vec3 half = bodies.halfExtents[boxBody];
+                const float clx = Clamp(lx, -half.x, half.x);
+                const float cly = Clamp(ly, -half.y, half.y);
+                const float clz = Clamp(lz, -half.z, half.z);
+                const Vec3 closestPoint = Add(Add(Add(boxCenter, Scale(boxAxes.xAxis, clx)), Scale(boxAxes.yAxis, cly)), Scale(boxAxes.zAxis, clz));
+                const Vec3 boxToSphere = (sphereBody == a) ? normal : Scale(normal, -1.0f);
+                const Vec3 snappedCenter = Add(closestPoint, Scale(boxToSphere, radius + skin));
+                bodies.position[sphereBody] = Sub(snappedCenter, bodies.offset[sphereBody]);
             }
+        }
 
-            // Simple center-of-mass support check for tower-like tipping:
-            // when an object stands on another and its projected center leaves support footprint,
-            // add lateral velocity so it starts falling off the edge.
-            if (contactType == ContactType::BoxBox && axis == 1)
-            {
-                BodyRef* top = nullptr;
-                BodyRef* bottom = nullptr;
-                Vec3 topHalf{};
-                Vec3 bottomHalf{};
-                if (a.transform->position.y >= b.transform->position.y)
-                {
-                    top = &a; bottom = &b; topHalf = aHalf; bottomHalf = bHalf;
-                }
-                else
-                {
-                    top = &b; bottom = &a; topHalf = bHalf; bottomHalf = aHalf;
-                }
+        // Simple center-of-mass support check for tower-like tipping:
+        // when an object stands on another and its projected center leaves support footprint,
+        // add lateral velocity so it starts falling off the edge.
+        if (contactType == ContactType::BoxBox)
+        {
+            const Vec3 aHalf = RotatedAabbHalfExtents(bodies.halfExtents[a], bodies.axes[a]);
+            const Vec3 bHalf = RotatedAabbHalfExtents(bodies.halfExtents[b], bodies.axes[b]);
+            const bool aOnTop = bodies.position[a].y >= bodies.position[b].y;
+            const std::size_t top = aOnTop ? a : b;
+            const std::size_t bottom = aOnTop ? b : a;
+            const Vec3 topHalf = aOnTop ? aHalf : bHalf;
+            const Vec3 bottomHalf = aOnTop ? bHalf : aHalf;
 
-                if (!top->rigidbody->isStatic && top->rigidbody->simulatePhysics)
-                {
-                    const Vec3 topCenter = Add(top->transform->position, top->collider->offset);
-                    const Vec3 bottomCenter = Add(bottom->transform->position, bottom->collider->offset);
-                    const float dx = topCenter.x - bottomCenter.x;
-                    const float dz = topCenter.z - bottomCenter.z;
-                    const float supportMarginX = std::max(bottomHalf.x - topHalf.x * 0.5f, 0.0f);
-                    const float supportMarginZ = std::max(bottomHalf.z - topHalf.z * 0.5f, 0.0f);
-                    const float overhangX = Abs(dx) - supportMarginX;
-                    const float overhangZ = Abs(dz) - supportMarginZ;
-                    const float tipStrength = 2.25f;
-                    if (overhangX > 0.0f)
-                        top->rigidbody->velocity.x += Sign(dx) * std::min(overhangX * tipStrength, 4.0f) * stepDt;
-                    if (overhangZ > 0.0f)
-                        top->rigidbody->velocity.z += Sign(dz) * std::min(overhangZ * tipStrength, 4.0f) * stepDt;
-                }
+            if (!bodies.Has(top, kBodyStatic) && bodies.Has(top, kBodySimulated))
+            {
+                const Vec3 topCenter = ColliderCenter(bodies, top);
+                const Vec3 bottomCenter = ColliderCenter(bodies, bottom);
+                const float dx = topCenter.x - bottomCenter.x;
+                const float dz = topCenter.z - bottomCenter.z;
+                const float supportMarginX = std::max(bottomHalf.x - topHalf.x * 0.5f, 0.0f);
+                const float supportMarginZ = std::max(bottomHalf.z - topHalf.z * 0.5f, 0.0f);
+                const float overhangX = Abs(dx) - supportMarginX;
+                const float overhangZ = Abs(dz) - supportMarginZ;
+                const float tipStrength = 2.25f;
+                const float tipDt = stepDt * std::max(static_cast<float>(stepSpan[top]), 1.0f) * bodyTimeScale[top];
+                if (overhangX > 0.0f)
+                    bodies.velocity[top].x += Sign(dx) * std::min(overhangX * tipStrength, 4.0f) * tipDt;
+                if (overhangZ > 0.0f)
+                    bodies.velocity[top].z += Sign(dz) * std::min(overhangZ * tipStrength, 4.0f) * tipDt;
             }
-            if (m_EventBus) m_EventBus->PublishCollision(CollisionEvent{ a.entity, b.entity });
-    }}
+        }
+    };
+    for (int iter = 0; iter < solverIterations; ++iter)
+    {
+        forEachContactColor([&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t index = begin; index < end; ++index)
+            {
+                if (lodActive && iter >= contactIterations(m_Contacts[index]))
+                    continue;
+                solveContactPosition(m_Contacts[index], iter);
+            }
+        });
+    }
+    clock.Lap(PhysicsPhase::PositionSolve);
     }
 
     // Post-solve sphere stabilization against static boxes:
     // keeps dynamic spheres from slowly sinking through support surfaces
     // and limits extreme push velocities from dense cube impacts.
-    for (BodyRef& sphereBody : bodies)
+    // Candidate boxes come from the static tree, never from a scan over all bodies.
+    for (std::size_t sphereBody = 0; sphereBody < bodies.Size(); ++sphereBody)
     {
-        if (sphereBody.collider->type != ColliderType::Sphere ||
-            sphereBody.rigidbody->isStatic ||
-            !sphereBody.rigidbody->simulatePhysics ||
-            !sphereBody.rigidbody->useAdvancedSphereStabilization)
+        if (!bodies.Has(sphereBody, kBodySphere) ||
+            !bodies.IsAwakeDynamic(sphereBody) ||
+            !bodies.Has(sphereBody, kBodySphereStabilization))
             continue;
+        ++m_StepStats.sphereStabilizations;
 
-        const float radius = SphereRadius(*sphereBody.collider);
-        Vec3 sphereCenter = Add(sphereBody.transform->position, sphereBody.collider->offset);
+        const float radius = BodyRadius(bodies, sphereBody);
+        Vec3 sphereCenter = ColliderCenter(bodies, sphereBody);
         float bestPen = 0.0f;
         Vec3 bestNormal{ 0.0f, 1.0f, 0.0f };
 
-        for (BodyRef& boxBody : bodies)
+        const auto stabilizeAgainst = [&](std::uint32_t proxy)
         {
-            if (boxBody.collider->type != ColliderType::Box || !boxBody.rigidbody->isStatic)
-                continue;
+            const std::size_t boxBody = m_Broadphase.GetUserData(static_cast<physics::ProxyId>(proxy));
+            if (bodies.Has(boxBody, kBodySphere) || bodies.HasMeshShape(boxBody) || !bodies.Has(boxBody, kBodyStatic))
+                return;
+            if (bodyProxies[sphereBody] != physics::kNullProxy &&
+                !m_Broadphase.ShouldCollide(bodyProxies[sphereBody], static_cast<physics::ProxyId>(proxy)))
+                return;
 
-            const Vec3 boxCenter = Add(boxBody.transform->position, boxBody.collider->offset);
-            const BoxAxes boxAxes = BuildBoxAxes(boxBody.transform->rotation);
+            const Vec3 boxCenter = ColliderCenter(bodies, boxBody);
+            const BoxAxes& boxAxes = bodies.axes[boxBody];
             const Vec3 toSphere = Sub(sphereCenter, boxCenter);
             const float lx = Dot(toSphere, boxAxes.xAxis);
             const float ly = Dot(toSphere, boxAxes.yAxis);
             const float lz = Dot(toSphere, boxAxes.zAxis);
-            const Vec3 half = boxBody.collider->halfExtents;
+            const Vec3 half = bodies.halfExtents[boxBody];
             const float clx = Clamp(lx, -half.x, half.x);
             const float cly = Clamp(ly, -half.y, half.y);
             const float clz = Clamp(lz, -half.z, half.z);
@@ -617,7 +1929,7 @@ void PhysicsSystem::Update(World& world, float dt)
             const Vec3 delta = Sub(sphereCenter, closestPoint);
             const float distSq = LengthSq(delta);
             if (distSq >= radius * radius)
-                continue;
+                return;
 
             const float distance = std::sqrt(std::max(distSq, 0.0f));
             const Vec3 pushNormal = (distance > 0.000001f) ? Scale(delta, 1.0f / distance) : Vec3{ 0.0f, 1.0f, 0.0f };
@@ -627,24 +1939,166 @@ void PhysicsSystem::Update(World& world, float dt)
                 bestPen = penetration;
                 bestNormal = pushNormal;
             }
-        }
+        };
+        const Vec3 radiusExtent{ radius, radius, radius };
+        m_Broadphase.GetStaticTree().Query(physics::Aabb{ Sub(sphereCenter, radiusExtent), Add(sphereCenter, radiusExtent) }, stabilizeAgainst);
 
+        Vec3& velocity = bodies.velocity[sphereBody];
+        bool corrected = false;
         if (bestPen > m_SpherePenetrationEpsilon)
         {
+            corrected = true;
             sphereCenter = Add(sphereCenter, Scale(bestNormal, bestPen + 0.001f));
-            sphereBody.transform->position = Sub(sphereCenter, sphereBody.collider->offset);
-            const float vn = Dot(sphereBody.rigidbody->velocity, bestNormal);
+            bodies.position[sphereBody] = Sub(sphereCenter, bodies.offset[sphereBody]);
+            const float vn = Dot(velocity, bestNormal);
             if (vn < -m_SphereVelocityEpsilon)
-                sphereBody.rigidbody->velocity = Sub(sphereBody.rigidbody->velocity, Scale(bestNormal, vn));
+                velocity = Sub(velocity, Scale(bestNormal, vn));
         }
 
         const float maxSphereSpeed = std::max(m_SphereMaxSpeed, 0.1f);
-        const float speedSq = LengthSq(sphereBody.rigidbody->velocity);
+        const float speedSq = LengthSq(velocity);
         if (speedSq > maxSphereSpeed * maxSphereSpeed)
         {
+            corrected = true;
             const float invSpeed = 1.0f / std::sqrt(speedSq);
-            sphereBody.rigidbody->velocity = Scale(sphereBody.rigidbody->velocity, maxSphereSpeed * invSpeed);
+            velocity = Scale(velocity, maxSphereSpeed * invSpeed);
         }
+        if (corrected)
+            ++m_StepStats.sphereCorrections;
+    }
+
+    // Islands are connected components of awake dynamic bodies over the last substep's contacts.
+    // An island sleeps only once every body in it has stayed slow for m_TimeToSleep.
+    std::pmr::vector<std::uint32_t> islandParent(bodies.Size(), 0, &scratch);
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+        islandParent[i] = static_cast<std::uint32_t>(i);
+    for (const physics::ContactManifold& contact : m_Contacts)
+    {
+        if (!bodies.IsAwakeDynamic(contact.bodyA) || !bodies.IsAwakeDynamic(contact.bodyB))
+            continue;
+        const std::uint32_t rootA = FindIslandRoot(islandParent, contact.bodyA);
+        const std::uint32_t rootB = FindIslandRoot(islandParent, contact.bodyB);
+        if (rootA != rootB)
+            islandParent[std::max(rootA, rootB)] = std::min(rootA, rootB);
     }
+
+    // Speed is measured from the frame's displacement: bodies held up by position correction keep
+    // a small residual gravity velocity even though they do not move.
+    const float sleepDistance = m_SleepLinearVelocity * dt;
+    std::pmr::vector<float> islandRestTime(bodies.Size(), std::numeric_limits<float>::max(), &scratch);
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+    {
+        if (!bodies.IsAwakeDynamic(i))
+            continue;
+        ProxySlot& slot = m_ProxySlots[bodies.entity[i].index];
+        // Distant bodies moved over all the updates they skipped.
+        const float restDistance = sleepDistance * bodyTimeScale[i];
+        const bool resting =
+            LengthSq(Sub(bodies.position[i], slot.position)) < restDistance * restDistance &&
+            LengthSq(bodies.acceleration[i]) == 0.0f;
+        slot.sleepTimer = resting ? slot.sleepTimer + dt * bodyTimeScale[i] : 0.0f;
+        const std::uint32_t root = FindIslandRoot(islandParent, static_cast<std::uint32_t>(i));
+        islandRestTime[root] = std::min(islandRestTime[root], slot.sleepTimer);
+    }
+
+    std::pmr::vector<std::uint32_t> islandIds(bodies.Size(), 0, &scratch);
+    std::pmr::vector<std::uint8_t> fellAsleep(bodies.Size(), 0, &scratch);
+    m_SleepingBodyCount = 0;
+    m_AwakeIslandCount = 0;
+    for (std::size_t i = 0; i < bodies.Size(); ++i)
+    {
+        ProxySlot& slot = m_ProxySlots[bodies.entity[i].index];
+        slot.position = bodies.position[i];
+        slot.rotation = bodies.rotation[i];
+        slot.halfExtents = bodies.halfExtents[i];
+        slot.offset = bodies.offset[i];
+        slot.layer = bodies.layer[i];
+        slot.mask = bodies.mask[i];
+
+        if (!bodies.IsAwakeDynamic(i))
+        {
+            if (bodies.Has(i, kBodySleeping))
+                ++m_SleepingBodyCount;
+            continue;
+        }
+        const std::uint32_t root = FindIslandRoot(islandParent, static_cast<std::uint32_t>(i));
+        if (m_TimeToSleep <= 0.0f || islandRestTime[root] < m_TimeToSleep || slot.proxy == physics::kNullProxy)
+        {
+            if (root == i)
+                ++m_AwakeIslandCount;
+            continue;
+        }
+        if (islandIds[root] == 0)
+        {
+            islandIds[root] = m_NextSleepIsland++;
+            if (m_NextSleepIsland == 0)
+                m_NextSleepIsland = 1;
+        }
+        slot.sleepIsland = islandIds[root];
+        bodies.flags[i] |= kBodySleeping;
+        bodies.velocity[i] = Vec3{};
+        fellAsleep[i] = 1;
+        ++m_SleepingBodyCount;
+    }
+    publishQueryColliders();
+    bodies.WriteBack();
+
+    // Contact events: every pair touching in any substep, diffed against the previous update.
+    // Pairs of bodies that rested through the update were not tested; they keep touching while
+    // both proxies live on.
+    const auto byPairKey = [](const TouchingPair& lhs, const TouchingPair& rhs) { return lhs.pairKey < rhs.pairKey; };
+    std::sort(m_FrameTouchingPairs.begin(), m_FrameTouchingPairs.end(), byPairKey);
+    m_FrameTouchingPairs.erase(std::unique(m_FrameTouchingPairs.begin(), m_FrameTouchingPairs.end(),
+        [](const TouchingPair& lhs, const TouchingPair& rhs) { return lhs.pairKey == rhs.pairKey; }),
+        m_FrameTouchingPairs.end());
+
+    const auto isResting = [&](Entity entity)
+    {
+        if (entity.index >= m_ProxySlots.size())
+            return false;
+        const ProxySlot& slot = m_ProxySlots[entity.index];
+        if (slot.proxy == physics::kNullProxy || slot.generation != entity.generation)
+            return false;
+        const std::uint32_t bodyIndex = m_Broadphase.GetUserData(slot.proxy);
+        return !fellAsleep[bodyIndex] && !bodies.IsAwakeDynamic(bodyIndex);
+    };
+
+    m_NextTouchingPairs.clear();
+    std::size_t previous = 0;
+    std::size_t current = 0;
+    while (previous < m_TouchingPairs.size() || current < m_FrameTouchingPairs.size())
+    {
+        const bool hasPrevious = previous < m_TouchingPairs.size();
+        const bool hasCurrent = current < m_FrameTouchingPairs.size();
+        if (hasPrevious && (!hasCurrent || m_TouchingPairs[previous].pairKey < m_FrameTouchingPairs[current].pairKey))
+        {
+            const TouchingPair& pair = m_TouchingPairs[previous++];
+            const bool stays = isResting(pair.a) && isResting(pair.b);
+            m_ContactEvents.push_back(ContactEvent{ pair.a, pair.b, stays ? ContactEventState::Stay : ContactEventState::End });
+            if (stays)
+                m_NextTouchingPairs.push_back(pair);
+            continue;
+        }
+
+        const TouchingPair& pair = m_FrameTouchingPairs[current++];
+        ContactEventState state = ContactEventState::Begin;
+        if (hasPrevious && m_TouchingPairs[previous].pairKey == pair.pairKey)
+        {
+            const TouchingPair& before = m_TouchingPairs[previous++];
+            // A recycled entity index is a different pair: end the old one first.
+            if (before.a == pair.a && before.b == pair.b)
+                state = ContactEventState::Stay;
+            else
+                m_ContactEvents.push_back(ContactEvent{ before.a, before.b, ContactEventState::End });
+        }
+        m_ContactEvents.push_back(ContactEvent{ pair.a, pair.b, state });
+        m_NextTouchingPairs.push_back(pair);
+    }
+    m_TouchingPairs.swap(m_NextTouchingPairs);
+    m_FrameTouchingPairs.clear();
+
+    if (m_EventBus && !m_ContactEvents.empty())
+        m_EventBus->PublishContacts(m_ContactEvents);
+    clock.Lap(PhysicsPhase::Finalize);
 }
 }
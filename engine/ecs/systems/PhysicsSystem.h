@@ -1,14 +1,80 @@
 #pragma once
 #include "ISystem.h"
 #include "../events/EventBus.h"
+#include "../../physics/Broadphase.h"
+#include "../../physics/Contact.h"
+#include "../../physics/ContactCache.h"
+#include "../../physics/PhysicsLod.h"
+#include "../../physics/PhysicsQuery.h"
+#include "../../physics/TriangleMesh.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+namespace physics { struct MeshShape; }
 namespace ecs {
+// Sections of one physics update; every substep adds to the same phases.
+enum class PhysicsPhase
+{
+    Sync,          // gather bodies, wake edited islands, sync proxies
+    Broadphase,    // integrate forces, move proxies, update pairs
+    Narrowphase,
+    Solver,        // warm start, coloring, velocity iterations
+    Continuous,    // CCD sweeps and position integration
+    PositionSolve,
+    Finalize,      // sphere stabilization, sleep islands, write-back, contact events
+    Count
+};
+inline constexpr std::size_t kPhysicsPhaseCount = static_cast<std::size_t>(PhysicsPhase::Count);
+
+// Timings and counters of the last update; substeps add up.
+struct PhysicsStepStats
+{
+    std::array<double, kPhysicsPhaseCount> phaseMs{};
+    double totalMs = 0.0;
+    std::uint32_t substeps = 0;
+    std::uint32_t bodies = 0;
+    // Awake bodies integrated, summed over substeps; adaptive substepping lowers it.
+    std::uint64_t bodySteps = 0;
+    // Broadphase proxies and tree heights once colliders are synced.
+    std::uint32_t proxies = 0;
+    std::uint32_t staticTreeHeight = 0;
+    std::uint32_t dynamicTreeHeight = 0;
+    // Broadphase pair updates: proxies moved, overlaps found for them and the duplicates among
+    // those, then the cached pairs the substeps filtered for the narrowphase.
+    std::uint64_t movedProxies = 0;
+    std::uint64_t candidatePairs = 0;
+    std::uint64_t duplicatePairs = 0;
+    std::uint64_t broadphasePairs = 0;
+    // Broadphase pairs handed to the narrowphase, the tests they reached per contact type
+    // (pairs that cannot collide are not tested), and the contacts they produced.
+    std::uint64_t pairsTested = 0;
+    std::array<std::uint64_t, physics::kContactTypeCount> narrowphaseTests{};
+    std::uint64_t contacts = 0;
+    std::uint64_t warmStartedContacts = 0;
+    // Contacts solved, summed over velocity iterations; the position passes run as many.
+    std::uint64_t contactSolves = 0;
+    std::uint32_t ccdSweeps = 0;
+    std::uint32_t ccdHits = 0;
+    // Spheres checked by the post-solve stabilization, and those it pushed out or slowed down.
+    std::uint32_t sphereStabilizations = 0;
+    std::uint32_t sphereCorrections = 0;
+    // Awake bodies per LOD level; all zero while LOD is off.
+    std::array<std::uint32_t, physics::kLodLevelCount> lodBodies{};
+};
+
+struct ColliderComponent;
+struct RigidbodyComponent;
+struct TransformComponent;
 class PhysicsSystem final : public ISystem {
 public:
     explicit PhysicsSystem(
         EventBus* eventBus = nullptr,
         float gravity = 9.81f,
         float linearDamping = 0.985f,
-        int substeps = 2,
+        int substeps = 4,
         float defaultRestitution = 0.05f,
         float defaultFriction = 0.85f,
         int solverIterations = 4,
@@ -32,18 +98,157 @@ public:
     void Update(World& world, float dt) override;
     void SetEnabled(bool enabled) { m_Enabled = enabled; }
     bool IsEnabled() const { return m_Enabled; }
+    const physics::Broadphase& GetBroadphase() const { return m_Broadphase; }
+    // Bodies slower than linearVelocity for timeToSleep seconds (as a whole island) go to sleep.
+    void SetSleepThresholds(float linearVelocity, float timeToSleep)
+    {
+        m_SleepLinearVelocity = linearVelocity;
+        m_TimeToSleep = timeToSleep;
+    }
+    std::size_t GetSleepingBodyCount() const { return m_SleepingBodyCount; }
+    std::size_t GetAwakeIslandCount() const { return m_AwakeIslandCount; }
+    // Begin/Stay/End events of the last update, also published once through the EventBus.
+    std::span<const ContactEvent> GetContactEvents() const { return m_ContactEvents; }
+    const PhysicsStepStats& GetStepStats() const { return m_StepStats; }
+    static const char* PhaseName(PhysicsPhase phase);
+    // Raycasts, overlaps and sweeps against the colliders as the last update left them. While
+    // the system is disabled, updates still sync colliders so queries follow editor changes.
+    physics::PhysicsQuery GetQuery() const { return physics::PhysicsQuery(m_Broadphase, m_QueryColliders); }
+    // Step settings, e.g. to rerun a restored step with other values for a comparison.
+    void SetSubsteps(int substeps) { m_Substeps = substeps; }
+    int GetSubsteps() const { return m_Substeps; }
+    void SetSolverIterations(int iterations) { m_SolverIterations = iterations; }
+    int GetSolverIterations() const { return m_SolverIterations; }
+    // Each island then takes as many substeps as its bodies need for their speed, size and
+    // contacts, up to maxSubsteps: lone slow or resting bodies step once per update, groups in
+    // contact keep the configured substeps and only fast ones step more often. Off, every awake
+    // body takes the configured substeps.
+    void SetAdaptiveSubsteps(bool enabled, int maxSubsteps = 8)
+    {
+        m_AdaptiveSubsteps = enabled;
+        m_MaxSubsteps = maxSubsteps;
+    }
+    bool IsAdaptiveSubstepsEnabled() const { return m_AdaptiveSubsteps; }
+    // Distance LOD: islands far from the focus step once per update with fewer solver
+    // iterations, every few updates, or not at all (see physics::LodLevel). The focus is
+    // usually the active camera; set it before each update.
+    void SetLodSettings(const physics::LodSettings& settings) { m_Lod = settings; }
+    const physics::LodSettings& GetLodSettings() const { return m_Lod; }
+    void SetLodFocus(const Vec3& focus) { m_LodFocus = focus; }
+    const Vec3& GetLodFocus() const { return m_LodFocus; }
+    // Writes the whole simulation state into outBlob: body positions, rotations, velocities
+    // and sleep state, the warm-start cache, sleep islands and the touching pairs behind
+    // contact events. outBlob keeps its capacity, so capturing every tick does not allocate.
+    void CaptureSnapshot(World& world, std::vector<std::uint8_t>& outBlob) const;
+    // Restores a captured blob; the following updates then repeat the captured ones exactly.
+    // Bodies destroyed since the capture are skipped, bodies created since keep their state.
+    // Returns false for a blob this build did not write.
+    bool RestoreSnapshot(World& world, std::span<const std::uint8_t> blob);
 private:
+    // Longer frames are simulated as this long, and so is a Distant island's catch-up step.
+    static constexpr float kMaxUpdateTime = 0.05f;
+    static constexpr std::size_t kNarrowphaseGrain = 64;
+    static constexpr std::size_t kSolverGrain = 32;
+    // Contact colors per substep; the last one collects contacts that fit no other and runs serially.
+    static constexpr std::uint32_t kContactColorCount = 16;
+    static constexpr std::uint32_t kOverflowContactColor = kContactColorCount - 1;
+    // CCD sweeps bodies that move more than this fraction of their smallest half extent per
+    // substep, and stops them this deep inside what they hit.
+    static constexpr float kCcdMotionThreshold = 0.5f;
+    static constexpr float kCcdTargetDepth = 0.005f;
+    // Adaptive substeps keep every body's motion per substep below this fraction of its
+    // smallest half extent.
+    static constexpr float kAdaptiveTravelFraction = 0.25f;
+
+    // Triangles of a static triangle-mesh collider, scaled and rotated into world orientation.
+    struct PlacedTriangleMesh
+    {
+        std::shared_ptr<const physics::MeshShape> shape;
+        Vec3 rotation{};
+        Vec3 scale{};
+        physics::TriangleMesh triangles;
+    };
+
+    // Broadphase proxy owned by the entity with this index, kept across frames.
+    struct ProxySlot
+    {
+        physics::ProxyId proxy = physics::kNullProxy;
+        std::uint32_t generation = 0;
+        std::uint64_t lastSeenFrame = 0;
+        bool isStatic = false;
+        // Collider pose and filter at the end of the previous update, to catch edits made between frames.
+        Vec3 position{};
+        Vec3 rotation{};
+        Vec3 halfExtents{};
+        Vec3 offset{};
+        std::uint32_t layer = 0;
+        std::uint32_t mask = 0;
+        float sleepTimer = 0.0f;
+        // Island the body fell asleep with; 0 while awake.
+        std::uint32_t sleepIsland = 0;
+        physics::LodLevel lodLevel = physics::LodLevel::Full;
+        // Time a Distant body skipped since it last stepped.
+        float lodPendingTime = 0.0f;
+        std::unique_ptr<PlacedTriangleMesh> placedMesh;
+    };
+
+    const physics::TriangleMesh* PlaceTriangleMesh(
+        Entity entity,
+        const TransformComponent& transform,
+        const ColliderComponent& collider,
+        const RigidbodyComponent& rigidbody);
+
+    // Entity pair that touched during an update; a has the lower index.
+    struct TouchingPair
+    {
+        std::uint64_t pairKey = 0;
+        Entity a{};
+        Entity b{};
+    };
+
     EventBus* m_EventBus = nullptr;
     bool m_Enabled = true;
     float m_Gravity = 9.81f;
     float m_LinearDamping = 0.985f;
-    int m_Substeps = 2;
+    int m_Substeps = 4;
     float m_DefaultRestitution = 0.05f;
     float m_DefaultFriction = 0.85f;
     int m_SolverIterations = 4;
+    bool m_AdaptiveSubsteps = false;
+    int m_MaxSubsteps = 8;
+    physics::LodSettings m_Lod;
+    Vec3 m_LodFocus{};
+    // Updates stepped with LOD on; Distant islands take turns by it.
+    std::uint64_t m_LodFrame = 0;
     float m_SphereMaxSpeed = 9.0f;
     float m_SpherePenetrationEpsilon = 0.0005f;
     float m_SphereVelocityEpsilon = 0.05f;
     float m_DynamicBoxSphereCorrectionPercent = 1.0f;
+    physics::Broadphase m_Broadphase;
+    std::vector<ProxySlot> m_ProxySlots;
+    std::uint64_t m_BroadphaseFrame = 0;
+    // Set by RestoreSnapshot: the next update re-syncs every proxy, since resting bodies may
+    // have been moved back to where their proxies no longer are.
+    bool m_ResyncProxies = false;
+    // Narrowphase output of the current substep; chunks are filled in parallel, then merged.
+    std::vector<std::vector<physics::ContactManifold>> m_ContactChunks;
+    std::vector<std::array<std::uint32_t, physics::kContactTypeCount>> m_ContactChunkTests;
+    std::vector<physics::ContactManifold> m_Contacts;
+    physics::ContactCache m_ContactCache;
+    std::vector<physics::ContactManifold> m_ColoredContacts;
+    std::vector<std::uint32_t> m_ContactColorOffsets;
+    float m_SleepLinearVelocity = 0.08f;
+    float m_TimeToSleep = 0.5f;
+    std::uint32_t m_NextSleepIsland = 1;
+    std::size_t m_SleepingBodyCount = 0;
+    std::size_t m_AwakeIslandCount = 0;
+    // Sorted by pairKey. Frame pairs collect every substep's contacts before deduplication.
+    std::vector<TouchingPair> m_FrameTouchingPairs;
+    std::vector<TouchingPair> m_TouchingPairs;
+    std::vector<TouchingPair> m_NextTouchingPairs;
+    std::vector<ContactEvent> m_ContactEvents;
+    PhysicsStepStats m_StepStats;
+    // Indexed by broadphase proxy.
+    std::vector<physics::QueryCollider> m_QueryColliders;
 };
 }
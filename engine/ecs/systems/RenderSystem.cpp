@@ -1,10 +1,12 @@
 #include "RenderSystem.h"
 
+#include "AsyncPhysicsSystem.h"
 #include "../World.h"
 #include "../components/MaterialComponent.h"
 #include "../components/ColliderComponent.h"
 #include "../components/MeshRendererComponent.h"
 #include "../components/TransformComponent.h"
+#include "../../core/AllocationTracker.h"
 #include "../../core/AssetPaths.h"
 #include "../../core/Logger.h"
 #include "../../render/IRenderAdapter.h"
@@ -14,11 +16,18 @@
 #include "../../resources/ShaderResource.h"
 #include "../../resources/TextureResource.h"
 
+#include <chrono>
 #include <cmath>
 
 namespace
 {
 constexpr float kWhiteTint[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+const std::string kDefaultTextureKey = "defaults/texture";
+
+double ElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
 
 float Dot(const ecs::Vec3& lhs, const ecs::Vec3& rhs)
 {
@@ -327,12 +336,38 @@ void RenderSystem::ReleaseGpuResources()
     m_ResourceOwnerRenderer = nullptr;
 }
 
+RenderSystem::GpuUploadStats RenderSystem::ConsumeGpuUploadStats()
+{
+    const GpuUploadStats stats = m_GpuUploadStats;
+    m_GpuUploadStats = GpuUploadStats{};
+    return stats;
+}
+
 void RenderSystem::Update(World& world, float dt)
 {
     (void)dt;
     if (m_Renderer == nullptr)
         return;
 
+    AllocationScope allocationScope(AllocationTag::Render, "RenderSystem::Update");
+
+    const float interpolationAlpha = m_PhysicsInterpolation != nullptr ? m_PhysicsInterpolation->GetRenderAlpha() : 1.0f;
+    const auto drawTransform = [&](Entity entity, const TransformComponent& transform)
+    {
+        TransformComponent result = transform;
+        if (m_PhysicsInterpolation == nullptr)
+            return result;
+        if (const AsyncPhysicsSystem::RenderTicks* ticks = m_PhysicsInterpolation->FindRenderTicks(entity))
+        {
+            result.position = ecs::Vec3{
+                ticks->previous.x + (ticks->latest.x - ticks->previous.x) * interpolationAlpha,
+                ticks->previous.y + (ticks->latest.y - ticks->previous.y) * interpolationAlpha,
+                ticks->previous.z + (ticks->latest.z - ticks->previous.z) * interpolationAlpha
+            };
+        }
+        return result;
+    };
+
     world.ForEach<TransformComponent, MeshRendererComponent>(
         [&](Entity entity, TransformComponent& transform, MeshRendererComponent& meshRenderer)
         {
@@ -340,7 +375,7 @@ void RenderSystem::Update(World& world, float dt)
                 return;
 
             (void)TryDrawResourceMesh(
-                transform,
+                drawTransform(entity, transform),
                 meshRenderer,
                 world.GetComponent<MaterialComponent>(entity));
         });
@@ -349,10 +384,10 @@ void RenderSystem::Update(World& world, float dt)
         return;
 
     world.ForEach<TransformComponent, ColliderComponent>(
-        [&](Entity, TransformComponent& transform, ColliderComponent& collider)
+        [&](Entity entity, TransformComponent& transform, ColliderComponent& collider)
         {
             float mvp[16];
-            TransformComponent debugTransform = transform;
+            TransformComponent debugTransform = drawTransform(entity, transform);
             debugTransform.position.x += collider.offset.x;
             debugTransform.position.y += collider.offset.y;
             debugTransform.position.z += collider.offset.z;
@@ -398,30 +433,31 @@ bool RenderSystem::TryDrawResourceMesh(
     if (meshRenderer.meshPath.empty())
         return false;
 
-    std::string texturePath = meshRenderer.texturePath;
-    std::string shaderPath = meshRenderer.shaderPath;
+    const std::string* texturePath = &meshRenderer.texturePath;
+    const std::string* shaderPath = &meshRenderer.shaderPath;
     float tint[4] = { kWhiteTint[0], kWhiteTint[1], kWhiteTint[2], kWhiteTint[3] };
+    ResourceHandle<MaterialResource> material;
 
     if (materialComponent != nullptr)
     {
         if (!materialComponent->texturePath.empty())
-            texturePath = materialComponent->texturePath;
+            texturePath = &materialComponent->texturePath;
         if (!materialComponent->shaderPath.empty())
-            shaderPath = materialComponent->shaderPath;
+            shaderPath = &materialComponent->shaderPath;
         for (std::size_t i = 0; i < 4; ++i)
             tint[i] *= materialComponent->tint[i];
 
         if (!materialComponent->materialPath.empty())
         {
-            const std::string materialKey = AssetPaths::NormalizeAssetKey(materialComponent->materialPath);
-            const auto material = materialKey.empty() ? nullptr : GetOrLoadMaterial(materialKey);
+            const std::string& materialKey = GetNormalizedAssetKey(materialComponent->materialPath);
+            material = materialKey.empty() ? nullptr : GetOrLoadMaterial(materialKey);
             if (material != nullptr && material->IsUsable())
             {
                 const auto& data = material->GetData();
-                if (texturePath.empty())
-                    texturePath = data.texturePath;
-                if (shaderPath.empty())
-                    shaderPath = data.shaderPath;
+                if (texturePath->empty())
+                    texturePath = &data.texturePath;
+                if (shaderPath->empty())
+                    shaderPath = &data.shaderPath;
                 tint[0] *= data.baseColor[0];
                 tint[1] *= data.baseColor[1];
                 tint[2] *= data.baseColor[2];
@@ -430,26 +466,26 @@ bool RenderSystem::TryDrawResourceMesh(
         }
     }
 
-    if (shaderPath.empty())
+    if (shaderPath->empty())
         return false;
 
-    const std::string meshKey = AssetPaths::NormalizeAssetKey(meshRenderer.meshPath);
-    const std::string shaderKey = AssetPaths::NormalizeShaderKey(shaderPath);
+    const std::string& meshKey = GetNormalizedAssetKey(meshRenderer.meshPath);
+    const std::string& shaderKey = GetNormalizedShaderKey(*shaderPath);
     if (meshKey.empty() || shaderKey.empty())
         return false;
 
     const RenderMeshHandle meshHandle = GetOrUploadMesh(meshKey);
     RenderTextureHandle textureHandle = RenderTextureHandle::Invalid();
-    if (!texturePath.empty())
+    if (!texturePath->empty())
     {
-        const std::string textureKey = AssetPaths::NormalizeAssetKey(texturePath);
+        const std::string& textureKey = GetNormalizedAssetKey(*texturePath);
         if (textureKey.empty())
             return false;
         textureHandle = GetOrCreateTexture(textureKey);
     }
     else
     {
-        textureHandle = GetOrCreateTexture("defaults/texture");
+        textureHandle = GetOrCreateTexture(kDefaultTextureKey);
     }
     const RenderShaderHandle shaderHandle = GetOrCreateShader(shaderKey);
     if (!meshHandle.IsValid() || !textureHandle.IsValid() || !shaderHandle.IsValid())
@@ -478,6 +514,22 @@ bool RenderSystem::TryDrawResourceMesh(
     return true;
 }
 
+const std::string& RenderSystem::GetNormalizedAssetKey(const std::string& path)
+{
+    auto it = m_AssetKeyCache.find(path);
+    if (it == m_AssetKeyCache.end())
+        it = m_AssetKeyCache.emplace(path, AssetPaths::NormalizeAssetKey(path)).first;
+    return it->second;
+}
+
+const std::string& RenderSystem::GetNormalizedShaderKey(const std::string& path)
+{
+    auto it = m_ShaderKeyCache.find(path);
+    if (it == m_ShaderKeyCache.end())
+        it = m_ShaderKeyCache.emplace(path, AssetPaths::NormalizeShaderKey(path)).first;
+    return it->second;
+}
+
 RenderMeshHandle RenderSystem::GetOrUploadMesh(const std::string& key)
 {
     auto resourceIt = m_MeshResources.find(key);
@@ -520,7 +572,10 @@ RenderMeshHandle RenderSystem::GetOrUploadMesh(const std::string& key)
         return RenderMeshHandle::Invalid();
     }
 
+    const auto uploadStart = std::chrono::steady_clock::now();
     const RenderMeshHandle handle = m_Renderer->UploadMesh(mesh.meshData);
+    ++m_GpuUploadStats.uploads;
+    m_GpuUploadStats.milliseconds += ElapsedMilliseconds(uploadStart);
     if (!handle.IsValid())
     {
         m_FailedMeshGpuVersions[key] = version;
@@ -581,7 +636,10 @@ RenderTextureHandle RenderSystem::GetOrCreateTexture(const std::string& key)
         return RenderTextureHandle::Invalid();
     }
 
+    const auto uploadStart = std::chrono::steady_clock::now();
     const RenderTextureHandle handle = m_Renderer->CreateTexture2D(texture.textureData);
+    ++m_GpuUploadStats.uploads;
+    m_GpuUploadStats.milliseconds += ElapsedMilliseconds(uploadStart);
     if (!handle.IsValid())
     {
         m_FailedTextureGpuVersions[key] = version;
@@ -639,7 +697,10 @@ RenderShaderHandle RenderSystem::GetOrCreateShader(const std::string& key)
         return RenderShaderHandle::Invalid();
     }
 
+    const auto uploadStart = std::chrono::steady_clock::now();
     const RenderShaderHandle handle = m_Renderer->CreateShaderProgram(shader);
+    ++m_GpuUploadStats.uploads;
+    m_GpuUploadStats.milliseconds += ElapsedMilliseconds(uploadStart);
     if (!handle.IsValid())
     {
         m_FailedShaderGpuVersions[key] = version;
@@ -19,6 +19,7 @@ struct MaterialResource;
 
 namespace ecs
 {
+class AsyncPhysicsSystem;
 struct MaterialComponent;
 struct MeshRendererComponent;
 struct TransformComponent;
@@ -26,6 +27,12 @@ struct TransformComponent;
 class RenderSystem final : public ISystem
 {
 public:
+    struct GpuUploadStats
+    {
+        std::uint32_t uploads = 0;
+        double milliseconds = 0.0;
+    };
+
     ~RenderSystem() override;
 
     const char* Name() const override { return "RenderSystem"; }
@@ -35,7 +42,10 @@ public:
     void SetCameraProjection(float verticalFovRadians, float aspectRatio, float nearPlane, float farPlane);
     void SetResourceManager(ResourceManager* resourceManager) { m_ResourceManager = resourceManager; }
     void SetDebugCollidersEnabled(bool enabled) { m_DebugCollidersEnabled = enabled; }
+    // Bodies it wrote back are drawn between its last two ticks; null draws components as is.
+    void SetPhysicsInterpolation(const AsyncPhysicsSystem* physics) { m_PhysicsInterpolation = physics; }
     void ReleaseGpuResources();
+    GpuUploadStats ConsumeGpuUploadStats();
 
 private:
     bool TryDrawResourceMesh(
@@ -46,10 +56,13 @@ private:
     RenderTextureHandle GetOrCreateTexture(const std::string& key);
     RenderShaderHandle GetOrCreateShader(const std::string& key);
     ResourceHandle<MaterialResource> GetOrLoadMaterial(const std::string& key);
+    const std::string& GetNormalizedAssetKey(const std::string& path);
+    const std::string& GetNormalizedShaderKey(const std::string& path);
 
     IRenderAdapter* m_Renderer = nullptr;
     IRenderAdapter* m_ResourceOwnerRenderer = nullptr;
     ResourceManager* m_ResourceManager = nullptr;
+    const AsyncPhysicsSystem* m_PhysicsInterpolation = nullptr;
     Vec3 m_CameraPosition{ 0.0f, 0.0f, -2.25f };
     float m_CameraYaw = 0.0f;
     float m_CameraPitch = 0.0f;
@@ -71,6 +84,10 @@ private:
     std::unordered_set<std::string> m_LoggedMeshReuseKeys;
     std::unordered_set<std::string> m_LoggedTextureReuseKeys;
     std::unordered_set<std::string> m_LoggedShaderReuseKeys;
+    // Raw component path -> normalized key, so steady-state draws do not build strings.
+    std::unordered_map<std::string, std::string> m_AssetKeyCache;
+    std::unordered_map<std::string, std::string> m_ShaderKeyCache;
     bool m_DebugCollidersEnabled = false;
+    GpuUploadStats m_GpuUploadStats;
 };
 }
@@ -20,6 +20,15 @@ public:
         return ref;
     }
 
+    // Takes a system that was constructed and configured beforehand.
+    template <typename TSystem>
+    TSystem& AddSystem(std::unique_ptr<TSystem> system)
+    {
+        TSystem& ref = *system;
+        m_Systems.push_back(std::move(system));
+        return ref;
+    }
+
     void Update(World& world, float dt);
     void Clear();
 
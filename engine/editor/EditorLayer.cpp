@@ -2,6 +2,7 @@
 
 #include "../core/Application.h"
 #include "../ecs/World.h"
+#include "../ecs/systems/PhysicsSystem.h"
 #include "../ecs/components/ColliderComponent.h"
 #include "../ecs/components/MaterialComponent.h"
 #include "../ecs/components/MeshRendererComponent.h"
@@ -10,7 +11,9 @@
 #include "../ecs/components/TransformComponent.h"
 #include "../render/IRenderAdapter.h"
 #include "../resources/ResourceManager.h"
+#include "../core/AllocationTracker.h"
 #include "../core/AssetPaths.h"
+#include "../core/FrameArena.h"
 
 #include <imgui.h>
 #include <ImGuizmo.h>
@@ -24,6 +27,7 @@
 #include <cstdio>
 #include <fstream>
 #include <filesystem>
+#include <memory_resource>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -45,6 +49,10 @@ const char* ColliderTypeName(ecs::ColliderType type)
         return "Box";
     case ecs::ColliderType::Sphere:
         return "Sphere";
+    case ecs::ColliderType::TriangleMesh:
+        return "Triangle Mesh";
+    case ecs::ColliderType::ConvexHull:
+        return "Convex Hull";
     default:
         return "Unknown";
     }
@@ -341,7 +349,8 @@ bool EditorLayer::IsPointInsideViewport(double x, double y) const
 
 void EditorLayer::Render(Application& app, IRenderAdapter* renderer, float dt)
 {
-    RefreshAssetLists(dt);
+    AllocationScope allocationScope(AllocationTag::Editor, "EditorLayer::Render");
+    RefreshAssetLists(app, dt);
 
     m_ViewportPixelWidth = 0;
     m_ViewportPixelHeight = 0;
@@ -412,6 +421,7 @@ void EditorLayer::RestoreSnapshot(Application& app, const EntitySnapshot& snapsh
     RestoreComponent(world, snapshot.entity, snapshot.rigidbody);
     RestoreComponent(world, snapshot.entity, snapshot.collider);
     m_SelectedEntity = snapshot.entity;
+    app.RequestColliderAutoFit(snapshot.entity);
 }
 
 void EditorLayer::PushUndo(const std::string& label, const EntitySnapshot& snapshot)
@@ -464,22 +474,43 @@ void EditorLayer::HandleEditorShortcuts(Application& app)
         Redo(app);
 }
 
-void EditorLayer::RefreshAssetLists(float dt)
+void EditorLayer::RefreshAssetLists(Application& app, float dt)
 {
+    if (m_AssetScanTask == 0)
+        m_AssetScanTask = app.GetFrameTasks().Add("editor.asset_scan", [this]() { return StepAssetScan(); });
+
     m_AssetRefreshTimer += dt;
     if (!m_AssetListsDirty && m_AssetRefreshTimer < 2.0f)
         return;
 
     m_AssetRefreshTimer = 0.0f;
     m_AssetListsDirty = false;
+    m_AssetScanStage = 0;
+}
 
-    const std::filesystem::path assetRoot = AssetPaths::ResolveAssetRoot();
-    const std::filesystem::path shaderRoot = AssetPaths::ResolveShaderRoot();
+FrameTaskResult EditorLayer::StepAssetScan()
+{
+    // One directory tree per step so a large asset folder does not stall a single frame.
+    switch (m_AssetScanStage)
+    {
+    case 0:
+        m_MeshAssets = ScanAssetKeys(AssetPaths::ResolveAssetRoot(), "models", { ".obj", ".fbx", ".gltf", ".glb" });
+        break;
+    case 1:
+        m_TextureAssets = ScanAssetKeys(AssetPaths::ResolveAssetRoot(), "textures", { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".dds" });
+        break;
+    case 2:
+        m_MaterialAssets = ScanAssetKeys(AssetPaths::ResolveAssetRoot(), "materials", { ".json", ".material" });
+        break;
+    case 3:
+        m_ShaderAssets = ScanAssetKeys(AssetPaths::ResolveShaderRoot(), "", { ".hlsl" });
+        break;
+    default:
+        return FrameTaskResult::Yield;
+    }
 
-    m_MeshAssets = ScanAssetKeys(assetRoot, "models", { ".obj", ".fbx", ".gltf", ".glb" });
-    m_TextureAssets = ScanAssetKeys(assetRoot, "textures", { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".dds" });
-    m_MaterialAssets = ScanAssetKeys(assetRoot, "materials", { ".json", ".material" });
-    m_ShaderAssets = ScanAssetKeys(shaderRoot, "", { ".hlsl" });
+    ++m_AssetScanStage;
+    return m_AssetScanStage < 4 ? FrameTaskResult::Continue : FrameTaskResult::Yield;
 }
 
 void EditorLayer::DrawMainMenu(Application& app)
@@ -532,6 +563,11 @@ void EditorLayer::DrawMainMenu(Application& app)
             app.SpawnPhysicsProjectile();
         if (ImGui::MenuItem("Toggle Debug Colliders"))
             app.ToggleDebugColliders();
+        ImGui::Separator();
+        if (ImGui::MenuItem("Capture Physics State"))
+            app.CapturePhysicsState();
+        if (ImGui::MenuItem("Restore Physics State", nullptr, false, app.HasPhysicsState()))
+            (void)app.RestorePhysicsState();
         ImGui::EndMenu();
     }
 
@@ -551,7 +587,7 @@ void EditorLayer::DrawSceneHierarchy(Application& app)
     ImGui::Begin("Scene Hierarchy", &m_ShowHierarchy);
 
     auto& world = app.GetWorld();
-    std::vector<ecs::Entity> entities;
+    std::pmr::vector<ecs::Entity> entities(&FrameArena::ForThisThread());
     world.ForEach<ecs::TagComponent>(
         [&](ecs::Entity entity, ecs::TagComponent&)
         {
@@ -574,14 +610,18 @@ void EditorLayer::DrawSceneHierarchy(Application& app)
     for (const ecs::Entity& entity : entities)
     {
         auto* tag = world.GetComponent<ecs::TagComponent>(entity);
-        const std::string label =
-            (tag != nullptr && !tag->name.empty())
-                ? tag->name + "##" + std::to_string(entity.index)
-                : "Entity " + std::to_string(entity.index);
+        char fallbackLabel[32];
+        const char* label = fallbackLabel;
+        if (tag != nullptr && !tag->name.empty())
+            label = tag->name.c_str();
+        else
+            std::snprintf(fallbackLabel, sizeof(fallbackLabel), "Entity %u", entity.index);
 
         const bool selected = entity == m_SelectedEntity;
-        if (ImGui::Selectable(label.c_str(), selected))
+        ImGui::PushID(static_cast<int>(entity.index));
+        if (ImGui::Selectable(label, selected))
             m_SelectedEntity = entity;
+        ImGui::PopID();
     }
 
     ImGui::End();
@@ -625,7 +665,10 @@ void EditorLayer::DrawInspector(Application& app)
                 PushUndo("Edit Rotation", before);
             before = CaptureSelectedEntity(app);
             if (ImGui::DragFloat3("Scale", Vec3Data(transform->scale), 0.01f, 0.001f, 100.0f))
+            {
                 PushUndo("Edit Scale", before);
+                app.RequestColliderAutoFit(m_SelectedEntity);
+            }
             ImGui::TreePop();
         }
     }
@@ -639,7 +682,10 @@ void EditorLayer::DrawInspector(Application& app)
                 PushUndo("Toggle Mesh Visibility", before);
             before = CaptureSelectedEntity(app);
             if (DrawResourceCombo("Mesh", mesh->meshPath, m_MeshAssets, false))
+            {
                 PushUndo("Change Mesh", before);
+                app.RequestColliderAutoFit(m_SelectedEntity);
+            }
             before = CaptureSelectedEntity(app);
             if (DrawResourceCombo("Texture", mesh->texturePath, m_TextureAssets, true))
                 PushUndo("Change Texture", before);
@@ -684,9 +730,13 @@ void EditorLayer::DrawInspector(Application& app)
             if (ImGui::Checkbox("Simulate Physics", &rb->simulatePhysics))
                 PushUndo("Toggle Physics Simulation", before);
             before = CaptureSelectedEntity(app);
+            if (ImGui::Checkbox("Continuous Collision", &rb->continuousCollision))
+                PushUndo("Toggle Continuous Collision", before);
+            before = CaptureSelectedEntity(app);
             if (ImGui::DragFloat("Mass", &rb->mass, 0.05f, 0.001f, 1000.0f))
                 PushUndo("Edit Rigidbody Mass", before);
             ImGui::Text("Velocity: %.3f, %.3f, %.3f", rb->velocity.x, rb->velocity.y, rb->velocity.z);
+            ImGui::Text("State: %s", rb->isSleeping ? "Sleeping" : "Awake");
             ImGui::TreePop();
         }
     }
@@ -695,21 +745,31 @@ void EditorLayer::DrawInspector(Application& app)
     {
         if (ImGui::TreeNodeEx("Collider", ImGuiTreeNodeFlags_DefaultOpen))
         {
-            int typeIndex = collider->type == ecs::ColliderType::Sphere ? 1 : 0;
-            const char* types[] = { "Box", "Sphere" };
+            // Combo entries follow the ColliderType order; mesh types pick up their shape from
+            // the mesh renderer through the refit a type change requests.
+            int typeIndex = static_cast<int>(collider->type);
+            const char* types[] = { "Box", "Sphere", "Triangle Mesh", "Convex Hull" };
             EntitySnapshot before = CaptureSelectedEntity(app);
-            if (ImGui::Combo("Type", &typeIndex, types, 2))
+            if (ImGui::Combo("Type", &typeIndex, types, 4))
             {
-                collider->type = typeIndex == 1 ? ecs::ColliderType::Sphere : ecs::ColliderType::Box;
+                collider->type = static_cast<ecs::ColliderType>(typeIndex);
                 PushUndo("Change Collider Type", before);
+                app.RequestColliderAutoFit(m_SelectedEntity);
             }
             ImGui::Text("Current: %s", ColliderTypeName(collider->type));
             before = CaptureSelectedEntity(app);
+            // Editing the size by hand turns auto fit off, so the next refit keeps it.
             if (ImGui::DragFloat3("Half Extents", Vec3Data(collider->halfExtents), 0.01f, 0.001f, 100.0f))
+            {
+                collider->autoFitFromMesh = false;
                 PushUndo("Edit Collider Size", before);
+            }
             before = CaptureSelectedEntity(app);
             if (ImGui::DragFloat3("Offset", Vec3Data(collider->offset), 0.01f))
+            {
+                collider->autoFitFromMesh = false;
                 PushUndo("Edit Collider Offset", before);
+            }
             before = CaptureSelectedEntity(app);
             if (ImGui::DragFloat("Restitution", &collider->restitution, 0.01f, 0.0f, 1.0f))
                 PushUndo("Edit Restitution", before);
@@ -718,7 +778,17 @@ void EditorLayer::DrawInspector(Application& app)
                 PushUndo("Edit Friction", before);
             before = CaptureSelectedEntity(app);
             if (ImGui::Checkbox("Auto Fit From Mesh", &collider->autoFitFromMesh))
+            {
                 PushUndo("Toggle Collider Auto Fit", before);
+                app.RequestColliderAutoFit(m_SelectedEntity);
+            }
+            // Bit masks in hex: a pair collides when each layer is in the other's mask.
+            before = CaptureSelectedEntity(app);
+            if (ImGui::InputScalar("Layer", ImGuiDataType_U32, &collider->layer, nullptr, nullptr, "%08X", ImGuiInputTextFlags_CharsHexadecimal))
+                PushUndo("Edit Collision Layer", before);
+            before = CaptureSelectedEntity(app);
+            if (ImGui::InputScalar("Collides With", ImGuiDataType_U32, &collider->mask, nullptr, nullptr, "%08X", ImGuiInputTextFlags_CharsHexadecimal))
+                PushUndo("Edit Collision Mask", before);
             ImGui::TreePop();
         }
     }
@@ -751,7 +821,7 @@ void EditorLayer::DrawStatistics(Application& app, float dt)
             ++colliderCount;
         });
 
-    ImGui::SetNextWindowSize(ImVec2(280.0f, 170.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(300.0f, 280.0f), ImGuiCond_FirstUseEver);
     ImGui::Begin("Statistics", &m_ShowStatistics);
     ImGui::Text("Average FPS: %.1f", m_AverageFps);
     ImGui::Text("Frame time: %.3f ms (~%.1f FPS)", dt * 1000.0f, dt > 0.0f ? 1.0f / dt : 0.0f);
@@ -772,6 +842,106 @@ void EditorLayer::DrawStatistics(Application& app, float dt)
         ImGui::Text("Resource memory: %s", FormatBytes(stats.estimatedCpuBytes));
         ImGui::Text("Loading: %zu  Failed: %zu", stats.loadingCount, stats.failedCount);
     }
+
+    const FrameArena& frameArena = FrameArena::ForThisThread();
+    ImGui::Text("Frame arena peak: %s", FormatBytes(frameArena.GetPeakBytesUsed()));
+
+    const FrameStats& frameStats = app.GetFrameStats();
+    const FrameStats::Summary frames = frameStats.GetSessionSummary();
+    ImGui::Separator();
+    ImGui::Text("Frame p50 %.2f  p90 %.2f ms", frames.p50Ms, frames.p90Ms);
+    ImGui::Text("Frame p99 %.2f  p99.9 %.2f  max %.2f ms", frames.p99Ms, frames.p999Ms, frames.maxMs);
+    ImGui::Text("Hitches >33/50/100 ms: %llu / %llu / %llu",
+        static_cast<unsigned long long>(frames.hitchCounts[0]),
+        static_cast<unsigned long long>(frames.hitchCounts[1]),
+        static_cast<unsigned long long>(frames.hitchCounts[2]));
+    ImGui::Text("Systems %.2f  Editor %.2f  Present %.2f ms",
+        frameStats.GetLastPhaseTime(FramePhase::Systems),
+        frameStats.GetLastPhaseTime(FramePhase::Editor),
+        frameStats.GetLastPhaseTime(FramePhase::Present));
+    const FrameTaskScheduler& frameTasks = app.GetFrameTasks();
+    ImGui::Text("Frame tasks %.2f ms (%zu tasks, %u deferred)",
+        frameTasks.GetLastFrameMs(),
+        frameTasks.GetTaskCount(),
+        frameTasks.GetLastFrameDeferredTasks());
+    if (frameStats.IsCapturing())
+        ImGui::TextColored(ImVec4(1.0f, 0.45f, 0.35f, 1.0f), "Capturing (F9): %s", frameStats.GetCapturePath().filename().string().c_str());
+    if (ImGui::Button(frameStats.IsCapturing() ? "Stop Capture" : "Start Capture"))
+        app.ToggleFrameCapture();
+
+    ImGui::Separator();
+    ecs::PhysicsStepStats physicsStats;
+    if (!app.GetPhysicsStepStats(physicsStats))
+    {
+        ImGui::TextDisabled("Physics not running");
+    }
+    else if (ImGui::TreeNode("Physics"))
+    {
+        const auto count = [](std::uint64_t value) { return static_cast<unsigned long long>(value); };
+        ImGui::Text("Step %.3f ms, %u substeps", physicsStats.totalMs, physicsStats.substeps);
+        for (std::size_t i = 0; i < ecs::kPhysicsPhaseCount; ++i)
+        {
+            ImGui::Text("  %-14s %.3f ms",
+                ecs::PhysicsSystem::PhaseName(static_cast<ecs::PhysicsPhase>(i)),
+                physicsStats.phaseMs[i]);
+        }
+        ImGui::Text("Bodies %u, body steps %llu", physicsStats.bodies, count(physicsStats.bodySteps));
+        ImGui::Text("Proxies %u, tree height static %u / dynamic %u",
+            physicsStats.proxies, physicsStats.staticTreeHeight, physicsStats.dynamicTreeHeight);
+        ImGui::Text("Moved proxies %llu, candidates %llu, duplicates %llu",
+            count(physicsStats.movedProxies), count(physicsStats.candidatePairs), count(physicsStats.duplicatePairs));
+        ImGui::Text("Pairs %llu, tested %llu", count(physicsStats.broadphasePairs), count(physicsStats.pairsTested));
+        for (std::size_t i = 1; i < physics::kContactTypeCount; ++i)
+        {
+            ImGui::Text("  %-14s %llu tests",
+                physics::ContactTypeName(static_cast<physics::ContactType>(i)),
+                count(physicsStats.narrowphaseTests[i]));
+        }
+        ImGui::Text("Contacts %llu, warm-started %llu, solves %llu",
+            count(physicsStats.contacts), count(physicsStats.warmStartedContacts), count(physicsStats.contactSolves));
+        ImGui::Text("CCD sweeps %u, hits %u", physicsStats.ccdSweeps, physicsStats.ccdHits);
+        ImGui::Text("Sphere stabilization %u, corrected %u",
+            physicsStats.sphereStabilizations, physicsStats.sphereCorrections);
+        const auto& lod = physicsStats.lodBodies;
+        if (lod[0] + lod[1] + lod[2] + lod[3] > 0)
+            ImGui::Text("LOD full %u, reduced %u, distant %u, frozen %u", lod[0], lod[1], lod[2], lod[3]);
+        ImGui::TreePop();
+    }
+
+    ImGui::Separator();
+    if (!AllocationTracker::IsEnabled())
+    {
+        ImGui::TextDisabled("Allocation tracking disabled (WHISP_TRACK_ALLOCATIONS)");
+    }
+    else if (ImGui::TreeNode("Allocations"))
+    {
+        const AllocationTracker::FrameReport& allocations = AllocationTracker::GetLastFrame();
+        ImGui::Text("Last frame: %llu allocs", static_cast<unsigned long long>(allocations.frameAllocations));
+        ImGui::Text("Live: %s", FormatBytes(allocations.liveBytes));
+        ImGui::Text("Peak: %s", FormatBytes(allocations.peakLiveBytes));
+        for (std::size_t i = 0; i < kAllocationTagCount; ++i)
+        {
+            const AllocationTracker::TagStats& tag = allocations.tags[i];
+            ImGui::Text("%-10s %5llu allocs  max %5llu  live %s",
+                AllocationTracker::TagName(static_cast<AllocationTag>(i)),
+                static_cast<unsigned long long>(tag.frameAllocations),
+                static_cast<unsigned long long>(tag.maxFrameAllocations),
+                FormatBytes(tag.liveBytes));
+        }
+
+        ImGui::TextUnformatted("Top churn sites:");
+        for (const AllocationTracker::SiteStats& site : AllocationTracker::GetTopSites(5))
+        {
+            ImGui::Text("  %s [%s] %llu / %llu",
+                site.name,
+                AllocationTracker::TagName(site.tag),
+                static_cast<unsigned long long>(site.allocations),
+                static_cast<unsigned long long>(site.frees));
+        }
+        if (const std::uint64_t violations = AllocationTracker::GetBudgetViolationCount(); violations > 0)
+            ImGui::TextColored(ImVec4(1.0f, 0.45f, 0.35f, 1.0f), "Budget exceeded: %llu frames", static_cast<unsigned long long>(violations));
+        ImGui::TreePop();
+    }
     ImGui::End();
 }
 
@@ -837,6 +1007,7 @@ void EditorLayer::DrawViewport(Application& app, IRenderAdapter* renderer)
     }
 
     DrawGizmo(app, contentMin, viewportSize);
+    PickEntity(app, contentMin, viewportSize);
     ImGui::End();
 }
 
@@ -1120,10 +1291,44 @@ void EditorLayer::DrawGizmo(Application& app, const ImVec2& viewportMin, const I
             std::max(scale[1], 0.001f),
             std::max(scale[2], 0.001f)
         };
+        app.RequestColliderAutoFit(m_SelectedEntity);
     }
     else if (!ImGuizmo::IsUsing())
     {
         m_GizmoUndoCaptured = false;
     }
 }
+
+// Left click in the viewport selects the closest collider under the cursor.
+void EditorLayer::PickEntity(Application& app, const ImVec2& viewportMin, const ImVec2& viewportSize)
+{
+    if (!m_ViewportHovered || !ImGui::IsMouseClicked(ImGuiMouseButton_Left) || ImGuizmo::IsOver() || ImGuizmo::IsUsing())
+        return;
+    if (viewportSize.x <= 1.0f || viewportSize.y <= 1.0f)
+        return;
+
+    const ImVec2 mouse = ImGui::GetMousePos();
+    const float ndcX = (mouse.x - viewportMin.x) / viewportSize.x * 2.0f - 1.0f;
+    const float ndcY = 1.0f - (mouse.y - viewportMin.y) / viewportSize.y * 2.0f;
+    const float tanHalfFov = std::tan(app.GetCameraVerticalFovRadians() * 0.5f);
+    const float aspectRatio = viewportSize.x / viewportSize.y;
+    const ecs::Vec3 forward = BuildCameraForward(app.GetCameraYaw(), app.GetCameraPitch());
+    const ecs::Vec3 right = Normalize(Cross(ecs::Vec3{ 0.0f, 1.0f, 0.0f }, forward));
+    const ecs::Vec3 up = Cross(forward, right);
+    const float rightScale = ndcX * tanHalfFov * aspectRatio;
+    const float upScale = ndcY * tanHalfFov;
+
+    physics::Ray ray;
+    ray.origin = app.GetCameraPosition();
+    ray.direction = Normalize(ecs::Vec3{
+        forward.x + right.x * rightScale + up.x * upScale,
+        forward.y + right.y * rightScale + up.y * upScale,
+        forward.z + right.z * rightScale + up.z * upScale
+    });
+    ray.maxDistance = app.GetCameraFarPlane();
+
+    physics::RaycastHit hit;
+    if (app.RaycastPhysics(ray, hit))
+        m_SelectedEntity = hit.entity;
+}
 }
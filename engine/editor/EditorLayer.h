@@ -8,6 +8,8 @@
 #include "../ecs/components/TagComponent.h"
 #include "../ecs/components/TransformComponent.h"
 
+#include "../core/FrameTaskScheduler.h"
+
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -46,13 +48,15 @@ private:
         EntitySnapshot snapshot;
     };
 
-    void RefreshAssetLists(float dt);
+    void RefreshAssetLists(Application& app, float dt);
+    FrameTaskResult StepAssetScan();
     void HandleEditorShortcuts(Application& app);
     void DrawMainMenu(Application& app);
     void DrawSceneHierarchy(Application& app);
     void DrawInspector(Application& app);
     void DrawStatistics(Application& app, float dt);
     void DrawViewport(Application& app, IRenderAdapter* renderer);
+    void PickEntity(Application& app, const ImVec2& viewportMin, const ImVec2& viewportSize);
     void DrawAssetBrowser(Application& app);
     void DrawMaterialEditor(Application& app);
     void DrawGizmo(Application& app, const ImVec2& viewportMin, const ImVec2& viewportSize);
@@ -88,6 +92,8 @@ private:
     float m_ViewportMaxY = 0.0f;
     float m_AssetRefreshTimer = 0.0f;
     bool m_AssetListsDirty = true;
+    FrameTaskScheduler::TaskId m_AssetScanTask = 0;
+    int m_AssetScanStage = 0;
     std::vector<std::string> m_MeshAssets;
     std::vector<std::string> m_TextureAssets;
     std::vector<std::string> m_MaterialAssets;
@@ -1,8 +1,6 @@
 #include "MenuState.h"
 #include "../../core/Logger.h"
 #include "../../core/Application.h"
-#include "../../platform/GlfwWindow.h"
-#include <GLFW/glfw3.h>
 #include "GameplayState.h"
 
 void MenuState::OnEnter(Application& app)
@@ -14,11 +12,8 @@ void MenuState::OnEnter(Application& app)
 
 void MenuState::Update(Application& app, float)
 {
-    auto* gw = static_cast<GlfwWindow*>(app.GetWindow());
-    GLFWwindow* w = gw->GetGlfwHandle();
-
-    const bool enterMain = app.IsInputActionActive("EnterGameplay") || glfwGetKey(w, GLFW_KEY_ENTER) == GLFW_PRESS;
-    const bool enterKP = glfwGetKey(w, GLFW_KEY_KP_ENTER) == GLFW_PRESS;
+    const bool enterMain = app.IsInputActionActive("EnterGameplay");
+    const bool enterKP = app.IsInputActionActive("EnterGameplayKeypad");
     const bool enter = enterMain || enterKP;
 
     if (enter && !m_PrevEnter)
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../ecs/MathTypes.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace physics
+{
+struct Aabb
+{
+    ecs::Vec3 min;
+    ecs::Vec3 max;
+};
+
+inline bool Overlaps(const Aabb& a, const Aabb& b)
+{
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+inline bool Contains(const Aabb& outer, const Aabb& inner)
+{
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+           outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+inline Aabb Union(const Aabb& a, const Aabb& b)
+{
+    return Aabb{
+        ecs::Vec3{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+        ecs::Vec3{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+    };
+}
+
+// Slab test: whether origin + t * direction lies inside bounds for some t in [0, maxDistance].
+// inverseDirection holds 1 / direction per axis, see InverseRayDirection.
+inline bool RayIntersects(const Aabb& bounds, const ecs::Vec3& origin, const ecs::Vec3& inverseDirection, float maxDistance)
+{
+    float enter = 0.0f;
+    float exit = maxDistance;
+    const auto clip = [&](float minValue, float maxValue, float start, float inverse)
+    {
+        float t0 = (minValue - start) * inverse;
+        float t1 = (maxValue - start) * inverse;
+        if (t0 > t1)
+            std::swap(t0, t1);
+        enter = std::max(enter, t0);
+        exit = std::min(exit, t1);
+    };
+    clip(bounds.min.x, bounds.max.x, origin.x, inverseDirection.x);
+    clip(bounds.min.y, bounds.max.y, origin.y, inverseDirection.y);
+    clip(bounds.min.z, bounds.max.z, origin.z, inverseDirection.z);
+    return enter <= exit;
+}
+
+// Zero components map to a huge finite value instead of infinity, so the slab test never
+// multiplies zero by infinity.
+inline ecs::Vec3 InverseRayDirection(const ecs::Vec3& direction)
+{
+    const auto inverse = [](float value)
+    {
+        constexpr float kHuge = 1.0e30f;
+        if (value > 1.0e-30f || value < -1.0e-30f)
+            return 1.0f / value;
+        return value < 0.0f ? -kHuge : kHuge;
+    };
+    return ecs::Vec3{ inverse(direction.x), inverse(direction.y), inverse(direction.z) };
+}
+
+inline float SurfaceArea(const Aabb& bounds)
+{
+    const float dx = bounds.max.x - bounds.min.x;
+    const float dy = bounds.max.y - bounds.min.y;
+    const float dz = bounds.max.z - bounds.min.z;
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+}
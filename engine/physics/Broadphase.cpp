@@ -0,0 +1,209 @@
+#include "Broadphase.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+physics::BroadphasePair MakePair(physics::ProxyId a, physics::ProxyId b)
+{
+    return a < b ? physics::BroadphasePair{ a, b } : physics::BroadphasePair{ b, a };
+}
+}
+
+namespace physics
+{
+Broadphase::Broadphase(float maxMargin, float relativeMargin)
+    : m_MaxMargin(std::max(maxMargin, 0.0f))
+    , m_RelativeMargin(std::max(relativeMargin, 0.0f))
+{
+}
+
+ProxyId Broadphase::CreateProxy(
+    const Aabb& tightBounds,
+    std::uint32_t userData,
+    bool isStatic,
+    std::uint32_t layer,
+    std::uint32_t mask)
+{
+    ProxyId proxy = kNullProxy;
+    if (!m_FreeProxies.empty())
+    {
+        proxy = m_FreeProxies.back();
+        m_FreeProxies.pop_back();
+    }
+    else
+    {
+        proxy = static_cast<ProxyId>(m_Proxies.size());
+        m_Proxies.emplace_back();
+    }
+
+    Proxy& data = m_Proxies[proxy];
+    data = Proxy{};
+    data.fat = Fatten(tightBounds, ecs::Vec3{});
+    data.userData = userData;
+    data.layer = layer;
+    data.mask = mask;
+    data.isStatic = isStatic;
+    data.alive = true;
+    data.treeNode = TreeFor(data).CreateLeaf(data.fat, proxy);
+    MarkMoved(proxy);
+    return proxy;
+}
+
+void Broadphase::DestroyProxy(ProxyId proxy)
+{
+    Proxy& data = m_Proxies[proxy];
+    if (!data.alive)
+        return;
+
+    TreeFor(data).DestroyLeaf(data.treeNode);
+    data.treeNode = DynamicAabbTree::kNullNode;
+    data.alive = false;
+    data.moved = false;
+    m_PendingFreeProxies.push_back(proxy);
+}
+
+void Broadphase::SetFilter(ProxyId proxy, std::uint32_t layer, std::uint32_t mask)
+{
+    Proxy& data = m_Proxies[proxy];
+    if (data.layer == layer && data.mask == mask)
+        return;
+
+    data.layer = layer;
+    data.mask = mask;
+    MarkMoved(proxy);
+}
+
+bool Broadphase::MoveProxy(ProxyId proxy, const Aabb& tightBounds, const ecs::Vec3& displacement)
+{
+    Proxy& data = m_Proxies[proxy];
+    if (Contains(data.fat, tightBounds))
+        return false;
+
+    data.fat = Fatten(tightBounds, displacement);
+    TreeFor(data).MoveLeaf(data.treeNode, data.fat);
+    MarkMoved(proxy);
+    return true;
+}
+
+void Broadphase::UpdatePairs()
+{
+    m_AddedPairs.clear();
+    m_RemovedPairs.clear();
+
+    // Only pairs touching a moved, refiltered or destroyed proxy can have separated.
+    std::size_t write = 0;
+    for (std::size_t read = 0; read < m_Pairs.size(); ++read)
+    {
+        const BroadphasePair pair = m_Pairs[read];
+        const Proxy& a = m_Proxies[pair.a];
+        const Proxy& b = m_Proxies[pair.b];
+        const bool keep = a.alive && b.alive && (!(a.moved || b.moved) || (Overlaps(a.fat, b.fat) && PassesFilter(a, b)));
+        if (keep)
+            m_Pairs[write++] = pair;
+        else
+            m_RemovedPairs.push_back(pair);
+    }
+    m_Pairs.resize(write);
+
+    m_Candidates.clear();
+    for (const ProxyId proxy : m_MoveBuffer)
+    {
+        if (m_Proxies[proxy].alive && m_Proxies[proxy].moved)
+            CollectPairsFor(proxy);
+    }
+
+    m_LastUpdateStats = BroadphaseUpdateStats{};
+    m_LastUpdateStats.candidates = static_cast<std::uint32_t>(m_Candidates.size());
+    std::sort(m_Candidates.begin(), m_Candidates.end());
+    m_Candidates.erase(std::unique(m_Candidates.begin(), m_Candidates.end()), m_Candidates.end());
+    m_LastUpdateStats.duplicates = m_LastUpdateStats.candidates - static_cast<std::uint32_t>(m_Candidates.size());
+
+    std::set_difference(
+        m_Candidates.begin(), m_Candidates.end(),
+        m_Pairs.begin(), m_Pairs.end(),
+        std::back_inserter(m_AddedPairs));
+
+    if (!m_AddedPairs.empty())
+    {
+        m_MergeScratch.clear();
+        m_MergeScratch.reserve(m_Pairs.size() + m_AddedPairs.size());
+        std::merge(
+            m_Pairs.begin(), m_Pairs.end(),
+            m_AddedPairs.begin(), m_AddedPairs.end(),
+            std::back_inserter(m_MergeScratch));
+        m_Pairs.swap(m_MergeScratch);
+    }
+
+    m_LastUpdateStats.movedProxies = static_cast<std::uint32_t>(m_MoveBuffer.size());
+    m_LastUpdateStats.addedPairs = static_cast<std::uint32_t>(m_AddedPairs.size());
+    m_LastUpdateStats.removedPairs = static_cast<std::uint32_t>(m_RemovedPairs.size());
+    for (const ProxyId proxy : m_MoveBuffer)
+        m_Proxies[proxy].moved = false;
+    m_MoveBuffer.clear();
+
+    m_FreeProxies.insert(m_FreeProxies.end(), m_PendingFreeProxies.begin(), m_PendingFreeProxies.end());
+    m_PendingFreeProxies.clear();
+}
+
+void Broadphase::Clear()
+{
+    m_Proxies.clear();
+    m_FreeProxies.clear();
+    m_PendingFreeProxies.clear();
+    m_StaticTree.Clear();
+    m_DynamicTree.Clear();
+    m_MoveBuffer.clear();
+    m_Pairs.clear();
+    m_Candidates.clear();
+    m_AddedPairs.clear();
+    m_RemovedPairs.clear();
+    m_LastUpdateStats = BroadphaseUpdateStats{};
+}
+
+Aabb Broadphase::Fatten(const Aabb& tightBounds, const ecs::Vec3& displacement) const
+{
+    // A flat margin would pair small props with every neighbour within it; scale it to the proxy.
+    const float smallestHalf = 0.5f * std::min(
+        tightBounds.max.x - tightBounds.min.x,
+        std::min(tightBounds.max.y - tightBounds.min.y, tightBounds.max.z - tightBounds.min.z));
+    const float margin = std::min(m_MaxMargin, m_RelativeMargin * std::max(smallestHalf, 0.0f));
+    Aabb fat{
+        ecs::Vec3{ tightBounds.min.x - margin, tightBounds.min.y - margin, tightBounds.min.z - margin },
+        ecs::Vec3{ tightBounds.max.x + margin, tightBounds.max.y + margin, tightBounds.max.z + margin }
+    };
+
+    // Stretch along the predicted motion so a steadily moving body is not re-inserted every step.
+    const float predict = 2.0f;
+    const ecs::Vec3 d{ displacement.x * predict, displacement.y * predict, displacement.z * predict };
+    (d.x < 0.0f ? fat.min.x : fat.max.x) += d.x;
+    (d.y < 0.0f ? fat.min.y : fat.max.y) += d.y;
+    (d.z < 0.0f ? fat.min.z : fat.max.z) += d.z;
+    return fat;
+}
+
+void Broadphase::MarkMoved(ProxyId proxy)
+{
+    Proxy& data = m_Proxies[proxy];
+    if (data.moved)
+        return;
+    data.moved = true;
+    m_MoveBuffer.push_back(proxy);
+}
+
+void Broadphase::CollectPairsFor(ProxyId proxy)
+{
+    const Proxy& data = m_Proxies[proxy];
+    const auto addCandidate = [&](std::uint32_t other)
+    {
+        const ProxyId otherProxy = static_cast<ProxyId>(other);
+        if (otherProxy != proxy && PassesFilter(data, m_Proxies[otherProxy]))
+            m_Candidates.push_back(MakePair(proxy, otherProxy));
+    };
+
+    m_DynamicTree.Query(data.fat, addCandidate);
+    if (!data.isStatic)
+        m_StaticTree.Query(data.fat, addCandidate);
+}
+}
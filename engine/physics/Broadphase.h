@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Aabb.h"
+#include "DynamicAabbTree.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace physics
+{
+using ProxyId = std::uint32_t;
+inline constexpr ProxyId kNullProxy = UINT32_MAX;
+// Collision layer bits: two proxies pair only when each one's layer shares a bit with the
+// other's mask.
+inline constexpr std::uint32_t kDefaultCollisionLayer = 1u;
+inline constexpr std::uint32_t kAllCollisionLayers = 0xFFFFFFFFu;
+
+struct BroadphasePair
+{
+    ProxyId a = kNullProxy;
+    ProxyId b = kNullProxy;
+
+    friend bool operator==(const BroadphasePair& lhs, const BroadphasePair& rhs)
+    {
+        return lhs.a == rhs.a && lhs.b == rhs.b;
+    }
+
+    friend bool operator<(const BroadphasePair& lhs, const BroadphasePair& rhs)
+    {
+        return lhs.a != rhs.a ? lhs.a < rhs.a : lhs.b < rhs.b;
+    }
+};
+
+// Work done by one UpdatePairs call.
+struct BroadphaseUpdateStats
+{
+    std::uint32_t movedProxies = 0;
+    // Overlaps the moved proxies found in the trees; a pair of two moved proxies is found from
+    // both sides, and the duplicate is dropped.
+    std::uint32_t candidates = 0;
+    std::uint32_t duplicates = 0;
+    std::uint32_t addedPairs = 0;
+    std::uint32_t removedPairs = 0;
+};
+
+// Persistent broadphase: every collider owns a proxy whose AABB is fattened by a margin
+// that scales with its size (up to maxMargin) and by its predicted motion. A proxy is only re-inserted when its tight bounds leave the
+// fat bounds, and overlapping pairs live in a sorted cache that is patched incrementally,
+// so the per-substep cost follows how many bodies actually moved. Static and dynamic
+// proxies live in separate trees; moved dynamic proxies query both, moved statics query
+// only the dynamic tree. Layer filters are applied while pairs are collected, so filtered
+// pairs never reach the pair cache or the narrowphase.
+class Broadphase
+{
+public:
+    // The margin is relativeMargin times the proxy's smallest half extent, capped at maxMargin.
+    explicit Broadphase(float maxMargin = 0.1f, float relativeMargin = 0.2f);
+
+    ProxyId CreateProxy(
+        const Aabb& tightBounds,
+        std::uint32_t userData,
+        bool isStatic,
+        std::uint32_t layer = kDefaultCollisionLayer,
+        std::uint32_t mask = kAllCollisionLayers);
+    void DestroyProxy(ProxyId proxy);
+    // Returns true when the tight bounds escaped the fat bounds and the proxy was re-inserted.
+    bool MoveProxy(ProxyId proxy, const Aabb& tightBounds, const ecs::Vec3& displacement);
+
+    void SetUserData(ProxyId proxy, std::uint32_t userData) { m_Proxies[proxy].userData = userData; }
+    [[nodiscard]] std::uint32_t GetUserData(ProxyId proxy) const { return m_Proxies[proxy].userData; }
+    [[nodiscard]] bool IsStatic(ProxyId proxy) const { return m_Proxies[proxy].isStatic; }
+    // A changed filter re-collects the proxy's pairs on the next UpdatePairs.
+    void SetFilter(ProxyId proxy, std::uint32_t layer, std::uint32_t mask);
+    [[nodiscard]] bool ShouldCollide(ProxyId a, ProxyId b) const { return PassesFilter(m_Proxies[a], m_Proxies[b]); }
+    [[nodiscard]] const Aabb& GetFatAabb(ProxyId proxy) const { return m_Proxies[proxy].fat; }
+    [[nodiscard]] const DynamicAabbTree& GetStaticTree() const { return m_StaticTree; }
+    [[nodiscard]] const DynamicAabbTree& GetDynamicTree() const { return m_DynamicTree; }
+    [[nodiscard]] std::size_t GetProxyCount() const
+    {
+        return m_Proxies.size() - m_FreeProxies.size() - m_PendingFreeProxies.size();
+    }
+
+    // Drops pairs whose fat bounds separated, finds pairs for proxies moved since the last
+    // call, and records both as added/removed notifications.
+    void UpdatePairs();
+
+    // Sorted by (a, b) with a < b; stable between calls except for added/removed pairs.
+    [[nodiscard]] const std::vector<BroadphasePair>& GetPairs() const { return m_Pairs; }
+    [[nodiscard]] const std::vector<BroadphasePair>& GetAddedPairs() const { return m_AddedPairs; }
+    [[nodiscard]] const std::vector<BroadphasePair>& GetRemovedPairs() const { return m_RemovedPairs; }
+    [[nodiscard]] const BroadphaseUpdateStats& GetLastUpdateStats() const { return m_LastUpdateStats; }
+
+    void Clear();
+
+private:
+    struct Proxy
+    {
+        Aabb fat;
+        std::int32_t treeNode = DynamicAabbTree::kNullNode;
+        std::uint32_t userData = 0;
+        std::uint32_t layer = kDefaultCollisionLayer;
+        std::uint32_t mask = kAllCollisionLayers;
+        bool isStatic = false;
+        bool alive = false;
+        bool moved = false;
+    };
+
+    static bool PassesFilter(const Proxy& a, const Proxy& b)
+    {
+        return (a.layer & b.mask) != 0 && (b.layer & a.mask) != 0;
+    }
+    [[nodiscard]] Aabb Fatten(const Aabb& tightBounds, const ecs::Vec3& displacement) const;
+    DynamicAabbTree& TreeFor(const Proxy& proxy) { return proxy.isStatic ? m_StaticTree : m_DynamicTree; }
+    void MarkMoved(ProxyId proxy);
+    void CollectPairsFor(ProxyId proxy);
+
+    float m_MaxMargin = 0.1f;
+    float m_RelativeMargin = 0.2f;
+    DynamicAabbTree m_StaticTree;
+    DynamicAabbTree m_DynamicTree;
+    std::vector<Proxy> m_Proxies;
+    std::vector<ProxyId> m_FreeProxies;
+    // Destroyed ids are recycled only after UpdatePairs dropped their cached pairs.
+    std::vector<ProxyId> m_PendingFreeProxies;
+    std::vector<ProxyId> m_MoveBuffer;
+
+    std::vector<BroadphasePair> m_Pairs;
+    std::vector<BroadphasePair> m_Candidates;
+    std::vector<BroadphasePair> m_AddedPairs;
+    std::vector<BroadphasePair> m_RemovedPairs;
+    std::vector<BroadphasePair> m_MergeScratch;
+    BroadphaseUpdateStats m_LastUpdateStats;
+};
+}
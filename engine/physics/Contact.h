@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../ecs/MathTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace physics
+{
+enum class ContactType : std::uint8_t
+{
+    None,
+    BoxBox,
+    SphereSphere,
+    BoxSphere,
+    // Any pair with a convex hull or triangle-mesh collider.
+    Convex,
+    Count
+};
+inline constexpr std::size_t kContactTypeCount = static_cast<std::size_t>(ContactType::Count);
+
+inline const char* ContactTypeName(ContactType type)
+{
+    switch (type)
+    {
+    case ContactType::None:         return "none";
+    case ContactType::BoxBox:       return "box_box";
+    case ContactType::SphereSphere: return "sphere_sphere";
+    case ContactType::BoxSphere:    return "box_sphere";
+    case ContactType::Convex:       return "convex";
+    default:                        return "unknown";
+    }
+}
+
+// Bodies only carry linear velocity, so one point per pair constrains it fully; the manifold
+// is that point plus the solver state that persists between substeps.
+struct ContactManifold
+{
+    std::uint32_t bodyA = 0;
+    std::uint32_t bodyB = 0;
+    ContactType type = ContactType::None;
+    // Entity indices of the pair and the feature (SAT axis, box region) that produced the
+    // contact; cached impulses are only reused when both match.
+    std::uint64_t pairKey = 0;
+    std::uint32_t featureId = 0;
+    // Points from B towards A; A is pushed along it.
+    ecs::Vec3 normal{ 0.0f, 1.0f, 0.0f };
+    float depth = 0.0f;
+    ecs::Vec3 point{};
+
+    float invMassA = 0.0f;
+    float invMassB = 0.0f;
+    float friction = 0.0f;
+    // Target separating speed along the normal, from restitution.
+    float velocityBias = 0.0f;
+    // Accumulated over the solve and carried to the next substep for warm starting.
+    float normalImpulse = 0.0f;
+    ecs::Vec3 tangentImpulse{};
+};
+
+inline std::uint64_t MakeContactPairKey(std::uint32_t entityA, std::uint32_t entityB)
+{
+    const std::uint32_t low = entityA < entityB ? entityA : entityB;
+    const std::uint32_t high = entityA < entityB ? entityB : entityA;
+    return (static_cast<std::uint64_t>(low) << 32) | high;
+}
+}
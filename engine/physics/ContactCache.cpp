@@ -0,0 +1,42 @@
+#include "ContactCache.h"
+
+#include <algorithm>
+
+namespace physics
+{
+std::size_t ContactCache::WarmStart(std::vector<ContactManifold>& contacts) const
+{
+    std::size_t matched = 0;
+    for (ContactManifold& contact : contacts)
+    {
+        const auto it = std::lower_bound(m_Entries.begin(), m_Entries.end(), contact.pairKey,
+            [](const Entry& entry, std::uint64_t key) { return entry.pairKey < key; });
+        if (it == m_Entries.end() || it->pairKey != contact.pairKey || it->featureId != contact.featureId)
+        {
+            contact.normalImpulse = 0.0f;
+            contact.tangentImpulse = ecs::Vec3{};
+            continue;
+        }
+
+        contact.normalImpulse = it->normalImpulse;
+        contact.tangentImpulse = it->tangentImpulse;
+        ++matched;
+    }
+    return matched;
+}
+
+void ContactCache::Store(const std::vector<ContactManifold>& contacts)
+{
+    m_Entries.clear();
+    Append(contacts);
+}
+
+void ContactCache::Append(const std::vector<ContactManifold>& contacts)
+{
+    m_Entries.reserve(m_Entries.size() + contacts.size());
+    for (const ContactManifold& contact : contacts)
+        m_Entries.push_back(Entry{ contact.pairKey, contact.featureId, contact.normalImpulse, contact.tangentImpulse });
+    std::sort(m_Entries.begin(), m_Entries.end(),
+        [](const Entry& lhs, const Entry& rhs) { return lhs.pairKey < rhs.pairKey; });
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Contact.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace physics
+{
+// Accumulated impulses of the previous substep's contacts, keyed by pair and feature.
+// Only contacts that existed last substep are kept, so a pair that separates starts cold.
+class ContactCache
+{
+public:
+    struct Entry
+    {
+        std::uint64_t pairKey = 0;
+        std::uint32_t featureId = 0;
+        float normalImpulse = 0.0f;
+        ecs::Vec3 tangentImpulse{};
+    };
+
+    // Seeds normalImpulse/tangentImpulse of contacts whose pair and feature were cached.
+    // Returns how many contacts were warm-started.
+    std::size_t WarmStart(std::vector<ContactManifold>& contacts) const;
+    // Replaces the cache with the impulses the solver accumulated for these contacts.
+    void Store(const std::vector<ContactManifold>& contacts);
+    // Like Store, but old entries keep(entry) accepts survive: pairs that were not tested this
+    // substep keep their impulses for the next substep that solves them.
+    template <typename Keep>
+    void Store(const std::vector<ContactManifold>& contacts, Keep&& keep)
+    {
+        std::erase_if(m_Entries, [&](const Entry& entry) { return !keep(entry); });
+        Append(contacts);
+    }
+    void Clear() { m_Entries.clear(); }
+    [[nodiscard]] std::size_t GetSize() const { return m_Entries.size(); }
+    // Sorted by pair; snapshots copy them out and back verbatim.
+    [[nodiscard]] std::span<const Entry> GetEntries() const { return m_Entries; }
+    void SetEntries(std::span<const Entry> entries) { m_Entries.assign(entries.begin(), entries.end()); }
+
+private:
+    void Append(const std::vector<ContactManifold>& contacts);
+
+    std::vector<Entry> m_Entries;
+};
+}
@@ -0,0 +1,321 @@
+#include "ConvexContact.h"
+
+#include <cmath>
+#include <limits>
+
+namespace physics
+{
+namespace
+{
+using ecs::Vec3;
+
+Vec3 Add(const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+Vec3 Scale(const Vec3& v, float s) { return { v.x * s, v.y * s, v.z * s }; }
+float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+Vec3 NormalizeSafe(const Vec3& v)
+{
+    const float len = std::sqrt(Dot(v, v));
+    if (len <= 0.000001f)
+        return Vec3{ 0.0f, 1.0f, 0.0f };
+    return Scale(v, 1.0f / len);
+}
+
+// Edge axes only win over face axes when they are clearly shallower, so resting contacts do
+// not flip between a face and a nearly parallel edge from one substep to the next.
+constexpr float kEdgeRelativeTolerance = 0.95f;
+constexpr float kEdgeAbsoluteTolerance = 0.0005f;
+
+// Box corner i has the sign of half extent x, y, z in bits 0, 1, 2. Faces are +x, -x, +y, -y, +z, -z.
+constexpr HullEdge kBoxEdges[12] = {
+    { 0, 1, 3, 5 }, { 2, 3, 2, 5 }, { 4, 5, 3, 4 }, { 6, 7, 2, 4 },
+    { 0, 2, 1, 5 }, { 1, 3, 0, 5 }, { 4, 6, 1, 4 }, { 5, 7, 0, 4 },
+    { 0, 4, 1, 3 }, { 1, 5, 0, 3 }, { 2, 6, 1, 2 }, { 3, 7, 0, 2 } };
+
+void Project(std::span<const Vec3> vertices, const Vec3& axis, float& outMin, float& outMax)
+{
+    outMin = std::numeric_limits<float>::max();
+    outMax = -std::numeric_limits<float>::max();
+    for (const Vec3& v : vertices)
+    {
+        const float d = Dot(v, axis);
+        outMin = d < outMin ? d : outMin;
+        outMax = d > outMax ? d : outMax;
+    }
+}
+
+Vec3 Support(const ConvexView& view, const Vec3& direction)
+{
+    std::size_t best = 0;
+    float bestDot = -std::numeric_limits<float>::max();
+    for (std::size_t i = 0; i < view.vertices.size(); ++i)
+    {
+        const float d = Dot(view.vertices[i], direction);
+        if (d > bestDot)
+        {
+            bestDot = d;
+            best = i;
+        }
+    }
+    return Add(view.origin, view.vertices[best]);
+}
+
+Vec3 ClosestPointOnTriangle(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c)
+{
+    const Vec3 ab = Sub(b, a);
+    const Vec3 ac = Sub(c, a);
+    const Vec3 ap = Sub(p, a);
+    const float d1 = Dot(ab, ap);
+    const float d2 = Dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+    const Vec3 bp = Sub(p, b);
+    const float d3 = Dot(ab, bp);
+    const float d4 = Dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+        return b;
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return Add(a, Scale(ab, d1 / (d1 - d3)));
+
+    const Vec3 cp = Sub(p, c);
+    const float d5 = Dot(ab, cp);
+    const float d6 = Dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+        return c;
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return Add(a, Scale(ac, d2 / (d2 - d6)));
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return Add(b, Scale(Sub(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6))));
+
+    const float denominator = 1.0f / (va + vb + vc);
+    return Add(a, Add(Scale(ab, vb * denominator), Scale(ac, vc * denominator)));
+}
+}
+
+BoxPolytope::BoxPolytope(const ecs::Vec3& halfExtents, const BoxAxes& axes, const BoxAxes& faceAxes)
+{
+    const Vec3 x = Scale(axes.xAxis, halfExtents.x);
+    const Vec3 y = Scale(axes.yAxis, halfExtents.y);
+    const Vec3 z = Scale(axes.zAxis, halfExtents.z);
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        vertices[corner] = Add(
+            Add(Scale(x, (corner & 1) ? 1.0f : -1.0f), Scale(y, (corner & 2) ? 1.0f : -1.0f)),
+            Scale(z, (corner & 4) ? 1.0f : -1.0f));
+    }
+    faceNormals[0] = faceAxes.xAxis;
+    faceNormals[1] = Scale(faceAxes.xAxis, -1.0f);
+    faceNormals[2] = faceAxes.yAxis;
+    faceNormals[3] = Scale(faceAxes.yAxis, -1.0f);
+    faceNormals[4] = faceAxes.zAxis;
+    faceNormals[5] = Scale(faceAxes.zAxis, -1.0f);
+}
+
+ConvexView BoxPolytope::View(const ecs::Vec3& center) const
+{
+    return ConvexView{ center, vertices, faceNormals, kBoxEdges };
+}
+
+TrianglePolytope::TrianglePolytope(const ecs::Vec3& a, const ecs::Vec3& b, const ecs::Vec3& c)
+    : vertices{ a, b, c }
+{
+    const Vec3 normal = NormalizeSafe(Cross(Sub(b, a), Sub(c, a)));
+    faceNormals[0] = normal;
+    faceNormals[1] = Scale(normal, -1.0f);
+    for (std::uint32_t edge = 0; edge < 3; ++edge)
+    {
+        const std::uint32_t next = (edge + 1) % 3;
+        // Counter-clockwise around the normal, so edge x normal points out of the triangle.
+        faceNormals[2 + edge] = NormalizeSafe(Cross(Sub(vertices[next], vertices[edge]), normal));
+        edges[edge * 2] = HullEdge{ edge, next, 0, 2 + edge };
+        edges[edge * 2 + 1] = HullEdge{ edge, next, 2 + edge, 1 };
+    }
+}
+
+ConvexView TrianglePolytope::View(const ecs::Vec3& origin) const
+{
+    return ConvexView{ origin, vertices, faceNormals, edges };
+}
+
+bool IsMinkowskiFace(const ecs::Vec3& a, const ecs::Vec3& b, const ecs::Vec3& c, const ecs::Vec3& d)
+{
+    const Vec3 bxa = Cross(b, a);
+    const Vec3 dxc = Cross(d, c);
+    const float cba = Dot(c, bxa);
+    const float dba = Dot(d, bxa);
+    const float adc = Dot(a, dxc);
+    const float bdc = Dot(b, dxc);
+    return cba * dba < 0.0f && adc * bdc < 0.0f && cba * bdc > 0.0f;
+}
+
+bool CollideConvex(const ConvexView& a, const ConvexView& b, ConvexContact& out)
+{
+    const Vec3 delta = Sub(a.origin, b.origin);
+    float faceDepth = std::numeric_limits<float>::max();
+    Vec3 faceNormal{};
+    std::uint32_t faceFeature = 0;
+    float edgeDepth = std::numeric_limits<float>::max();
+    Vec3 edgeNormal{};
+    std::uint32_t edgeFeature = 0;
+
+    // False once the axis separates the shapes; otherwise keeps the shallower way out along it.
+    const auto testAxis = [&](const Vec3& axis, std::uint32_t feature, float& bestDepth, Vec3& bestNormal, std::uint32_t& bestFeature)
+    {
+        float minA = 0.0f;
+        float maxA = 0.0f;
+        float minB = 0.0f;
+        float maxB = 0.0f;
+        Project(a.vertices, axis, minA, maxA);
+        Project(b.vertices, axis, minB, maxB);
+        const float shift = Dot(delta, axis);
+        // A moves along +axis by up, or along -axis by down, to clear B.
+        const float up = maxB - (minA + shift);
+        const float down = (maxA + shift) - minB;
+        if (up <= 0.0f || down <= 0.0f)
+            return false;
+        const float depth = up < down ? up : down;
+        if (depth < bestDepth)
+        {
+            bestDepth = depth;
+            bestNormal = up < down ? axis : Scale(axis, -1.0f);
+            bestFeature = feature;
+        }
+        return true;
+    };
+
+    const auto faceCountA = static_cast<std::uint32_t>(a.faceNormals.size());
+    const auto faceCountB = static_cast<std::uint32_t>(b.faceNormals.size());
+    for (std::uint32_t face = 0; face < faceCountA; ++face)
+    {
+        if (!testAxis(a.faceNormals[face], face, faceDepth, faceNormal, faceFeature))
+            return false;
+    }
+    for (std::uint32_t face = 0; face < faceCountB; ++face)
+    {
+        if (!testAxis(b.faceNormals[face], faceCountA + face, faceDepth, faceNormal, faceFeature))
+            return false;
+    }
+
+    for (std::uint32_t edgeA = 0; edgeA < a.edges.size(); ++edgeA)
+    {
+        const HullEdge& ea = a.edges[edgeA];
+        const Vec3 directionA = Sub(a.vertices[ea.vertex1], a.vertices[ea.vertex0]);
+        for (std::uint32_t edgeB = 0; edgeB < b.edges.size(); ++edgeB)
+        {
+            const HullEdge& eb = b.edges[edgeB];
+            if (!IsMinkowskiFace(
+                    a.faceNormals[ea.face0], a.faceNormals[ea.face1],
+                    Scale(b.faceNormals[eb.face0], -1.0f), Scale(b.faceNormals[eb.face1], -1.0f)))
+            {
+                continue;
+            }
+            const Vec3 directionB = Sub(b.vertices[eb.vertex1], b.vertices[eb.vertex0]);
+            const Vec3 axis = Cross(directionA, directionB);
+            const float lengthSq = Dot(axis, axis);
+            if (lengthSq <= 1.0e-6f * Dot(directionA, directionA) * Dot(directionB, directionB))
+                continue;
+            const std::uint32_t feature = faceCountA + faceCountB + edgeA * static_cast<std::uint32_t>(b.edges.size()) + edgeB;
+            if (!testAxis(Scale(axis, 1.0f / std::sqrt(lengthSq)), feature, edgeDepth, edgeNormal, edgeFeature))
+                return false;
+        }
+    }
+
+    const bool useEdge = edgeDepth < faceDepth * kEdgeRelativeTolerance - kEdgeAbsoluteTolerance;
+    out.normal = useEdge ? edgeNormal : faceNormal;
+    out.depth = useEdge ? edgeDepth : faceDepth;
+    out.featureId = useEdge ? edgeFeature : faceFeature;
+    // Halfway between the deepest points of the two shapes along the normal.
+    out.point = Scale(Add(Support(a, Scale(out.normal, -1.0f)), Support(b, out.normal)), 0.5f);
+    return out.depth > 0.0f;
+}
+
+bool CollideSphereHull(
+    const ecs::Vec3& center,
+    float radius,
+    const ConvexView& hull,
+    std::span<const std::uint32_t> triangles,
+    ConvexContact& out)
+{
+    const Vec3 local = Sub(center, hull.origin);
+    const auto faceCount = static_cast<std::uint32_t>(hull.faceNormals.size());
+    float maxDistance = -std::numeric_limits<float>::max();
+    std::uint32_t maxFace = 0;
+    for (std::uint32_t face = 0; face < faceCount; ++face)
+    {
+        const float distance = Dot(hull.faceNormals[face], Sub(local, hull.vertices[triangles[face * 3]]));
+        if (distance > maxDistance)
+        {
+            maxDistance = distance;
+            maxFace = face;
+        }
+    }
+    if (maxDistance >= radius)
+        return false;
+
+    if (maxDistance <= 0.0f)
+    {
+        // Centre inside: leave through the nearest face plane.
+        out.normal = hull.faceNormals[maxFace];
+        out.depth = radius - maxDistance;
+        out.point = Add(hull.origin, Sub(local, Scale(out.normal, maxDistance)));
+        out.featureId = maxFace;
+        return true;
+    }
+
+    // Centre outside: the closest surface point lies on a face the centre is in front of.
+    float bestDistanceSq = radius * radius;
+    Vec3 bestPoint{};
+    std::uint32_t bestFace = faceCount;
+    for (std::uint32_t face = 0; face < faceCount; ++face)
+    {
+        const Vec3& a = hull.vertices[triangles[face * 3]];
+        if (Dot(hull.faceNormals[face], Sub(local, a)) <= 0.0f)
+            continue;
+        const Vec3 closest = ClosestPointOnTriangle(local, a, hull.vertices[triangles[face * 3 + 1]], hull.vertices[triangles[face * 3 + 2]]);
+        const Vec3 d = Sub(local, closest);
+        if (Dot(d, d) < bestDistanceSq)
+        {
+            bestDistanceSq = Dot(d, d);
+            bestPoint = closest;
+            bestFace = face;
+        }
+    }
+    if (bestFace == faceCount)
+        return false;
+    const float distance = std::sqrt(bestDistanceSq);
+    out.normal = distance > 0.000001f ? Scale(Sub(local, bestPoint), 1.0f / distance) : hull.faceNormals[bestFace];
+    out.depth = radius - distance;
+    out.point = Add(hull.origin, bestPoint);
+    out.featureId = bestFace;
+    return out.depth > 0.0f;
+}
+
+bool CollideSphereTriangle(
+    const ecs::Vec3& center,
+    float radius,
+    const ecs::Vec3& a,
+    const ecs::Vec3& b,
+    const ecs::Vec3& c,
+    ConvexContact& out)
+{
+    const Vec3 closest = ClosestPointOnTriangle(center, a, b, c);
+    const Vec3 d = Sub(center, closest);
+    const float distanceSq = Dot(d, d);
+    if (distanceSq >= radius * radius)
+        return false;
+    const float distance = std::sqrt(distanceSq);
+    out.normal = distance > 0.000001f ? Scale(d, 1.0f / distance) : NormalizeSafe(Cross(Sub(b, a), Sub(c, a)));
+    out.depth = radius - distance;
+    out.point = closest;
+    out.featureId = 0;
+    return out.depth > 0.0f;
+}
+}
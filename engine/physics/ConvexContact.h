@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ConvexHull.h"
+#include "NarrowphaseKernels.h"
+
+#include <cstdint>
+#include <span>
+
+namespace physics
+{
+// A convex polytope for the separating-axis tests: vertices relative to origin, unit outward
+// face normals and the edges between faces. Views never own their arrays.
+struct ConvexView
+{
+    ecs::Vec3 origin{};
+    std::span<const ecs::Vec3> vertices;
+    std::span<const ecs::Vec3> faceNormals;
+    std::span<const HullEdge> edges;
+};
+
+// An oriented box as a polytope around its centre.
+struct BoxPolytope
+{
+    // axes are the box's rotation columns, faceAxes their normalized copies.
+    BoxPolytope(const ecs::Vec3& halfExtents, const BoxAxes& axes, const BoxAxes& faceAxes);
+    [[nodiscard]] ConvexView View(const ecs::Vec3& center) const;
+
+    ecs::Vec3 vertices[8];
+    ecs::Vec3 faceNormals[6];
+};
+
+// A triangle as a flat polytope. Its faces are both sides of its plane plus the three outward
+// side planes, and each edge is listed once per side, so the Gauss-map culling of edge pairs
+// works on triangles exactly as on hulls.
+struct TrianglePolytope
+{
+    TrianglePolytope(const ecs::Vec3& a, const ecs::Vec3& b, const ecs::Vec3& c);
+    [[nodiscard]] ConvexView View(const ecs::Vec3& origin) const;
+
+    ecs::Vec3 vertices[3];
+    ecs::Vec3 faceNormals[5];
+    HullEdge edges[6];
+};
+
+struct ConvexContact
+{
+    // Points from B towards A; A is pushed along it by depth.
+    ecs::Vec3 normal{ 0.0f, 1.0f, 0.0f };
+    float depth = 0.0f;
+    ecs::Vec3 point{};
+    // SAT axis (faces of A, then faces of B, then edge pairs) or the closest face.
+    std::uint32_t featureId = 0;
+};
+
+// Separating-axis test over the face normals of both polytopes and the edge pairs that form
+// a face of their Minkowski difference. Returns false when they do not overlap.
+bool CollideConvex(const ConvexView& a, const ConvexView& b, ConvexContact& out);
+// Sphere A against a hull B whose faces are the triangles (three vertex indices each).
+bool CollideSphereHull(
+    const ecs::Vec3& center,
+    float radius,
+    const ConvexView& hull,
+    std::span<const std::uint32_t> triangles,
+    ConvexContact& out);
+// Sphere A against triangle B; a, b and c are world positions.
+bool CollideSphereTriangle(
+    const ecs::Vec3& center,
+    float radius,
+    const ecs::Vec3& a,
+    const ecs::Vec3& b,
+    const ecs::Vec3& c,
+    ConvexContact& out);
+
+// Whether the Gauss-map arcs a-b and c-d cross. For an edge of A with face normals a, b and an
+// edge of B with face normals c, d, the arcs a-b and (-c)-(-d) crossing means the edges form a
+// face of the Minkowski difference A - B; only those edge pairs can be the separating axis.
+bool IsMinkowskiFace(const ecs::Vec3& a, const ecs::Vec3& b, const ecs::Vec3& c, const ecs::Vec3& d);
+}
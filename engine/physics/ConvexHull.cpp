@@ -0,0 +1,358 @@
+#include "ConvexHull.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace physics
+{
+namespace
+{
+using ecs::Vec3;
+
+Vec3 Add(const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+Vec3 Scale(const Vec3& v, float s) { return { v.x * s, v.y * s, v.z * s }; }
+float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+
+constexpr std::uint32_t kNoFace = std::numeric_limits<std::uint32_t>::max();
+
+struct Face
+{
+    std::uint32_t vertex[3] = { 0, 0, 0 };
+    Vec3 normal{};
+    float offset = 0.0f;
+    // Points above this face that no earlier face claimed.
+    std::vector<std::uint32_t> outside;
+    bool alive = true;
+};
+
+std::uint64_t EdgeKey(std::uint32_t from, std::uint32_t to)
+{
+    return (static_cast<std::uint64_t>(from) << 32) | to;
+}
+
+class Quickhull
+{
+public:
+    Quickhull(std::span<const Vec3> points, float epsilon)
+        : m_Points(points)
+        , m_Epsilon(epsilon)
+    {}
+
+    bool BuildSimplex();
+    // Adds the farthest outside point to the hull; false once no point lies outside.
+    bool AddFarthestPoint();
+    ConvexHull Finish() const;
+    std::size_t GetVertexCount() const { return m_VertexCount; }
+
+private:
+    float Distance(const Face& face, std::uint32_t point) const { return Dot(face.normal, m_Points[point]) - face.offset; }
+    std::uint32_t AddFace(std::uint32_t a, std::uint32_t b, std::uint32_t c);
+    void RemoveFace(std::uint32_t face);
+    void AssignOutside(std::uint32_t point, std::span<const std::uint32_t> faces);
+
+    std::span<const Vec3> m_Points;
+    float m_Epsilon = 0.0f;
+    std::vector<Face> m_Faces;
+    // Directed edge (from, to) of every live face, counter-clockwise; its twin (to, from) is the neighbour.
+    std::unordered_map<std::uint64_t, std::uint32_t> m_EdgeFaces;
+    std::size_t m_VertexCount = 0;
+};
+
+std::uint32_t Quickhull::AddFace(std::uint32_t a, std::uint32_t b, std::uint32_t c)
+{
+    Face face;
+    face.vertex[0] = a;
+    face.vertex[1] = b;
+    face.vertex[2] = c;
+    const Vec3 normal = Cross(Sub(m_Points[b], m_Points[a]), Sub(m_Points[c], m_Points[a]));
+    const float length = std::sqrt(Dot(normal, normal));
+    // A sliver the new point forms with a horizon edge keeps a zero normal; nothing is ever
+    // above it, and its neighbours still close the surface.
+    face.normal = length > 0.0f ? Scale(normal, 1.0f / length) : Vec3{};
+    face.offset = Dot(face.normal, m_Points[a]);
+    const auto index = static_cast<std::uint32_t>(m_Faces.size());
+    m_Faces.push_back(std::move(face));
+    m_EdgeFaces[EdgeKey(a, b)] = index;
+    m_EdgeFaces[EdgeKey(b, c)] = index;
+    m_EdgeFaces[EdgeKey(c, a)] = index;
+    return index;
+}
+
+void Quickhull::RemoveFace(std::uint32_t index)
+{
+    Face& face = m_Faces[index];
+    face.alive = false;
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto it = m_EdgeFaces.find(EdgeKey(face.vertex[i], face.vertex[(i + 1) % 3]));
+        if (it != m_EdgeFaces.end() && it->second == index)
+            m_EdgeFaces.erase(it);
+    }
+}
+
+void Quickhull::AssignOutside(std::uint32_t point, std::span<const std::uint32_t> faces)
+{
+    for (const std::uint32_t face : faces)
+    {
+        if (Distance(m_Faces[face], point) > m_Epsilon)
+        {
+            m_Faces[face].outside.push_back(point);
+            return;
+        }
+    }
+}
+
+// The two most distant axis extremes, the point farthest from their line, then the point
+// farthest from their plane.
+bool Quickhull::BuildSimplex()
+{
+    std::uint32_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+    for (std::uint32_t i = 0; i < m_Points.size(); ++i)
+    {
+        const Vec3& p = m_Points[i];
+        if (p.x < m_Points[extremes[0]].x) extremes[0] = i;
+        if (p.x > m_Points[extremes[1]].x) extremes[1] = i;
+        if (p.y < m_Points[extremes[2]].y) extremes[2] = i;
+        if (p.y > m_Points[extremes[3]].y) extremes[3] = i;
+        if (p.z < m_Points[extremes[4]].z) extremes[4] = i;
+        if (p.z > m_Points[extremes[5]].z) extremes[5] = i;
+    }
+
+    std::uint32_t simplex[4] = { 0, 0, 0, 0 };
+    float best = 0.0f;
+    for (int i = 0; i < 6; ++i)
+    {
+        for (int j = i + 1; j < 6; ++j)
+        {
+            const Vec3 d = Sub(m_Points[extremes[i]], m_Points[extremes[j]]);
+            if (Dot(d, d) > best)
+            {
+                best = Dot(d, d);
+                simplex[0] = extremes[i];
+                simplex[1] = extremes[j];
+            }
+        }
+    }
+    if (best <= m_Epsilon * m_Epsilon)
+        return false;
+
+    const Vec3 lineOrigin = m_Points[simplex[0]];
+    const Vec3 lineDirection = Sub(m_Points[simplex[1]], lineOrigin);
+    best = 0.0f;
+    for (std::uint32_t i = 0; i < m_Points.size(); ++i)
+    {
+        const Vec3 c = Cross(Sub(m_Points[i], lineOrigin), lineDirection);
+        if (Dot(c, c) > best)
+        {
+            best = Dot(c, c);
+            simplex[2] = i;
+        }
+    }
+    if (best <= m_Epsilon * m_Epsilon * Dot(lineDirection, lineDirection))
+        return false;
+
+    Vec3 planeNormal = Cross(lineDirection, Sub(m_Points[simplex[2]], lineOrigin));
+    planeNormal = Scale(planeNormal, 1.0f / std::sqrt(Dot(planeNormal, planeNormal)));
+    best = 0.0f;
+    for (std::uint32_t i = 0; i < m_Points.size(); ++i)
+    {
+        const float distance = std::abs(Dot(planeNormal, Sub(m_Points[i], lineOrigin)));
+        if (distance > best)
+        {
+            best = distance;
+            simplex[3] = i;
+        }
+    }
+    if (best <= m_Epsilon)
+        return false;
+
+    // Wind every face so its normal points away from the opposite vertex.
+    const std::uint32_t faceVertices[4][3] = {
+        { simplex[0], simplex[1], simplex[2] },
+        { simplex[0], simplex[3], simplex[1] },
+        { simplex[1], simplex[3], simplex[2] },
+        { simplex[2], simplex[3], simplex[0] } };
+    const bool flip = Dot(planeNormal, Sub(m_Points[simplex[3]], lineOrigin)) > 0.0f;
+    std::uint32_t faces[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        const std::uint32_t* v = faceVertices[i];
+        faces[i] = flip ? AddFace(v[0], v[2], v[1]) : AddFace(v[0], v[1], v[2]);
+    }
+    m_VertexCount = 4;
+
+    for (std::uint32_t i = 0; i < m_Points.size(); ++i)
+    {
+        if (i != simplex[0] && i != simplex[1] && i != simplex[2] && i != simplex[3])
+            AssignOutside(i, faces);
+    }
+    return true;
+}
+
+bool Quickhull::AddFarthestPoint()
+{
+    std::uint32_t startFace = kNoFace;
+    std::uint32_t eye = 0;
+    float best = m_Epsilon;
+    for (std::uint32_t f = 0; f < m_Faces.size(); ++f)
+    {
+        const Face& face = m_Faces[f];
+        if (!face.alive)
+            continue;
+        for (const std::uint32_t point : face.outside)
+        {
+            const float distance = Distance(face, point);
+            if (distance > best)
+            {
+                best = distance;
+                startFace = f;
+                eye = point;
+            }
+        }
+    }
+    if (startFace == kNoFace)
+        return false;
+
+    // Flood the faces the eye point sees; edges from a visible to a hidden face form the horizon.
+    std::vector<std::uint32_t> visible{ startFace };
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> horizon;
+    std::vector<std::uint8_t> state(m_Faces.size(), 0);
+    state[startFace] = 1;
+    for (std::size_t next = 0; next < visible.size(); ++next)
+    {
+        const Face& face = m_Faces[visible[next]];
+        for (int i = 0; i < 3; ++i)
+        {
+            const std::uint32_t from = face.vertex[i];
+            const std::uint32_t to = face.vertex[(i + 1) % 3];
+            const auto twin = m_EdgeFaces.find(EdgeKey(to, from));
+            if (twin == m_EdgeFaces.end())
+                continue;
+            const std::uint32_t neighbour = twin->second;
+            if (state[neighbour] == 0)
+            {
+                state[neighbour] = Distance(m_Faces[neighbour], eye) > m_Epsilon ? 1 : 2;
+                if (state[neighbour] == 1)
+                    visible.push_back(neighbour);
+            }
+            if (state[neighbour] == 2)
+                horizon.emplace_back(from, to);
+        }
+    }
+
+    std::vector<std::uint32_t> orphans;
+    for (const std::uint32_t face : visible)
+    {
+        for (const std::uint32_t point : m_Faces[face].outside)
+        {
+            if (point != eye)
+                orphans.push_back(point);
+        }
+        m_Faces[face].outside.clear();
+        RemoveFace(face);
+    }
+
+    std::vector<std::uint32_t> created;
+    created.reserve(horizon.size());
+    for (const auto& [from, to] : horizon)
+        created.push_back(AddFace(from, to, eye));
+    for (const std::uint32_t point : orphans)
+        AssignOutside(point, created);
+    ++m_VertexCount;
+    return true;
+}
+
+ConvexHull Quickhull::Finish() const
+{
+    ConvexHull hull;
+    std::vector<std::uint32_t> remap(m_Points.size(), kNoFace);
+    std::vector<std::uint32_t> faceIndex(m_Faces.size(), kNoFace);
+    for (std::uint32_t f = 0; f < m_Faces.size(); ++f)
+    {
+        const Face& face = m_Faces[f];
+        if (!face.alive)
+            continue;
+        faceIndex[f] = static_cast<std::uint32_t>(hull.triangles.size() / 3);
+        for (const std::uint32_t point : face.vertex)
+        {
+            if (remap[point] == kNoFace)
+            {
+                remap[point] = static_cast<std::uint32_t>(hull.vertices.size());
+                hull.vertices.push_back(m_Points[point]);
+            }
+            hull.triangles.push_back(remap[point]);
+        }
+    }
+
+    // Every edge is shared by two faces in opposite directions; keep the direction with from < to.
+    for (std::uint32_t f = 0; f < m_Faces.size(); ++f)
+    {
+        const Face& face = m_Faces[f];
+        if (!face.alive)
+            continue;
+        for (int i = 0; i < 3; ++i)
+        {
+            const std::uint32_t from = face.vertex[i];
+            const std::uint32_t to = face.vertex[(i + 1) % 3];
+            if (from > to)
+                continue;
+            const auto twin = m_EdgeFaces.find(EdgeKey(to, from));
+            if (twin == m_EdgeFaces.end())
+                continue;
+            hull.edges.push_back(HullEdge{ remap[from], remap[to], faceIndex[f], faceIndex[twin->second] });
+        }
+    }
+    return hull;
+}
+}
+
+ConvexHull BuildConvexHull(std::span<const ecs::Vec3> points, std::size_t maxVertices)
+{
+    if (points.size() < 4 || maxVertices < 4)
+        return {};
+
+    // Coplanarity tolerance relative to the size of the point cloud.
+    Vec3 maxAbs{};
+    for (const Vec3& p : points)
+    {
+        maxAbs.x = std::max(maxAbs.x, std::abs(p.x));
+        maxAbs.y = std::max(maxAbs.y, std::abs(p.y));
+        maxAbs.z = std::max(maxAbs.z, std::abs(p.z));
+    }
+    const float epsilon = 3.0f * std::numeric_limits<float>::epsilon() * (maxAbs.x + maxAbs.y + maxAbs.z);
+
+    Quickhull quickhull(points, epsilon);
+    if (!quickhull.BuildSimplex())
+        return {};
+    while (quickhull.GetVertexCount() < maxVertices && quickhull.AddFarthestPoint())
+    {
+    }
+    return quickhull.Finish();
+}
+
+void ComputeHullFaceNormals(std::span<const ecs::Vec3> vertices, std::span<const std::uint32_t> triangles, ecs::Vec3* outNormals)
+{
+    Vec3 centroid{};
+    for (const Vec3& v : vertices)
+        centroid = Add(centroid, v);
+    if (!vertices.empty())
+        centroid = Scale(centroid, 1.0f / static_cast<float>(vertices.size()));
+
+    for (std::size_t face = 0; face * 3 + 2 < triangles.size(); ++face)
+    {
+        const Vec3& a = vertices[triangles[face * 3]];
+        const Vec3& b = vertices[triangles[face * 3 + 1]];
+        const Vec3& c = vertices[triangles[face * 3 + 2]];
+        Vec3 normal = Cross(Sub(b, a), Sub(c, a));
+        const float length = std::sqrt(Dot(normal, normal));
+        normal = length > 0.0f ? Scale(normal, 1.0f / length) : Vec3{ 0.0f, 1.0f, 0.0f };
+        if (Dot(normal, Sub(a, centroid)) < 0.0f)
+            normal = Scale(normal, -1.0f);
+        outNormals[face] = normal;
+    }
+}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "NarrowphaseKernels.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace physics
+{
+// Hulls are cut down to this many vertices when they are baked. Contact tests scale with the
+// vertex and edge count, and quickhull adds the farthest points first, so the hull stays close.
+inline constexpr std::size_t kMaxHullVertices = 32;
+
+// An edge between two faces of a convex polytope.
+struct HullEdge
+{
+    std::uint32_t vertex0 = 0;
+    std::uint32_t vertex1 = 0;
+    std::uint32_t face0 = 0;
+    std::uint32_t face1 = 0;
+};
+
+struct ConvexHull
+{
+    std::vector<ecs::Vec3> vertices;
+    // Three vertex indices per face, counter-clockwise seen from outside; face i is triangle i.
+    std::vector<std::uint32_t> triangles;
+    std::vector<HullEdge> edges;
+
+    [[nodiscard]] bool IsValid() const { return vertices.size() >= 4 && triangles.size() >= 12; }
+    [[nodiscard]] std::size_t GetFaceCount() const { return triangles.size() / 3; }
+};
+
+// Quickhull over the points. Fewer than four points, or points that are all coplanar, give an
+// empty (invalid) hull.
+ConvexHull BuildConvexHull(std::span<const ecs::Vec3> points, std::size_t maxVertices = kMaxHullVertices);
+
+// Unit outward normal of every face, one per triangle. Works on transformed vertices, so
+// non-uniform scale and mirroring need no special care.
+void ComputeHullFaceNormals(std::span<const ecs::Vec3> vertices, std::span<const std::uint32_t> triangles, ecs::Vec3* outNormals);
+
+// v scaled per axis, then rotated by the box axes (the rotation columns).
+inline ecs::Vec3 ScaleRotate(const BoxAxes& axes, const ecs::Vec3& scale, const ecs::Vec3& v)
+{
+    const float x = v.x * scale.x;
+    const float y = v.y * scale.y;
+    const float z = v.z * scale.z;
+    return ecs::Vec3{
+        axes.xAxis.x * x + axes.yAxis.x * y + axes.zAxis.x * z,
+        axes.xAxis.y * x + axes.yAxis.y * y + axes.zAxis.y * z,
+        axes.xAxis.z * x + axes.yAxis.z * y + axes.zAxis.z * z
+    };
+}
+}
@@ -0,0 +1,290 @@
+#include "DynamicAabbTree.h"
+
+#include <algorithm>
+
+namespace physics
+{
+std::int32_t DynamicAabbTree::CreateLeaf(const Aabb& bounds, std::uint32_t userData)
+{
+    const std::int32_t leaf = AllocateNode();
+    Node& node = m_Nodes[static_cast<std::size_t>(leaf)];
+    node.bounds = bounds;
+    node.userData = userData;
+    node.height = 0;
+    InsertLeaf(leaf);
+    ++m_LeafCount;
+    return leaf;
+}
+
+void DynamicAabbTree::DestroyLeaf(std::int32_t leaf)
+{
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+    --m_LeafCount;
+}
+
+void DynamicAabbTree::MoveLeaf(std::int32_t leaf, const Aabb& bounds)
+{
+    RemoveLeaf(leaf);
+    m_Nodes[static_cast<std::size_t>(leaf)].bounds = bounds;
+    InsertLeaf(leaf);
+}
+
+void DynamicAabbTree::Clear()
+{
+    m_Nodes.clear();
+    m_Root = kNullNode;
+    m_FreeList = kNullNode;
+    m_LeafCount = 0;
+}
+
+std::int32_t DynamicAabbTree::GetHeight() const
+{
+    return m_Root == kNullNode ? 0 : m_Nodes[static_cast<std::size_t>(m_Root)].height;
+}
+
+std::int32_t DynamicAabbTree::AllocateNode()
+{
+    if (m_FreeList == kNullNode)
+    {
+        m_Nodes.emplace_back();
+        return static_cast<std::int32_t>(m_Nodes.size() - 1);
+    }
+
+    const std::int32_t node = m_FreeList;
+    m_FreeList = m_Nodes[static_cast<std::size_t>(node)].parent;
+    m_Nodes[static_cast<std::size_t>(node)] = Node{};
+    return node;
+}
+
+void DynamicAabbTree::FreeNode(std::int32_t node)
+{
+    Node& data = m_Nodes[static_cast<std::size_t>(node)];
+    data.parent = m_FreeList;
+    data.child1 = kNullNode;
+    data.child2 = kNullNode;
+    data.height = -1;
+    m_FreeList = node;
+}
+
+std::int32_t DynamicAabbTree::FindBestSibling(const Aabb& bounds) const
+{
+    std::int32_t index = m_Root;
+    while (!m_Nodes[static_cast<std::size_t>(index)].IsLeaf())
+    {
+        const Node& node = m_Nodes[static_cast<std::size_t>(index)];
+        const float area = SurfaceArea(node.bounds);
+        const float combinedArea = SurfaceArea(Union(node.bounds, bounds));
+
+        // Cost of making a new parent here versus pushing the leaf further down.
+        const float cost = 2.0f * combinedArea;
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        const auto descendCost = [&](std::int32_t childIndex)
+        {
+            const Node& child = m_Nodes[static_cast<std::size_t>(childIndex)];
+            const float unionArea = SurfaceArea(Union(child.bounds, bounds));
+            return child.IsLeaf()
+                ? unionArea + inheritanceCost
+                : unionArea - SurfaceArea(child.bounds) + inheritanceCost;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+    return index;
+}
+
+void DynamicAabbTree::InsertLeaf(std::int32_t leaf)
+{
+    if (m_Root == kNullNode)
+    {
+        m_Root = leaf;
+        m_Nodes[static_cast<std::size_t>(leaf)].parent = kNullNode;
+        return;
+    }
+
+    const Aabb leafBounds = m_Nodes[static_cast<std::size_t>(leaf)].bounds;
+    const std::int32_t sibling = FindBestSibling(leafBounds);
+
+    const std::int32_t oldParent = m_Nodes[static_cast<std::size_t>(sibling)].parent;
+    const std::int32_t newParent = AllocateNode();
+    {
+        Node& parent = m_Nodes[static_cast<std::size_t>(newParent)];
+        const Node& siblingNode = m_Nodes[static_cast<std::size_t>(sibling)];
+        parent.parent = oldParent;
+        parent.bounds = Union(leafBounds, siblingNode.bounds);
+        parent.height = siblingNode.height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+    }
+
+    if (oldParent != kNullNode)
+    {
+        Node& grandParent = m_Nodes[static_cast<std::size_t>(oldParent)];
+        if (grandParent.child1 == sibling)
+            grandParent.child1 = newParent;
+        else
+            grandParent.child2 = newParent;
+    }
+    else
+    {
+        m_Root = newParent;
+    }
+    m_Nodes[static_cast<std::size_t>(sibling)].parent = newParent;
+    m_Nodes[static_cast<std::size_t>(leaf)].parent = newParent;
+
+    Refit(m_Nodes[static_cast<std::size_t>(leaf)].parent);
+}
+
+void DynamicAabbTree::RemoveLeaf(std::int32_t leaf)
+{
+    if (leaf == m_Root)
+    {
+        m_Root = kNullNode;
+        return;
+    }
+
+    const std::int32_t parent = m_Nodes[static_cast<std::size_t>(leaf)].parent;
+    const Node& parentNode = m_Nodes[static_cast<std::size_t>(parent)];
+    const std::int32_t grandParent = parentNode.parent;
+    const std::int32_t sibling = parentNode.child1 == leaf ? parentNode.child2 : parentNode.child1;
+
+    if (grandParent != kNullNode)
+    {
+        Node& grandParentNode = m_Nodes[static_cast<std::size_t>(grandParent)];
+        if (grandParentNode.child1 == parent)
+            grandParentNode.child1 = sibling;
+        else
+            grandParentNode.child2 = sibling;
+        m_Nodes[static_cast<std::size_t>(sibling)].parent = grandParent;
+        FreeNode(parent);
+        Refit(grandParent);
+    }
+    else
+    {
+        m_Root = sibling;
+        m_Nodes[static_cast<std::size_t>(sibling)].parent = kNullNode;
+        FreeNode(parent);
+    }
+}
+
+void DynamicAabbTree::Refit(std::int32_t index)
+{
+    while (index != kNullNode)
+    {
+        index = Balance(index);
+
+        Node& node = m_Nodes[static_cast<std::size_t>(index)];
+        const Node& child1 = m_Nodes[static_cast<std::size_t>(node.child1)];
+        const Node& child2 = m_Nodes[static_cast<std::size_t>(node.child2)];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.bounds = Union(child1.bounds, child2.bounds);
+
+        index = node.parent;
+    }
+}
+
+// Rotates the taller grandchild up when the children's heights differ by more than one.
+std::int32_t DynamicAabbTree::Balance(std::int32_t iA)
+{
+    Node* a = &m_Nodes[static_cast<std::size_t>(iA)];
+    if (a->IsLeaf() || a->height < 2)
+        return iA;
+
+    const std::int32_t iB = a->child1;
+    const std::int32_t iC = a->child2;
+    Node* b = &m_Nodes[static_cast<std::size_t>(iB)];
+    Node* c = &m_Nodes[static_cast<std::size_t>(iC)];
+    const std::int32_t balance = c->height - b->height;
+
+    const auto replaceChild = [this](std::int32_t parent, std::int32_t oldChild, std::int32_t newChild)
+    {
+        if (parent == kNullNode)
+        {
+            m_Root = newChild;
+            return;
+        }
+        Node& parentNode = m_Nodes[static_cast<std::size_t>(parent)];
+        if (parentNode.child1 == oldChild)
+            parentNode.child1 = newChild;
+        else
+            parentNode.child2 = newChild;
+    };
+
+    if (balance > 1)
+    {
+        const std::int32_t iF = c->child1;
+        const std::int32_t iG = c->child2;
+        Node* f = &m_Nodes[static_cast<std::size_t>(iF)];
+        Node* g = &m_Nodes[static_cast<std::size_t>(iG)];
+
+        c->child1 = iA;
+        c->parent = a->parent;
+        a->parent = iC;
+        replaceChild(c->parent, iA, iC);
+
+        if (f->height > g->height)
+        {
+            c->child2 = iF;
+            a->child2 = iG;
+            g->parent = iA;
+            a->bounds = Union(b->bounds, g->bounds);
+            c->bounds = Union(a->bounds, f->bounds);
+            a->height = 1 + std::max(b->height, g->height);
+            c->height = 1 + std::max(a->height, f->height);
+        }
+        else
+        {
+            c->child2 = iG;
+            a->child2 = iF;
+            f->parent = iA;
+            a->bounds = Union(b->bounds, f->bounds);
+            c->bounds = Union(a->bounds, g->bounds);
+            a->height = 1 + std::max(b->height, f->height);
+            c->height = 1 + std::max(a->height, g->height);
+        }
+        return iC;
+    }
+
+    if (balance < -1)
+    {
+        const std::int32_t iD = b->child1;
+        const std::int32_t iE = b->child2;
+        Node* d = &m_Nodes[static_cast<std::size_t>(iD)];
+        Node* e = &m_Nodes[static_cast<std::size_t>(iE)];
+
+        b->child1 = iA;
+        b->parent = a->parent;
+        a->parent = iB;
+        replaceChild(b->parent, iA, iB);
+
+        if (d->height > e->height)
+        {
+            b->child2 = iD;
+            a->child1 = iE;
+            e->parent = iA;
+            a->bounds = Union(c->bounds, e->bounds);
+            b->bounds = Union(a->bounds, d->bounds);
+            a->height = 1 + std::max(c->height, e->height);
+            b->height = 1 + std::max(a->height, d->height);
+        }
+        else
+        {
+            b->child2 = iE;
+            a->child1 = iD;
+            d->parent = iA;
+            a->bounds = Union(c->bounds, d->bounds);
+            b->bounds = Union(a->bounds, e->bounds);
+            a->height = 1 + std::max(c->height, d->height);
+            b->height = 1 + std::max(a->height, e->height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+}
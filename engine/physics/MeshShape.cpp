@@ -0,0 +1,77 @@
+#include "MeshShape.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace physics
+{
+namespace
+{
+using ecs::Vec3;
+
+Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+struct PositionHash
+{
+    std::size_t operator()(const Vec3& v) const
+    {
+        std::uint32_t bits[3];
+        std::memcpy(bits, &v, sizeof(bits));
+        return (static_cast<std::size_t>(bits[0]) * 73856093u) ^ (static_cast<std::size_t>(bits[1]) * 19349663u) ^
+               (static_cast<std::size_t>(bits[2]) * 83492791u);
+    }
+};
+
+struct PositionEqual
+{
+    bool operator()(const Vec3& lhs, const Vec3& rhs) const
+    {
+        return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+    }
+};
+}
+
+MeshShape BuildMeshShape(std::span<const ecs::Vec3> positions, std::span<const std::uint32_t> indices)
+{
+    MeshShape shape;
+    std::vector<Vec3> welded;
+    std::vector<std::uint32_t> remap(positions.size());
+    std::unordered_map<Vec3, std::uint32_t, PositionHash, PositionEqual> lookup;
+    lookup.reserve(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        const auto [it, inserted] = lookup.try_emplace(positions[i], static_cast<std::uint32_t>(welded.size()));
+        if (inserted)
+            welded.push_back(positions[i]);
+        remap[i] = it->second;
+    }
+
+    std::vector<std::uint32_t> weldedIndices;
+    weldedIndices.reserve(indices.size());
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        if (indices[i] >= positions.size() || indices[i + 1] >= positions.size() || indices[i + 2] >= positions.size())
+            continue;
+        const std::uint32_t a = remap[indices[i]];
+        const std::uint32_t b = remap[indices[i + 1]];
+        const std::uint32_t c = remap[indices[i + 2]];
+        const Vec3 normal = Cross(Sub(welded[b], welded[a]), Sub(welded[c], welded[a]));
+        if (a == b || b == c || c == a || Dot(normal, normal) <= std::numeric_limits<float>::min())
+            continue;
+        weldedIndices.push_back(a);
+        weldedIndices.push_back(b);
+        weldedIndices.push_back(c);
+    }
+
+    shape.triangles = BuildTriangleMesh(welded, weldedIndices);
+    shape.hull = BuildConvexHull(welded);
+    if (shape.triangles.IsValid())
+        shape.bounds = shape.triangles.nodes.front().bounds;
+    return shape;
+}
+}
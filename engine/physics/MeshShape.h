@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Aabb.h"
+#include "ConvexHull.h"
+#include "TriangleMesh.h"
+
+#include <cstdint>
+#include <span>
+
+namespace physics
+{
+// Collision geometry a mesh bakes at import and caches with it: the triangles for static mesh
+// colliders and their convex hull for dynamic ones. Everything is in mesh space.
+struct MeshShape
+{
+    TriangleMesh triangles;
+    ConvexHull hull;
+    Aabb bounds{};
+};
+
+// Welds positions that are bitwise equal (render vertices split at UV and normal seams) and
+// drops degenerate triangles before building the BVH and the hull.
+MeshShape BuildMeshShape(std::span<const ecs::Vec3> positions, std::span<const std::uint32_t> indices);
+}
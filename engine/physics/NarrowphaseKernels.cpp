@@ -0,0 +1,559 @@
+#include "NarrowphaseKernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__AVX__)
+#define WHISP_NARROWPHASE_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WHISP_NARROWPHASE_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace physics
+{
+namespace
+{
+using ecs::Vec3;
+
+bool s_SimdEnabled = true;
+
+// Scalar helpers; the SIMD paths repeat these operations in the same order so every lane
+// rounds exactly like the reference.
+Vec3 Add(const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+Vec3 Scale(const Vec3& v, float s) { return { v.x * s, v.y * s, v.z * s }; }
+float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+float Abs(float v) { return v >= 0.0f ? v : -v; }
+float LengthSq(const Vec3& v) { return Dot(v, v); }
+Vec3 NormalizeSafe(const Vec3& v)
+{
+    const float len = std::sqrt(LengthSq(v));
+    if (len <= 0.000001f)
+        return Vec3{ 0.0f, 1.0f, 0.0f };
+    const float inv = 1.0f / len;
+    return Scale(v, inv);
+}
+float ProjectedObbRadius(const Vec3& half, const Vec3 axes[3], const Vec3& axis)
+{
+    return Abs(Dot(axis, axes[0])) * half.x +
+           Abs(Dot(axis, axes[1])) * half.y +
+           Abs(Dot(axis, axes[2])) * half.z;
+}
+
+template <typename Batch>
+Vec3 LaneVec3(const Batch& batch, std::size_t row, std::size_t lane)
+{
+    return Vec3{ batch.rows[row][lane], batch.rows[row + 1][lane], batch.rows[row + 2][lane] };
+}
+
+// Unused lanes are copied from lane 0 so the SIMD paths never read uninitialized floats.
+template <typename Batch>
+void PadLanes(Batch& batch, std::size_t width)
+{
+    const std::size_t padded = std::min((batch.count + width - 1) / width * width, kNarrowphaseBatchWidth);
+    for (std::size_t row = 0; row < Batch::RowCount; ++row)
+    {
+        for (std::size_t lane = batch.count; lane < padded; ++lane)
+            batch.rows[row][lane] = batch.rows[row][0];
+    }
+}
+
+BoxBoxSat TestBoxBoxLane(const BoxBoxBatch& batch, std::size_t lane)
+{
+    const Vec3 d = LaneVec3(batch, BoxBoxBatch::Delta, lane);
+    const Vec3 halfA = LaneVec3(batch, BoxBoxBatch::HalfA, lane);
+    const Vec3 halfB = LaneVec3(batch, BoxBoxBatch::HalfB, lane);
+    Vec3 axesA[3];
+    Vec3 axesB[3];
+    Vec3 candidateAxes[15];
+    std::uint32_t candidateIds[15];
+    int axisCount = 0;
+    for (std::uint32_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+    {
+        axesA[axisIndex] = LaneVec3(batch, BoxBoxBatch::AxesA + axisIndex * 3, lane);
+        axesB[axisIndex] = LaneVec3(batch, BoxBoxBatch::AxesB + axisIndex * 3, lane);
+    }
+    for (std::uint32_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+    {
+        candidateIds[axisCount] = axisIndex;
+        candidateAxes[axisCount++] = LaneVec3(batch, BoxBoxBatch::FaceAxesA + axisIndex * 3, lane);
+    }
+    for (std::uint32_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+    {
+        candidateIds[axisCount] = 3 + axisIndex;
+        candidateAxes[axisCount++] = LaneVec3(batch, BoxBoxBatch::FaceAxesB + axisIndex * 3, lane);
+    }
+    for (std::uint32_t indexA = 0; indexA < 3; ++indexA)
+    {
+        for (std::uint32_t indexB = 0; indexB < 3; ++indexB)
+        {
+            const Vec3 crossAxis = Cross(axesA[indexA], axesB[indexB]);
+            if (LengthSq(crossAxis) > 0.000001f)
+            {
+                candidateIds[axisCount] = 6 + indexA * 3 + indexB;
+                candidateAxes[axisCount++] = NormalizeSafe(crossAxis);
+            }
+        }
+    }
+
+    BoxBoxSat result;
+    float minPen = 1.0e9f;
+    for (int idx = 0; idx < axisCount; ++idx)
+    {
+        const Vec3& testAxis = candidateAxes[idx];
+        const float dist = Abs(Dot(d, testAxis));
+        const float ra = ProjectedObbRadius(halfA, axesA, testAxis);
+        const float rb = ProjectedObbRadius(halfB, axesB, testAxis);
+        const float overlap = (ra + rb) - dist;
+        if (overlap <= 0.0f)
+            return BoxBoxSat{};
+        if (overlap < minPen)
+        {
+            minPen = overlap;
+            result.axisId = candidateIds[idx];
+            result.positive = Dot(d, testAxis) >= 0.0f;
+        }
+    }
+    result.depth = minPen;
+    result.separated = false;
+    return result;
+}
+
+BoxSphereClosest ClosestPointBoxSphereLane(const BoxSphereBatch& batch, std::size_t lane)
+{
+    const Vec3 boxCenter = LaneVec3(batch, BoxSphereBatch::BoxCenter, lane);
+    const Vec3 sphereCenter = LaneVec3(batch, BoxSphereBatch::SphereCenter, lane);
+    const Vec3 half = LaneVec3(batch, BoxSphereBatch::Half, lane);
+    const Vec3 xAxis = LaneVec3(batch, BoxSphereBatch::Axes, lane);
+    const Vec3 yAxis = LaneVec3(batch, BoxSphereBatch::Axes + 3, lane);
+    const Vec3 zAxis = LaneVec3(batch, BoxSphereBatch::Axes + 6, lane);
+
+    BoxSphereClosest result;
+    const Vec3 boxToSphere = Sub(sphereCenter, boxCenter);
+    result.local[0] = Dot(boxToSphere, xAxis);
+    result.local[1] = Dot(boxToSphere, yAxis);
+    result.local[2] = Dot(boxToSphere, zAxis);
+    const float clampedX = std::max(-half.x, std::min(result.local[0], half.x));
+    const float clampedY = std::max(-half.y, std::min(result.local[1], half.y));
+    const float clampedZ = std::max(-half.z, std::min(result.local[2], half.z));
+    result.closest = Add(Add(Add(boxCenter, Scale(xAxis, clampedX)), Scale(yAxis, clampedY)), Scale(zAxis, clampedZ));
+    result.distanceSq = LengthSq(Sub(sphereCenter, result.closest));
+    return result;
+}
+
+#if defined(WHISP_NARROWPHASE_AVX) || defined(WHISP_NARROWPHASE_SSE)
+#if defined(WHISP_NARROWPHASE_AVX)
+struct SimdOps
+{
+    using Float = __m256;
+    static constexpr std::size_t kWidth = 8;
+    static constexpr const char* kName = "AVX";
+    static Float Load(const float* p) { return _mm256_load_ps(p); }
+    static void Store(float* p, Float v) { _mm256_store_ps(p, v); }
+    static Float Set(float v) { return _mm256_set1_ps(v); }
+    static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+    static Float Sqrt(Float v) { return _mm256_sqrt_ps(v); }
+    static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+    static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+    static Float Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Float LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static Float GreaterEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static Float Greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Float And(Float a, Float b) { return _mm256_and_ps(a, b); }
+    static Float Or(Float a, Float b) { return _mm256_or_ps(a, b); }
+    static Float Select(Float mask, Float ifTrue, Float ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+    static Float Negate(Float v) { return _mm256_xor_ps(v, _mm256_set1_ps(-0.0f)); }
+    static Float AllBits() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+};
+#else
+struct SimdOps
+{
+    using Float = __m128;
+    static constexpr std::size_t kWidth = 4;
+    static constexpr const char* kName = "SSE2";
+    static Float Load(const float* p) { return _mm_load_ps(p); }
+    static void Store(float* p, Float v) { _mm_store_ps(p, v); }
+    static Float Set(float v) { return _mm_set1_ps(v); }
+    static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+    static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+    static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+    static Float Sqrt(Float v) { return _mm_sqrt_ps(v); }
+    static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+    static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+    static Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+    static Float LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+    static Float GreaterEqual(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+    static Float Greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+    static Float And(Float a, Float b) { return _mm_and_ps(a, b); }
+    static Float Or(Float a, Float b) { return _mm_or_ps(a, b); }
+    static Float Select(Float mask, Float ifTrue, Float ifFalse) { return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse)); }
+    static Float Negate(Float v) { return _mm_xor_ps(v, _mm_set1_ps(-0.0f)); }
+    static Float AllBits() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+};
+#endif
+
+using S = SimdOps;
+using F = S::Float;
+
+struct SimdVec3
+{
+    F x;
+    F y;
+    F z;
+};
+
+template <typename Batch>
+SimdVec3 LoadVec3(const Batch& batch, std::size_t row, std::size_t first)
+{
+    return SimdVec3{ S::Load(&batch.rows[row][first]), S::Load(&batch.rows[row + 1][first]), S::Load(&batch.rows[row + 2][first]) };
+}
+
+F SimdDot(const SimdVec3& a, const SimdVec3& b)
+{
+    return S::Add(S::Add(S::Mul(a.x, b.x), S::Mul(a.y, b.y)), S::Mul(a.z, b.z));
+}
+
+SimdVec3 SimdCross(const SimdVec3& a, const SimdVec3& b)
+{
+    return SimdVec3{
+        S::Sub(S::Mul(a.y, b.z), S::Mul(a.z, b.y)),
+        S::Sub(S::Mul(a.z, b.x), S::Mul(a.x, b.z)),
+        S::Sub(S::Mul(a.x, b.y), S::Mul(a.y, b.x)) };
+}
+
+// v >= 0 ? v : -v, like the scalar Abs (keeps -0.0 as is).
+F SimdAbs(F v)
+{
+    return S::Select(S::GreaterEqual(v, S::Set(0.0f)), v, S::Negate(v));
+}
+
+SimdVec3 SimdNormalizeSafe(const SimdVec3& v)
+{
+    const F len = S::Sqrt(SimdDot(v, v));
+    const F degenerate = S::LessEqual(len, S::Set(0.000001f));
+    const F inv = S::Div(S::Set(1.0f), len);
+    return SimdVec3{
+        S::Select(degenerate, S::Set(0.0f), S::Mul(v.x, inv)),
+        S::Select(degenerate, S::Set(1.0f), S::Mul(v.y, inv)),
+        S::Select(degenerate, S::Set(0.0f), S::Mul(v.z, inv)) };
+}
+
+F SimdProjectedObbRadius(const SimdVec3& half, const SimdVec3 axes[3], const SimdVec3& axis)
+{
+    return S::Add(
+        S::Add(S::Mul(SimdAbs(SimdDot(axis, axes[0])), half.x), S::Mul(SimdAbs(SimdDot(axis, axes[1])), half.y)),
+        S::Mul(SimdAbs(SimdDot(axis, axes[2])), half.z));
+}
+
+// Every axis is tested in every lane; the scalar early-out on a separating axis only skips
+// work, so the shallowest overlap and the separation flag come out identical.
+void TestBoxBoxSimd(const BoxBoxBatch& batch, std::size_t first, BoxBoxSat* out)
+{
+    const SimdVec3 d = LoadVec3(batch, BoxBoxBatch::Delta, first);
+    const SimdVec3 halfA = LoadVec3(batch, BoxBoxBatch::HalfA, first);
+    const SimdVec3 halfB = LoadVec3(batch, BoxBoxBatch::HalfB, first);
+    SimdVec3 axesA[3];
+    SimdVec3 axesB[3];
+    for (std::size_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+    {
+        axesA[axisIndex] = LoadVec3(batch, BoxBoxBatch::AxesA + axisIndex * 3, first);
+        axesB[axisIndex] = LoadVec3(batch, BoxBoxBatch::AxesB + axisIndex * 3, first);
+    }
+
+    const F zero = S::Set(0.0f);
+    F minPen = S::Set(1.0e9f);
+    F bestAxis = S::Set(static_cast<float>(kNoSatAxis));
+    F bestPositive = zero;
+    F separated = zero;
+    const auto testAxis = [&](const SimdVec3& axis, F valid, std::uint32_t axisId)
+    {
+        const F projection = SimdDot(d, axis);
+        const F dist = SimdAbs(projection);
+        const F ra = SimdProjectedObbRadius(halfA, axesA, axis);
+        const F rb = SimdProjectedObbRadius(halfB, axesB, axis);
+        const F overlap = S::Sub(S::Add(ra, rb), dist);
+        separated = S::Or(separated, S::And(valid, S::LessEqual(overlap, zero)));
+        const F better = S::And(valid, S::Less(overlap, minPen));
+        minPen = S::Select(better, overlap, minPen);
+        bestAxis = S::Select(better, S::Set(static_cast<float>(axisId)), bestAxis);
+        bestPositive = S::Select(better, S::GreaterEqual(projection, zero), bestPositive);
+    };
+
+    const F always = S::AllBits();
+    for (std::uint32_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+        testAxis(LoadVec3(batch, BoxBoxBatch::FaceAxesA + axisIndex * 3, first), always, axisIndex);
+    for (std::uint32_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+        testAxis(LoadVec3(batch, BoxBoxBatch::FaceAxesB + axisIndex * 3, first), always, 3 + axisIndex);
+    for (std::uint32_t indexA = 0; indexA < 3; ++indexA)
+    {
+        for (std::uint32_t indexB = 0; indexB < 3; ++indexB)
+        {
+            const SimdVec3 crossAxis = SimdCross(axesA[indexA], axesB[indexB]);
+            const F valid = S::Greater(SimdDot(crossAxis, crossAxis), S::Set(0.000001f));
+            testAxis(SimdNormalizeSafe(crossAxis), valid, 6 + indexA * 3 + indexB);
+        }
+    }
+
+    alignas(32) float depths[S::kWidth];
+    alignas(32) float axes[S::kWidth];
+    alignas(32) float positives[S::kWidth];
+    alignas(32) float separations[S::kWidth];
+    S::Store(depths, minPen);
+    S::Store(axes, bestAxis);
+    S::Store(positives, bestPositive);
+    S::Store(separations, separated);
+    const std::size_t lanes = std::min(S::kWidth, batch.count - first);
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+        BoxBoxSat& result = out[first + lane];
+        if (std::bit_cast<std::uint32_t>(separations[lane]) != 0)
+        {
+            result = BoxBoxSat{};
+            continue;
+        }
+        result.depth = depths[lane];
+        result.axisId = static_cast<std::uint32_t>(axes[lane]);
+        result.positive = std::bit_cast<std::uint32_t>(positives[lane]) != 0;
+        result.separated = false;
+    }
+}
+
+void ClosestPointsBoxSphereSimd(const BoxSphereBatch& batch, std::size_t first, BoxSphereClosest* out)
+{
+    const SimdVec3 boxCenter = LoadVec3(batch, BoxSphereBatch::BoxCenter, first);
+    const SimdVec3 sphereCenter = LoadVec3(batch, BoxSphereBatch::SphereCenter, first);
+    const SimdVec3 half = LoadVec3(batch, BoxSphereBatch::Half, first);
+    const SimdVec3 xAxis = LoadVec3(batch, BoxSphereBatch::Axes, first);
+    const SimdVec3 yAxis = LoadVec3(batch, BoxSphereBatch::Axes + 3, first);
+    const SimdVec3 zAxis = LoadVec3(batch, BoxSphereBatch::Axes + 6, first);
+
+    const SimdVec3 boxToSphere{ S::Sub(sphereCenter.x, boxCenter.x), S::Sub(sphereCenter.y, boxCenter.y), S::Sub(sphereCenter.z, boxCenter.z) };
+    const F localX = SimdDot(boxToSphere, xAxis);
+    const F localY = SimdDot(boxToSphere, yAxis);
+    const F localZ = SimdDot(boxToSphere, zAxis);
+    // std::max(-h, std::min(v, h)), operand order chosen so NaN and signed zeros match.
+    const F clampedX = S::Max(S::Min(half.x, localX), S::Negate(half.x));
+    const F clampedY = S::Max(S::Min(half.y, localY), S::Negate(half.y));
+    const F clampedZ = S::Max(S::Min(half.z, localZ), S::Negate(half.z));
+    const auto along = [&](F base, F x, F y, F z)
+    {
+        return S::Add(S::Add(S::Add(base, S::Mul(x, clampedX)), S::Mul(y, clampedY)), S::Mul(z, clampedZ));
+    };
+    const SimdVec3 closest{
+        along(boxCenter.x, xAxis.x, yAxis.x, zAxis.x),
+        along(boxCenter.y, xAxis.y, yAxis.y, zAxis.y),
+        along(boxCenter.z, xAxis.z, yAxis.z, zAxis.z) };
+    const SimdVec3 delta{ S::Sub(sphereCenter.x, closest.x), S::Sub(sphereCenter.y, closest.y), S::Sub(sphereCenter.z, closest.z) };
+    const F distanceSq = SimdDot(delta, delta);
+
+    alignas(32) float values[8][S::kWidth];
+    S::Store(values[0], localX);
+    S::Store(values[1], localY);
+    S::Store(values[2], localZ);
+    S::Store(values[3], closest.x);
+    S::Store(values[4], closest.y);
+    S::Store(values[5], closest.z);
+    S::Store(values[6], distanceSq);
+    const std::size_t lanes = std::min(S::kWidth, batch.count - first);
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+        BoxSphereClosest& result = out[first + lane];
+        result.local[0] = values[0][lane];
+        result.local[1] = values[1][lane];
+        result.local[2] = values[2][lane];
+        result.closest = Vec3{ values[3][lane], values[4][lane], values[5][lane] };
+        result.distanceSq = values[6][lane];
+    }
+}
+#endif
+
+// Small deterministic generator for the self-check; std distributions differ across libraries.
+struct CheckRandom
+{
+    std::uint32_t state = 0x2545F491u;
+
+    float Next(float minValue, float maxValue)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return minValue + (maxValue - minValue) * (static_cast<float>(state >> 8) / 16777216.0f);
+    }
+    Vec3 NextVec3(float minValue, float maxValue)
+    {
+        const float x = Next(minValue, maxValue);
+        const float y = Next(minValue, maxValue);
+        const float z = Next(minValue, maxValue);
+        return Vec3{ x, y, z };
+    }
+    // Every other rotation is axis-aligned so parallel edge axes (skipped SAT axes) are covered.
+    Vec3 NextRotation()
+    {
+        const bool aligned = Next(0.0f, 1.0f) < 0.5f;
+        const Vec3 rotation = NextVec3(-3.2f, 3.2f);
+        return aligned ? Vec3{ 0.0f, std::round(rotation.y) * 1.5707964f, 0.0f } : rotation;
+    }
+};
+
+bool SameBits(float a, float b)
+{
+    return std::bit_cast<std::uint32_t>(a) == std::bit_cast<std::uint32_t>(b);
+}
+}
+
+BoxAxes BuildBoxAxes(const Vec3& rotation)
+{
+    const float cx = std::cos(rotation.x), sx = std::sin(rotation.x);
+    const float cy = std::cos(rotation.y), sy = std::sin(rotation.y);
+    const float cz = std::cos(rotation.z), sz = std::sin(rotation.z);
+    const float r00 = cz * cy;
+    const float r01 = cz * sy * sx - sz * cx;
+    const float r02 = cz * sy * cx + sz * sx;
+    const float r10 = sz * cy;
+    const float r11 = sz * sy * sx + cz * cx;
+    const float r12 = sz * sy * cx - cz * sx;
+    const float r20 = -sy;
+    const float r21 = cy * sx;
+    const float r22 = cy * cx;
+    return BoxAxes{
+        Vec3{ r00, r10, r20 },
+        Vec3{ r01, r11, r21 },
+        Vec3{ r02, r12, r22 }
+    };
+}
+
+BoxAxes NormalizeBoxAxes(const BoxAxes& axes)
+{
+    return BoxAxes{ NormalizeSafe(axes.xAxis), NormalizeSafe(axes.yAxis), NormalizeSafe(axes.zAxis) };
+}
+
+void TestBoxBoxBatchScalar(const BoxBoxBatch& batch, BoxBoxSat* out)
+{
+    for (std::size_t lane = 0; lane < batch.count; ++lane)
+        out[lane] = TestBoxBoxLane(batch, lane);
+}
+
+void ClosestPointsBoxSphereBatchScalar(const BoxSphereBatch& batch, BoxSphereClosest* out)
+{
+    for (std::size_t lane = 0; lane < batch.count; ++lane)
+        out[lane] = ClosestPointBoxSphereLane(batch, lane);
+}
+
+void TestBoxBoxBatch(BoxBoxBatch& batch, BoxBoxSat* out)
+{
+#if defined(WHISP_NARROWPHASE_AVX) || defined(WHISP_NARROWPHASE_SSE)
+    if (s_SimdEnabled)
+    {
+        PadLanes(batch, S::kWidth);
+        for (std::size_t first = 0; first < batch.count; first += S::kWidth)
+            TestBoxBoxSimd(batch, first, out);
+        return;
+    }
+#endif
+    TestBoxBoxBatchScalar(batch, out);
+}
+
+void ClosestPointsBoxSphereBatch(BoxSphereBatch& batch, BoxSphereClosest* out)
+{
+#if defined(WHISP_NARROWPHASE_AVX) || defined(WHISP_NARROWPHASE_SSE)
+    if (s_SimdEnabled)
+    {
+        PadLanes(batch, S::kWidth);
+        for (std::size_t first = 0; first < batch.count; first += S::kWidth)
+            ClosestPointsBoxSphereSimd(batch, first, out);
+        return;
+    }
+#endif
+    ClosestPointsBoxSphereBatchScalar(batch, out);
+}
+
+const char* GetNarrowphaseKernelName()
+{
+#if defined(WHISP_NARROWPHASE_AVX) || defined(WHISP_NARROWPHASE_SSE)
+    return S::kName;
+#else
+    return "scalar";
+#endif
+}
+
+void SetNarrowphaseSimdEnabled(bool enabled)
+{
+    s_SimdEnabled = enabled;
+}
+
+bool IsNarrowphaseSimdEnabled()
+{
+#if defined(WHISP_NARROWPHASE_AVX) || defined(WHISP_NARROWPHASE_SSE)
+    return s_SimdEnabled;
+#else
+    return false;
+#endif
+}
+
+std::size_t VerifyNarrowphaseKernels(std::size_t pairCount)
+{
+    CheckRandom random;
+    std::size_t mismatches = 0;
+    BoxBoxBatch boxBatch;
+    BoxSphereBatch sphereBatch;
+    BoxBoxSat simdSat[kNarrowphaseBatchWidth];
+    BoxBoxSat scalarSat[kNarrowphaseBatchWidth];
+    BoxSphereClosest simdClosest[kNarrowphaseBatchWidth];
+    BoxSphereClosest scalarClosest[kNarrowphaseBatchWidth];
+
+    for (std::size_t done = 0; done < pairCount; done += kNarrowphaseBatchWidth)
+    {
+        // Odd-sized batches exercise the lane padding as well.
+        const std::size_t count = std::min<std::size_t>(kNarrowphaseBatchWidth - (done / kNarrowphaseBatchWidth) % 3, pairCount - done);
+        boxBatch.count = count;
+        sphereBatch.count = count;
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            const BoxAxes axesA = BuildBoxAxes(random.NextRotation());
+            const BoxAxes axesB = BuildBoxAxes(random.NextRotation());
+            boxBatch.SetVec3(BoxBoxBatch::Delta, lane, random.NextVec3(-1.0f, 1.0f));
+            boxBatch.SetVec3(BoxBoxBatch::HalfA, lane, random.NextVec3(0.05f, 0.6f));
+            boxBatch.SetVec3(BoxBoxBatch::HalfB, lane, random.NextVec3(0.05f, 0.6f));
+            boxBatch.SetAxes(BoxBoxBatch::AxesA, lane, axesA);
+            boxBatch.SetAxes(BoxBoxBatch::AxesB, lane, axesB);
+            boxBatch.SetAxes(BoxBoxBatch::FaceAxesA, lane, NormalizeBoxAxes(axesA));
+            boxBatch.SetAxes(BoxBoxBatch::FaceAxesB, lane, NormalizeBoxAxes(axesB));
+
+            sphereBatch.SetVec3(BoxSphereBatch::BoxCenter, lane, random.NextVec3(-5.0f, 5.0f));
+            sphereBatch.SetVec3(BoxSphereBatch::SphereCenter, lane, random.NextVec3(-5.0f, 5.0f));
+            sphereBatch.SetVec3(BoxSphereBatch::Half, lane, random.NextVec3(0.05f, 3.0f));
+            sphereBatch.SetAxes(BoxSphereBatch::Axes, lane, axesA);
+        }
+
+        TestBoxBoxBatchScalar(boxBatch, scalarSat);
+        TestBoxBoxBatch(boxBatch, simdSat);
+        ClosestPointsBoxSphereBatchScalar(sphereBatch, scalarClosest);
+        ClosestPointsBoxSphereBatch(sphereBatch, simdClosest);
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            const BoxBoxSat& lhs = simdSat[lane];
+            const BoxBoxSat& rhs = scalarSat[lane];
+            if (!SameBits(lhs.depth, rhs.depth) || lhs.axisId != rhs.axisId ||
+                lhs.positive != rhs.positive || lhs.separated != rhs.separated)
+                ++mismatches;
+
+            const BoxSphereClosest& simd = simdClosest[lane];
+            const BoxSphereClosest& scalar = scalarClosest[lane];
+            if (!SameBits(simd.local[0], scalar.local[0]) || !SameBits(simd.local[1], scalar.local[1]) ||
+                !SameBits(simd.local[2], scalar.local[2]) || !SameBits(simd.closest.x, scalar.closest.x) ||
+                !SameBits(simd.closest.y, scalar.closest.y) || !SameBits(simd.closest.z, scalar.closest.z) ||
+                !SameBits(simd.distanceSq, scalar.distanceSq))
+                ++mismatches;
+        }
+    }
+    return mismatches;
+}
+}
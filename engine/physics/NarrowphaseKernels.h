@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../ecs/MathTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace physics
+{
+// Rotation matrix columns of a box (its local x, y and z axes in world space).
+struct BoxAxes
+{
+    ecs::Vec3 xAxis;
+    ecs::Vec3 yAxis;
+    ecs::Vec3 zAxis;
+};
+
+// Euler angles in radians, applied as Rz * Ry * Rx.
+BoxAxes BuildBoxAxes(const ecs::Vec3& rotation);
+// The same axes normalized; these are the SAT face axes of the box.
+BoxAxes NormalizeBoxAxes(const BoxAxes& axes);
+
+// Pairs packed per kernel call. SSE evaluates 4 lanes at a time, AVX all 8.
+inline constexpr std::size_t kNarrowphaseBatchWidth = 8;
+// Axis id reported when no SAT axis produced a finite overlap.
+inline constexpr std::uint32_t kNoSatAxis = 15;
+
+// Box-box pairs, structure of arrays: every row holds one scalar for each lane.
+struct BoxBoxBatch
+{
+    enum Row : std::size_t
+    {
+        Delta = 0,        // centre of A minus centre of B
+        HalfA = 3,
+        HalfB = 6,
+        AxesA = 9,        // x, y, z axis of A, 3 rows each
+        AxesB = 18,
+        FaceAxesA = 27,   // normalized axes of A
+        FaceAxesB = 36,
+        RowCount = 45
+    };
+
+    alignas(32) float rows[RowCount][kNarrowphaseBatchWidth];
+    std::size_t count = 0;
+
+    void SetVec3(std::size_t row, std::size_t lane, const ecs::Vec3& value)
+    {
+        rows[row][lane] = value.x;
+        rows[row + 1][lane] = value.y;
+        rows[row + 2][lane] = value.z;
+    }
+    void SetAxes(std::size_t row, std::size_t lane, const BoxAxes& axes)
+    {
+        SetVec3(row, lane, axes.xAxis);
+        SetVec3(row + 3, lane, axes.yAxis);
+        SetVec3(row + 6, lane, axes.zAxis);
+    }
+};
+
+// Shallowest overlap over the 15 SAT axes of a box pair. Axis ids: 0-2 faces of A,
+// 3-5 faces of B, 6-14 edge pairs (6 + 3 * axisA + axisB).
+struct BoxBoxSat
+{
+    float depth = 0.0f;
+    std::uint32_t axisId = kNoSatAxis;
+    // Centre delta points along the axis (so the normal is the axis itself, not its negation).
+    bool positive = false;
+    bool separated = true;
+};
+
+struct BoxSphereBatch
+{
+    enum Row : std::size_t
+    {
+        BoxCenter = 0,
+        SphereCenter = 3,
+        Half = 6,
+        Axes = 9,
+        RowCount = 18
+    };
+
+    alignas(32) float rows[RowCount][kNarrowphaseBatchWidth];
+    std::size_t count = 0;
+
+    void SetVec3(std::size_t row, std::size_t lane, const ecs::Vec3& value)
+    {
+        rows[row][lane] = value.x;
+        rows[row + 1][lane] = value.y;
+        rows[row + 2][lane] = value.z;
+    }
+    void SetAxes(std::size_t row, std::size_t lane, const BoxAxes& axes)
+    {
+        SetVec3(row, lane, axes.xAxis);
+        SetVec3(row + 3, lane, axes.yAxis);
+        SetVec3(row + 6, lane, axes.zAxis);
+    }
+};
+
+// Sphere centre in box space and the closest point on the box to it.
+struct BoxSphereClosest
+{
+    float local[3] = {};
+    ecs::Vec3 closest{};
+    float distanceSq = 0.0f;
+};
+
+// Evaluate every lane of the batch; lanes past count are padded from lane 0 first.
+// The SIMD paths produce the same bits as the scalar reference below.
+void TestBoxBoxBatch(BoxBoxBatch& batch, BoxBoxSat* out);
+void ClosestPointsBoxSphereBatch(BoxSphereBatch& batch, BoxSphereClosest* out);
+
+// Scalar reference, also the fallback when SIMD is unavailable or disabled.
+void TestBoxBoxBatchScalar(const BoxBoxBatch& batch, BoxBoxSat* out);
+void ClosestPointsBoxSphereBatchScalar(const BoxSphereBatch& batch, BoxSphereClosest* out);
+
+// "AVX", "SSE2" or "scalar": the instruction set the batch kernels were compiled for.
+const char* GetNarrowphaseKernelName();
+void SetNarrowphaseSimdEnabled(bool enabled);
+bool IsNarrowphaseSimdEnabled();
+
+// Runs pairCount random box-box and box-sphere pairs through the SIMD and scalar kernels and
+// returns how many results differ in any bit.
+std::size_t VerifyNarrowphaseKernels(std::size_t pairCount);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace physics
+{
+// How much work an island gets, from its closest body's distance to the LOD focus (usually the
+// active camera).
+enum class LodLevel : std::uint8_t
+{
+    Full,     // configured substeps and solver iterations
+    Reduced,  // one step per update, reducedSolverIterations
+    Distant,  // as Reduced, but only every distantInterval updates, covering the skipped time
+    Frozen,   // held in place with its velocity until the focus comes closer
+    Count
+};
+inline constexpr std::size_t kLodLevelCount = static_cast<std::size_t>(LodLevel::Count);
+
+struct LodSettings
+{
+    bool enabled = false;
+    // Outer edges of the Full, Reduced and Distant levels.
+    float nearDistance = 30.0f;
+    float farDistance = 70.0f;
+    float freezeDistance = 140.0f;
+    int reducedSolverIterations = 2;
+    int distantInterval = 2;
+    // A body only drops a level once it is this far past the edge, so bodies moving along an
+    // edge do not switch levels every update. Promotion is immediate.
+    float hysteresis = 3.0f;
+};
+
+inline LodLevel LodLevelForDistance(const LodSettings& settings, float distance)
+{
+    if (distance < settings.nearDistance)
+        return LodLevel::Full;
+    if (distance < settings.farDistance)
+        return LodLevel::Reduced;
+    if (distance < settings.freezeDistance)
+        return LodLevel::Distant;
+    return LodLevel::Frozen;
+}
+
+inline LodLevel NextLodLevel(const LodSettings& settings, LodLevel previous, float distance)
+{
+    const LodLevel target = LodLevelForDistance(settings, distance);
+    if (target <= previous)
+        return target;
+    const LodLevel demoted = LodLevelForDistance(settings, distance - settings.hysteresis);
+    return demoted > previous ? demoted : previous;
+}
+}
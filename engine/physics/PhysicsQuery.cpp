@@ -0,0 +1,327 @@
+#include "PhysicsQuery.h"
+
+#include "TimeOfImpact.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace physics
+{
+namespace
+{
+using ecs::Vec3;
+
+constexpr std::size_t kRaycastGrain = 64;
+constexpr float kParallelEpsilon = 1.0e-9f;
+
+float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Vec3 Add(const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+Vec3 Scale(const Vec3& v, float s) { return { v.x * s, v.y * s, v.z * s }; }
+
+const Vec3& AxisAt(const BoxAxes& axes, int index)
+{
+    return index == 0 ? axes.xAxis : (index == 1 ? axes.yAxis : axes.zAxis);
+}
+
+float HalfAt(const Vec3& half, int index)
+{
+    return index == 0 ? half.x : (index == 1 ? half.y : half.z);
+}
+
+Aabb ColliderBounds(const QueryCollider& collider)
+{
+    Vec3 half{ collider.radius, collider.radius, collider.radius };
+    if (!collider.isSphere)
+    {
+        const BoxAxes& axes = collider.axes;
+        const Vec3& h = collider.halfExtents;
+        half = Vec3{
+            std::abs(axes.xAxis.x) * h.x + std::abs(axes.yAxis.x) * h.y + std::abs(axes.zAxis.x) * h.z,
+            std::abs(axes.xAxis.y) * h.x + std::abs(axes.yAxis.y) * h.y + std::abs(axes.zAxis.y) * h.z,
+            std::abs(axes.xAxis.z) * h.x + std::abs(axes.yAxis.z) * h.y + std::abs(axes.zAxis.z) * h.z
+        };
+    }
+    return Aabb{ Sub(collider.center, half), Add(collider.center, half) };
+}
+
+QueryCollider MakeSphere(const Vec3& center, float radius)
+{
+    QueryCollider shape;
+    shape.center = center;
+    shape.radius = radius;
+    shape.halfExtents = Vec3{ radius, radius, radius };
+    shape.isSphere = true;
+    return shape;
+}
+
+QueryCollider MakeBox(const Vec3& center, const Vec3& halfExtents, const Vec3& rotation)
+{
+    QueryCollider shape;
+    shape.center = center;
+    shape.halfExtents = halfExtents;
+    shape.axes = NormalizeBoxAxes(BuildBoxAxes(rotation));
+    return shape;
+}
+
+bool BoxesOverlap(const QueryCollider& a, const QueryCollider& b)
+{
+    BoxBoxBatch batch;
+    batch.SetVec3(BoxBoxBatch::Delta, 0, Sub(a.center, b.center));
+    batch.SetVec3(BoxBoxBatch::HalfA, 0, a.halfExtents);
+    batch.SetVec3(BoxBoxBatch::HalfB, 0, b.halfExtents);
+    batch.SetAxes(BoxBoxBatch::AxesA, 0, a.axes);
+    batch.SetAxes(BoxBoxBatch::AxesB, 0, b.axes);
+    batch.SetAxes(BoxBoxBatch::FaceAxesA, 0, a.axes);
+    batch.SetAxes(BoxBoxBatch::FaceAxesB, 0, b.axes);
+    batch.count = 1;
+    BoxBoxSat sat;
+    TestBoxBoxBatchScalar(batch, &sat);
+    return !sat.separated;
+}
+
+bool BoxSphereOverlap(const QueryCollider& box, const QueryCollider& sphere)
+{
+    BoxSphereBatch batch;
+    batch.SetVec3(BoxSphereBatch::BoxCenter, 0, box.center);
+    batch.SetVec3(BoxSphereBatch::SphereCenter, 0, sphere.center);
+    batch.SetVec3(BoxSphereBatch::Half, 0, box.halfExtents);
+    batch.SetAxes(BoxSphereBatch::Axes, 0, box.axes);
+    batch.count = 1;
+    BoxSphereClosest closest;
+    ClosestPointsBoxSphereBatchScalar(batch, &closest);
+    return closest.distanceSq <= sphere.radius * sphere.radius;
+}
+
+bool ShapesOverlap(const QueryCollider& a, const QueryCollider& b)
+{
+    if (a.isSphere && b.isSphere)
+    {
+        const Vec3 d = Sub(a.center, b.center);
+        const float reach = a.radius + b.radius;
+        return Dot(d, d) <= reach * reach;
+    }
+    if (a.isSphere)
+        return BoxSphereOverlap(b, a);
+    if (b.isSphere)
+        return BoxSphereOverlap(a, b);
+    return BoxesOverlap(a, b);
+}
+
+SweepShape ToSweepShape(const QueryCollider& collider)
+{
+    SweepShape shape;
+    shape.center = collider.center;
+    shape.isSphere = collider.isSphere;
+    shape.radius = collider.radius;
+    shape.halfExtents = collider.halfExtents;
+    shape.axes = collider.axes;
+    return shape;
+}
+
+bool RaySphere(const QueryCollider& sphere, const Ray& ray, float maxDistance, RaycastHit& out)
+{
+    const Vec3 m = Sub(ray.origin, sphere.center);
+    const float b = Dot(m, ray.direction);
+    const float c = Dot(m, m) - sphere.radius * sphere.radius;
+    if (c > 0.0f && b > 0.0f)
+        return false;
+    const float discriminant = b * b - c;
+    if (discriminant < 0.0f)
+        return false;
+    const float t = std::max(-b - std::sqrt(discriminant), 0.0f);
+    if (t > maxDistance)
+        return false;
+    out.distance = t;
+    out.point = Add(ray.origin, Scale(ray.direction, t));
+    const Vec3 outward = Sub(out.point, sphere.center);
+    const float length = std::sqrt(Dot(outward, outward));
+    out.normal = length > 0.000001f ? Scale(outward, 1.0f / length) : Scale(ray.direction, -1.0f);
+    return true;
+}
+
+// Slab test in box space; a ray starting inside reports distance 0.
+bool RayBox(const QueryCollider& box, const Ray& ray, float maxDistance, RaycastHit& out)
+{
+    const Vec3 offset = Sub(ray.origin, box.center);
+    float enter = 0.0f;
+    float exit = maxDistance;
+    Vec3 normal = Scale(ray.direction, -1.0f);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const Vec3& direction = AxisAt(box.axes, axis);
+        const float half = HalfAt(box.halfExtents, axis);
+        const float start = Dot(offset, direction);
+        const float speed = Dot(ray.direction, direction);
+        if (std::abs(speed) < kParallelEpsilon)
+        {
+            if (std::abs(start) > half)
+                return false;
+            continue;
+        }
+        float t0 = (-half - start) / speed;
+        float t1 = (half - start) / speed;
+        if (t0 > t1)
+            std::swap(t0, t1);
+        if (t0 > enter)
+        {
+            enter = t0;
+            normal = speed > 0.0f ? Scale(direction, -1.0f) : direction;
+        }
+        exit = std::min(exit, t1);
+        if (enter > exit)
+            return false;
+    }
+    out.distance = enter;
+    out.point = Add(ray.origin, Scale(ray.direction, enter));
+    out.normal = normal;
+    return true;
+}
+}
+
+const QueryCollider* PhysicsQuery::Find(std::uint32_t proxy, const QueryFilter& filter) const
+{
+    if (proxy >= m_Colliders.size())
+        return nullptr;
+    const QueryCollider& collider = m_Colliders[proxy];
+    if (!collider.entity.IsValid() || collider.entity == filter.ignore || (collider.layer & filter.layerMask) == 0)
+        return nullptr;
+    if (collider.isStatic ? !filter.includeStatic : !filter.includeDynamic)
+        return nullptr;
+    return &collider;
+}
+
+template <typename Visitor>
+void PhysicsQuery::QueryBounds(const Aabb& bounds, const QueryFilter& filter, Visitor&& visitor) const
+{
+    const auto visit = [&](std::uint32_t proxy)
+    {
+        if (const QueryCollider* collider = Find(proxy, filter))
+            visitor(*collider);
+    };
+    if (filter.includeStatic)
+        m_Broadphase->GetStaticTree().Query(bounds, visit);
+    if (filter.includeDynamic)
+        m_Broadphase->GetDynamicTree().Query(bounds, visit);
+}
+
+bool PhysicsQuery::Raycast(const Ray& ray, RaycastHit& outHit, const QueryFilter& filter) const
+{
+    outHit = RaycastHit{};
+    const auto visit = [&](std::uint32_t proxy, float maxDistance)
+    {
+        const QueryCollider* collider = Find(proxy, filter);
+        RaycastHit hit;
+        if (collider == nullptr ||
+            !(collider->isSphere ? RaySphere(*collider, ray, maxDistance, hit) : RayBox(*collider, ray, maxDistance, hit)))
+            return maxDistance;
+        hit.entity = collider->entity;
+        outHit = hit;
+        return hit.distance;
+    };
+    float maxDistance = ray.maxDistance;
+    const auto castTree = [&](const DynamicAabbTree& tree)
+    {
+        tree.RayCast(ray.origin, ray.direction, maxDistance, [&](std::uint32_t proxy, float distance)
+        {
+            maxDistance = visit(proxy, distance);
+            return maxDistance;
+        });
+    };
+    if (filter.includeStatic)
+        castTree(m_Broadphase->GetStaticTree());
+    if (filter.includeDynamic)
+        castTree(m_Broadphase->GetDynamicTree());
+    return outHit.IsHit();
+}
+
+void PhysicsQuery::RaycastBatch(std::span<const Ray> rays, std::span<RaycastHit> outHits, const QueryFilter& filter) const
+{
+    const std::size_t count = std::min(rays.size(), outHits.size());
+    JobSystem::Get().ParallelFor(count, kRaycastGrain, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t index = begin; index < end; ++index)
+            Raycast(rays[index], outHits[index], filter);
+    });
+}
+
+std::size_t PhysicsQuery::Overlap(const QueryCollider& shape, std::vector<ecs::Entity>& out, const QueryFilter& filter) const
+{
+    const std::size_t before = out.size();
+    QueryBounds(ColliderBounds(shape), filter, [&](const QueryCollider& collider)
+    {
+        if (ShapesOverlap(shape, collider))
+            out.push_back(collider.entity);
+    });
+    return out.size() - before;
+}
+
+std::size_t PhysicsQuery::OverlapSphere(const ecs::Vec3& center, float radius, std::vector<ecs::Entity>& out, const QueryFilter& filter) const
+{
+    return Overlap(MakeSphere(center, radius), out, filter);
+}
+
+std::size_t PhysicsQuery::OverlapBox(
+    const ecs::Vec3& center,
+    const ecs::Vec3& halfExtents,
+    const ecs::Vec3& rotation,
+    std::vector<ecs::Entity>& out,
+    const QueryFilter& filter) const
+{
+    return Overlap(MakeBox(center, halfExtents, rotation), out, filter);
+}
+
+bool PhysicsQuery::Sweep(const QueryCollider& shape, const ecs::Vec3& direction, float maxDistance, SweepHit& outHit, const QueryFilter& filter) const
+{
+    outHit = SweepHit{};
+    const Vec3 motion = Scale(direction, maxDistance);
+    const Aabb start = ColliderBounds(shape);
+    const Aabb swept{
+        Vec3{ std::min(start.min.x, start.min.x + motion.x), std::min(start.min.y, start.min.y + motion.y), std::min(start.min.z, start.min.z + motion.z) },
+        Vec3{ std::max(start.max.x, start.max.x + motion.x), std::max(start.max.y, start.max.y + motion.y), std::max(start.max.z, start.max.z + motion.z) } };
+    const SweepShape moving = ToSweepShape(shape);
+    float bestFraction = 2.0f;
+    QueryBounds(swept, filter, [&](const QueryCollider& collider)
+    {
+        float fraction = 0.0f;
+        if (!ShapesOverlap(shape, collider) &&
+            !ComputeTimeOfImpact(moving, ToSweepShape(collider), motion, 0.0f, fraction))
+            return;
+        // Ties go to the lower entity index so the result does not depend on tree layout.
+        if (fraction < bestFraction || (fraction == bestFraction && collider.entity.index < outHit.entity.index))
+        {
+            bestFraction = fraction;
+            outHit.entity = collider.entity;
+        }
+    });
+    if (!outHit.IsHit())
+        return false;
+    outHit.distance = bestFraction * maxDistance;
+    outHit.center = Add(shape.center, Scale(direction, outHit.distance));
+    return true;
+}
+
+bool PhysicsQuery::SweepSphere(
+    const ecs::Vec3& center,
+    float radius,
+    const ecs::Vec3& direction,
+    float maxDistance,
+    SweepHit& outHit,
+    const QueryFilter& filter) const
+{
+    return Sweep(MakeSphere(center, radius), direction, maxDistance, outHit, filter);
+}
+
+bool PhysicsQuery::SweepBox(
+    const ecs::Vec3& center,
+    const ecs::Vec3& halfExtents,
+    const ecs::Vec3& rotation,
+    const ecs::Vec3& direction,
+    float maxDistance,
+    SweepHit& outHit,
+    const QueryFilter& filter) const
+{
+    return Sweep(MakeBox(center, halfExtents, rotation), direction, maxDistance, outHit, filter);
+}
+}
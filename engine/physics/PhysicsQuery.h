@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Broadphase.h"
+#include "NarrowphaseKernels.h"
+#include "../ecs/Entity.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace physics
+{
+// Layer bit of colliders that do not name their own layers.
+inline constexpr std::uint32_t kDefaultQueryLayer = kDefaultCollisionLayer;
+
+// A collider as the last physics update left it, stored per broadphase proxy.
+struct QueryCollider
+{
+    // Invalid for proxies that no longer belong to a collider.
+    ecs::Entity entity{};
+    ecs::Vec3 center{};
+    ecs::Vec3 halfExtents{};
+    // Normalized box axes; spheres use radius instead.
+    BoxAxes axes{};
+    float radius = 0.0f;
+    bool isSphere = false;
+    bool isStatic = false;
+    std::uint32_t layer = kDefaultQueryLayer;
+};
+
+struct QueryFilter
+{
+    // Colliders are reported when their layer shares a bit with this mask.
+    std::uint32_t layerMask = 0xFFFFFFFFu;
+    bool includeStatic = true;
+    bool includeDynamic = true;
+    // Typically the entity the query is made for, such as the shooter of a ray.
+    ecs::Entity ignore{};
+};
+
+struct Ray
+{
+    ecs::Vec3 origin{};
+    // Unit length.
+    ecs::Vec3 direction{ 0.0f, 0.0f, 1.0f };
+    float maxDistance = 1000.0f;
+};
+
+struct RaycastHit
+{
+    // Invalid when the ray hit nothing.
+    ecs::Entity entity{};
+    float distance = 0.0f;
+    ecs::Vec3 point{};
+    ecs::Vec3 normal{};
+
+    [[nodiscard]] bool IsHit() const { return entity.IsValid(); }
+};
+
+struct SweepHit
+{
+    ecs::Entity entity{};
+    // How far the shape travels before it touches; 0 when it overlaps at the start.
+    float distance = 0.0f;
+    // Shape centre at that distance.
+    ecs::Vec3 center{};
+
+    [[nodiscard]] bool IsHit() const { return entity.IsValid(); }
+};
+
+// Raycasts, overlap and sweep queries against the physics broadphase. Candidates come from the
+// static and dynamic AABB trees; each one is then tested against its exact box or sphere.
+// Results reflect the last PhysicsSystem::Update. Queries are const and may run on several
+// threads at once, but not while the physics system updates.
+class PhysicsQuery
+{
+public:
+    PhysicsQuery(const Broadphase& broadphase, std::span<const QueryCollider> colliders)
+        : m_Broadphase(&broadphase)
+        , m_Colliders(colliders)
+    {}
+
+    // Closest hit along the ray.
+    bool Raycast(const Ray& ray, RaycastHit& outHit, const QueryFilter& filter = {}) const;
+    // Closest hit for every ray, spread over the job pool. outHits needs one entry per ray.
+    void RaycastBatch(std::span<const Ray> rays, std::span<RaycastHit> outHits, const QueryFilter& filter = {}) const;
+
+    // Append every collider that overlaps the shape to out and return how many were added.
+    std::size_t OverlapSphere(const ecs::Vec3& center, float radius, std::vector<ecs::Entity>& out, const QueryFilter& filter = {}) const;
+    std::size_t OverlapBox(
+        const ecs::Vec3& center,
+        const ecs::Vec3& halfExtents,
+        const ecs::Vec3& rotation,
+        std::vector<ecs::Entity>& out,
+        const QueryFilter& filter = {}) const;
+
+    // First collider the shape touches moving along the unit direction for up to maxDistance.
+    bool SweepSphere(
+        const ecs::Vec3& center,
+        float radius,
+        const ecs::Vec3& direction,
+        float maxDistance,
+        SweepHit& outHit,
+        const QueryFilter& filter = {}) const;
+    bool SweepBox(
+        const ecs::Vec3& center,
+        const ecs::Vec3& halfExtents,
+        const ecs::Vec3& rotation,
+        const ecs::Vec3& direction,
+        float maxDistance,
+        SweepHit& outHit,
+        const QueryFilter& filter = {}) const;
+
+private:
+    const QueryCollider* Find(std::uint32_t proxy, const QueryFilter& filter) const;
+    template <typename Visitor>
+    void QueryBounds(const Aabb& bounds, const QueryFilter& filter, Visitor&& visitor) const;
+    std::size_t Overlap(const QueryCollider& shape, std::vector<ecs::Entity>& out, const QueryFilter& filter) const;
+    bool Sweep(const QueryCollider& shape, const ecs::Vec3& direction, float maxDistance, SweepHit& outHit, const QueryFilter& filter) const;
+
+    const Broadphase* m_Broadphase = nullptr;
+    std::span<const QueryCollider> m_Colliders;
+};
+}
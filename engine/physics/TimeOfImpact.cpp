@@ -0,0 +1,234 @@
+#include "TimeOfImpact.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace physics
+{
+namespace
+{
+using ecs::Vec3;
+
+constexpr float kParallelEpsilon = 1.0e-9f;
+
+float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+Vec3 Scale(const Vec3& v, float s) { return { v.x * s, v.y * s, v.z * s }; }
+Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+
+const Vec3& AxisAt(const BoxAxes& axes, int index)
+{
+    return index == 0 ? axes.xAxis : (index == 1 ? axes.yAxis : axes.zAxis);
+}
+
+float ProjectedRadius(const SweepShape& box, const Vec3& axis)
+{
+    return std::abs(Dot(axis, box.axes.xAxis)) * box.halfExtents.x +
+           std::abs(Dot(axis, box.axes.yAxis)) * box.halfExtents.y +
+           std::abs(Dot(axis, box.axes.zAxis)) * box.halfExtents.z;
+}
+
+// Narrows [enter, exit] to the times at which offset + speed * t lies inside (-reach, reach).
+// Returns false when the interval becomes empty.
+bool ClipInterval(float offset, float speed, float reach, float& enter, float& exit)
+{
+    if (std::abs(speed) < kParallelEpsilon)
+        return std::abs(offset) < reach;
+    float t0 = (-reach - offset) / speed;
+    float t1 = (reach - offset) / speed;
+    if (t0 > t1)
+        std::swap(t0, t1);
+    enter = std::max(enter, t0);
+    exit = std::min(exit, t1);
+    return enter < exit;
+}
+
+// The interval starts at -inf: an entry time at or before 0 means the shapes already overlap.
+bool FinishInterval(float enter, float exit, float& outFraction)
+{
+    if (enter <= 0.0f || enter > 1.0f || enter >= exit)
+        return false;
+    outFraction = enter;
+    return true;
+}
+
+bool SphereSphere(const SweepShape& a, const SweepShape& b, const Vec3& motion, float targetDepth, float& outFraction)
+{
+    const float reach = a.radius + b.radius - targetDepth;
+    if (reach <= 0.0f)
+        return false;
+    const Vec3 d = Sub(a.center, b.center);
+    const float c = Dot(d, d) - reach * reach;
+    const float qa = Dot(motion, motion);
+    const float qb = Dot(d, motion);
+    if (c <= 0.0f || qb >= 0.0f || qa < kParallelEpsilon)
+        return false;
+    const float discriminant = qb * qb - qa * c;
+    if (discriminant < 0.0f)
+        return false;
+    const float t = (-qb - std::sqrt(discriminant)) / qa;
+    if (t <= 0.0f || t > 1.0f)
+        return false;
+    outFraction = t;
+    return true;
+}
+
+// Sphere centre moving by motion against the box grown by the radius, in box space.
+bool SphereBox(const SweepShape& sphere, const SweepShape& box, const Vec3& motion, float targetDepth, float& outFraction)
+{
+    const Vec3 offset = Sub(sphere.center, box.center);
+    const float grow = sphere.radius - targetDepth;
+    float enter = -std::numeric_limits<float>::max();
+    float exit = std::numeric_limits<float>::max();
+    const float halves[3] = { box.halfExtents.x, box.halfExtents.y, box.halfExtents.z };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const Vec3& direction = AxisAt(box.axes, axis);
+        const float reach = halves[axis] + grow;
+        if (reach <= 0.0f || !ClipInterval(Dot(offset, direction), Dot(motion, direction), reach, enter, exit))
+            return false;
+    }
+    return FinishInterval(enter, exit, outFraction);
+}
+
+bool BoxBox(const SweepShape& a, const SweepShape& b, const Vec3& motion, float targetDepth, float& outFraction)
+{
+    const Vec3 d = Sub(a.center, b.center);
+    float enter = -std::numeric_limits<float>::max();
+    float exit = std::numeric_limits<float>::max();
+    const auto testAxis = [&](const Vec3& axis)
+    {
+        const float reach = ProjectedRadius(a, axis) + ProjectedRadius(b, axis) - targetDepth;
+        return reach > 0.0f && ClipInterval(Dot(d, axis), Dot(motion, axis), reach, enter, exit);
+    };
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (!testAxis(AxisAt(a.axes, axis)) || !testAxis(AxisAt(b.axes, axis)))
+            return false;
+    }
+    for (int axisA = 0; axisA < 3; ++axisA)
+    {
+        for (int axisB = 0; axisB < 3; ++axisB)
+        {
+            const Vec3 cross = Cross(AxisAt(a.axes, axisA), AxisAt(b.axes, axisB));
+            const float lengthSq = Dot(cross, cross);
+            if (lengthSq <= 0.000001f)
+                continue;
+            if (!testAxis(Scale(cross, 1.0f / std::sqrt(lengthSq))))
+                return false;
+        }
+    }
+    return FinishInterval(enter, exit, outFraction);
+}
+
+void Project(std::span<const Vec3> vertices, const Vec3& axis, float& outMin, float& outMax)
+{
+    outMin = std::numeric_limits<float>::max();
+    outMax = -std::numeric_limits<float>::max();
+    for (const Vec3& v : vertices)
+    {
+        const float d = Dot(v, axis);
+        outMin = std::min(outMin, d);
+        outMax = std::max(outMax, d);
+    }
+}
+}
+
+bool ComputeTimeOfImpact(
+    const SweepShape& a,
+    const SweepShape& b,
+    const ecs::Vec3& motion,
+    float targetDepth,
+    float& outFraction)
+{
+    if (a.isSphere && b.isSphere)
+        return SphereSphere(a, b, motion, targetDepth, outFraction);
+    if (a.isSphere)
+        return SphereBox(a, b, motion, targetDepth, outFraction);
+    if (b.isSphere)
+        return SphereBox(b, a, Scale(motion, -1.0f), targetDepth, outFraction);
+    return BoxBox(a, b, motion, targetDepth, outFraction);
+}
+
+bool ComputeConvexTimeOfImpact(
+    const ConvexView& a,
+    const ConvexView& b,
+    const ecs::Vec3& motion,
+    float targetDepth,
+    float& outFraction)
+{
+    const Vec3 d = Sub(a.origin, b.origin);
+    float enter = -std::numeric_limits<float>::max();
+    float exit = std::numeric_limits<float>::max();
+    // Projection intervals are not centred on the origins; clip their midpoints instead.
+    const auto testAxis = [&](const Vec3& axis)
+    {
+        float minA = 0.0f;
+        float maxA = 0.0f;
+        float minB = 0.0f;
+        float maxB = 0.0f;
+        Project(a.vertices, axis, minA, maxA);
+        Project(b.vertices, axis, minB, maxB);
+        const float offset = (minA + maxA) * 0.5f + Dot(d, axis) - (minB + maxB) * 0.5f;
+        const float reach = (maxA - minA) * 0.5f + (maxB - minB) * 0.5f - targetDepth;
+        return reach > 0.0f && ClipInterval(offset, Dot(motion, axis), reach, enter, exit);
+    };
+
+    for (const Vec3& normal : a.faceNormals)
+    {
+        if (!testAxis(normal))
+            return false;
+    }
+    for (const Vec3& normal : b.faceNormals)
+    {
+        if (!testAxis(normal))
+            return false;
+    }
+    // The Minkowski difference only translates during the sweep, so its faces stay the same.
+    for (const HullEdge& ea : a.edges)
+    {
+        const Vec3 directionA = Sub(a.vertices[ea.vertex1], a.vertices[ea.vertex0]);
+        for (const HullEdge& eb : b.edges)
+        {
+            if (!IsMinkowskiFace(
+                    a.faceNormals[ea.face0], a.faceNormals[ea.face1],
+                    Scale(b.faceNormals[eb.face0], -1.0f), Scale(b.faceNormals[eb.face1], -1.0f)))
+            {
+                continue;
+            }
+            const Vec3 axis = Cross(directionA, Sub(b.vertices[eb.vertex1], b.vertices[eb.vertex0]));
+            const float lengthSq = Dot(axis, axis);
+            if (lengthSq <= kParallelEpsilon)
+                continue;
+            if (!testAxis(Scale(axis, 1.0f / std::sqrt(lengthSq))))
+                return false;
+        }
+    }
+    return FinishInterval(enter, exit, outFraction);
+}
+
+bool ComputeSphereConvexTimeOfImpact(
+    const ecs::Vec3& center,
+    float radius,
+    const ConvexView& b,
+    const ecs::Vec3& motion,
+    float targetDepth,
+    float& outFraction)
+{
+    const Vec3 d = Sub(center, b.origin);
+    float enter = -std::numeric_limits<float>::max();
+    float exit = std::numeric_limits<float>::max();
+    for (const Vec3& normal : b.faceNormals)
+    {
+        float minB = 0.0f;
+        float maxB = 0.0f;
+        Project(b.vertices, normal, minB, maxB);
+        const float reach = radius + (maxB - minB) * 0.5f - targetDepth;
+        if (reach <= 0.0f || !ClipInterval(Dot(d, normal) - (minB + maxB) * 0.5f, Dot(motion, normal), reach, enter, exit))
+            return false;
+    }
+    return FinishInterval(enter, exit, outFraction);
+}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ConvexContact.h"
+#include "NarrowphaseKernels.h"
+
+namespace physics
+{
+// A collider at the start of a sweep. Boxes use halfExtents and axes, spheres use radius.
+struct SweepShape
+{
+    ecs::Vec3 center{};
+    bool isSphere = false;
+    float radius = 0.0f;
+    ecs::Vec3 halfExtents{};
+    BoxAxes axes{};
+};
+
+// Earliest fraction in (0, 1] of the translation `motion` (of A relative to B) at which A
+// penetrates B by targetDepth. Pairs already penetrating that deep at the start, or that never
+// reach it, report no impact: the discrete contact solver owns those. Bodies do not rotate,
+// so box-box is exact through the separating-axis test on the moving interval of every axis;
+// box-sphere sweeps the sphere centre against the box grown by the radius (slightly early at
+// edges and corners).
+bool ComputeTimeOfImpact(
+    const SweepShape& a,
+    const SweepShape& b,
+    const ecs::Vec3& motion,
+    float targetDepth,
+    float& outFraction);
+
+// The same for two convex polytopes, exact through the separating-axis test on the face axes
+// and the edge pairs of their Minkowski difference. Used for hulls and mesh triangles.
+bool ComputeConvexTimeOfImpact(
+    const ConvexView& a,
+    const ConvexView& b,
+    const ecs::Vec3& motion,
+    float targetDepth,
+    float& outFraction);
+// A sphere moving by motion against a polytope grown by the radius along its face planes:
+// exact on faces, slightly early at edges and corners, like box-sphere.
+bool ComputeSphereConvexTimeOfImpact(
+    const ecs::Vec3& center,
+    float radius,
+    const ConvexView& b,
+    const ecs::Vec3& motion,
+    float targetDepth,
+    float& outFraction);
+}
@@ -0,0 +1,139 @@
+#include "TriangleMesh.h"
+
+#include "ConvexHull.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace physics
+{
+namespace
+{
+using ecs::Vec3;
+
+constexpr float kInfinity = std::numeric_limits<float>::max();
+
+Aabb EmptyBounds()
+{
+    return Aabb{ Vec3{ kInfinity, kInfinity, kInfinity }, Vec3{ -kInfinity, -kInfinity, -kInfinity } };
+}
+
+void Grow(Aabb& bounds, const Vec3& p)
+{
+    bounds.min = Vec3{ std::min(bounds.min.x, p.x), std::min(bounds.min.y, p.y), std::min(bounds.min.z, p.z) };
+    bounds.max = Vec3{ std::max(bounds.max.x, p.x), std::max(bounds.max.y, p.y), std::max(bounds.max.z, p.z) };
+}
+
+float AxisOf(const Vec3& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+Aabb TriangleBounds(const TriangleMesh& mesh, std::span<const std::uint32_t> indices, std::uint32_t triangle)
+{
+    Aabb bounds = EmptyBounds();
+    for (std::uint32_t corner = 0; corner < 3; ++corner)
+        Grow(bounds, mesh.vertices[indices[triangle * 3 + corner]]);
+    return bounds;
+}
+
+struct Builder
+{
+    TriangleMesh& mesh;
+    std::span<const std::uint32_t> sourceIndices;
+    std::vector<Vec3> centroids;
+    // Source triangle of every leaf slot; ranges of it are partitioned in place.
+    std::vector<std::uint32_t> order;
+
+    void Build(std::uint32_t begin, std::uint32_t end)
+    {
+        const auto nodeIndex = static_cast<std::uint32_t>(mesh.nodes.size());
+        mesh.nodes.emplace_back();
+        Aabb bounds = EmptyBounds();
+        Aabb centroidBounds = EmptyBounds();
+        for (std::uint32_t i = begin; i < end; ++i)
+        {
+            bounds = Union(bounds, TriangleBounds(mesh, sourceIndices, order[i]));
+            Grow(centroidBounds, centroids[order[i]]);
+        }
+        mesh.nodes[nodeIndex].bounds = bounds;
+        if (end - begin <= kMaxTrianglesPerLeaf)
+        {
+            mesh.nodes[nodeIndex].first = begin;
+            mesh.nodes[nodeIndex].count = end - begin;
+            return;
+        }
+
+        const Vec3 extent{
+            centroidBounds.max.x - centroidBounds.min.x,
+            centroidBounds.max.y - centroidBounds.min.y,
+            centroidBounds.max.z - centroidBounds.min.z };
+        const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        const std::uint32_t middle = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+            [&](std::uint32_t lhs, std::uint32_t rhs) { return AxisOf(centroids[lhs], axis) < AxisOf(centroids[rhs], axis); });
+
+        Build(begin, middle);
+        mesh.nodes[nodeIndex].first = static_cast<std::uint32_t>(mesh.nodes.size());
+        Build(middle, end);
+    }
+};
+}
+
+TriangleMesh BuildTriangleMesh(std::span<const ecs::Vec3> vertices, std::span<const std::uint32_t> indices)
+{
+    TriangleMesh mesh;
+    const auto triangleCount = static_cast<std::uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+        return mesh;
+    mesh.vertices.assign(vertices.begin(), vertices.end());
+
+    Builder builder{ mesh, indices, {}, {} };
+    builder.centroids.resize(triangleCount);
+    for (std::uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        const Vec3& a = vertices[indices[triangle * 3]];
+        const Vec3& b = vertices[indices[triangle * 3 + 1]];
+        const Vec3& c = vertices[indices[triangle * 3 + 2]];
+        builder.centroids[triangle] = Vec3{ (a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f };
+    }
+    builder.order.resize(triangleCount);
+    std::iota(builder.order.begin(), builder.order.end(), 0u);
+    mesh.nodes.reserve(static_cast<std::size_t>(triangleCount) * 2 / kMaxTrianglesPerLeaf + 1);
+    builder.Build(0, triangleCount);
+
+    mesh.indices.resize(static_cast<std::size_t>(triangleCount) * 3);
+    for (std::uint32_t slot = 0; slot < triangleCount; ++slot)
+    {
+        for (std::uint32_t corner = 0; corner < 3; ++corner)
+            mesh.indices[slot * 3 + corner] = indices[builder.order[slot] * 3 + corner];
+    }
+    return mesh;
+}
+
+TriangleMesh TransformTriangleMesh(const TriangleMesh& mesh, const BoxAxes& axes, const ecs::Vec3& scale)
+{
+    TriangleMesh transformed;
+    transformed.vertices.reserve(mesh.vertices.size());
+    for (const Vec3& v : mesh.vertices)
+        transformed.vertices.push_back(ScaleRotate(axes, scale, v));
+    transformed.indices = mesh.indices;
+    transformed.nodes = mesh.nodes;
+
+    // Children come after their parent, so a reverse sweep refits bottom-up.
+    for (std::size_t index = transformed.nodes.size(); index-- > 0;)
+    {
+        BvhNode& node = transformed.nodes[index];
+        if (node.count == 0)
+        {
+            node.bounds = Union(transformed.nodes[index + 1].bounds, transformed.nodes[node.first].bounds);
+            continue;
+        }
+        node.bounds = EmptyBounds();
+        for (std::uint32_t triangle = node.first; triangle < node.first + node.count; ++triangle)
+            node.bounds = Union(node.bounds, TriangleBounds(transformed, transformed.indices, triangle));
+    }
+    return transformed;
+}
+}
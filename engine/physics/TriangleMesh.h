@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Aabb.h"
+#include "NarrowphaseKernels.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace physics
+{
+// Triangles per BVH leaf.
+inline constexpr std::uint32_t kMaxTrianglesPerLeaf = 4;
+
+struct BvhNode
+{
+    Aabb bounds{};
+    // Leaves hold triangles [first, first + count). Inner nodes have count 0: the left child
+    // follows the node, and first is the right child.
+    std::uint32_t first = 0;
+    std::uint32_t count = 0;
+};
+
+// Triangle soup with a static bounding volume hierarchy, the mid-phase of mesh colliders: a
+// contact test or sweep only visits the triangles the other body's bounds reach.
+struct TriangleMesh
+{
+    std::vector<ecs::Vec3> vertices;
+    // Three vertex indices per triangle, in leaf order.
+    std::vector<std::uint32_t> indices;
+    // Depth-first order, root first, so children always come after their parent.
+    std::vector<BvhNode> nodes;
+
+    [[nodiscard]] bool IsValid() const { return !nodes.empty(); }
+    [[nodiscard]] std::size_t GetTriangleCount() const { return indices.size() / 3; }
+
+    // Calls visitor(triangleIndex) for every triangle whose bounds overlap bounds.
+    template <typename Visitor>
+    void Query(const Aabb& bounds, Visitor&& visitor) const
+    {
+        if (nodes.empty())
+            return;
+        std::uint32_t stack[64];
+        std::size_t size = 0;
+        stack[size++] = 0;
+        while (size > 0)
+        {
+            const std::uint32_t index = stack[--size];
+            const BvhNode& node = nodes[index];
+            if (!Overlaps(node.bounds, bounds))
+                continue;
+            if (node.count == 0)
+            {
+                stack[size++] = index + 1;
+                stack[size++] = node.first;
+                continue;
+            }
+            for (std::uint32_t triangle = node.first; triangle < node.first + node.count; ++triangle)
+            {
+                const ecs::Vec3& a = vertices[indices[triangle * 3]];
+                const ecs::Vec3& b = vertices[indices[triangle * 3 + 1]];
+                const ecs::Vec3& c = vertices[indices[triangle * 3 + 2]];
+                const Aabb triangleBounds{
+                    ecs::Vec3{ std::min(a.x, std::min(b.x, c.x)), std::min(a.y, std::min(b.y, c.y)), std::min(a.z, std::min(b.z, c.z)) },
+                    ecs::Vec3{ std::max(a.x, std::max(b.x, c.x)), std::max(a.y, std::max(b.y, c.y)), std::max(a.z, std::max(b.z, c.z)) } };
+                if (Overlaps(triangleBounds, bounds))
+                    visitor(triangle);
+            }
+        }
+    }
+};
+
+// Nodes split their triangles at the centroid median along the longest axis until a leaf holds
+// kMaxTrianglesPerLeaf, which keeps the depth logarithmic.
+TriangleMesh BuildTriangleMesh(std::span<const ecs::Vec3> vertices, std::span<const std::uint32_t> indices);
+// The mesh scaled per axis, then rotated by the box axes. The hierarchy keeps its topology;
+// only the node bounds are refit.
+TriangleMesh TransformTriangleMesh(const TriangleMesh& mesh, const BoxAxes& axes, const ecs::Vec3& scale);
+}
@@ -1,7 +1,15 @@
 #include "InputManager.h"
 
+#include <algorithm>
+
 bool InputManager::IsActionActive(const std::string& action) const
 {
+    if (m_Replaying)
+    {
+        const auto replayIt = m_ReplayActions.find(action);
+        return replayIt != m_ReplayActions.end() && replayIt->second;
+    }
+
     const auto it = m_ActionMap.find(action);
     return it != m_ActionMap.end() && IsKeyPressed(it->second);
 }
@@ -22,3 +30,29 @@ ecs::Vec3 InputManager::GetMovementAxis() const
     if (IsActionActive("MoveDown")) move.y -= 1.0f;
     return move;
 }
+
+std::vector<std::string> InputManager::GetBoundActions() const
+{
+    std::vector<std::string> actions;
+    actions.reserve(m_ActionMap.size());
+    for (const auto& [action, key] : m_ActionMap)
+    {
+        (void)key;
+        actions.push_back(action);
+    }
+    std::sort(actions.begin(), actions.end());
+    return actions;
+}
+
+void InputManager::SetReplayActions(const std::vector<std::string>& actions, std::uint32_t activeMask)
+{
+    for (std::size_t i = 0; i < actions.size() && i < 32; ++i)
+        m_ReplayActions[actions[i]] = (activeMask & (1u << i)) != 0;
+    m_Replaying = true;
+}
+
+void InputManager::ClearReplayActions()
+{
+    m_ReplayActions.clear();
+    m_Replaying = false;
+}
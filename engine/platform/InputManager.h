@@ -1,8 +1,10 @@
 #pragma once
 #include "../ecs/MathTypes.h"
 #include <GLFW/glfw3.h>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class InputManager
 {
@@ -12,7 +14,15 @@ public:
     bool IsActionActive(const std::string& action) const;
     bool IsKeyPressed(int glfwKey) const;
     ecs::Vec3 GetMovementAxis() const;
+
+    // Sorted so recorded action masks do not depend on hash map order.
+    std::vector<std::string> GetBoundActions() const;
+    void SetReplayActions(const std::vector<std::string>& actions, std::uint32_t activeMask);
+    void ClearReplayActions();
+    bool IsReplaying() const { return m_Replaying; }
 private:
     GLFWwindow* m_Window = nullptr;
     std::unordered_map<std::string, int> m_ActionMap;
+    std::unordered_map<std::string, bool> m_ReplayActions;
+    bool m_Replaying = false;
 };
@@ -1,16 +1,30 @@
 #pragma once
 
 #include "MeshData.h"
+#include "../physics/MeshShape.h"
 #include "../render/RenderResourceHandles.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
+// Bounds of all vertex positions in mesh space, computed once at load.
+struct MeshBounds
+{
+    physics::Aabb box{};
+    ecs::Vec3 sphereCenter{};
+    float sphereRadius = 0.0f;
+};
+
 struct MeshResource
 {
     std::string name = "UnnamedMesh";
     std::string sourcePath;
     MeshData meshData;
+    // Stored in the binary cache with the mesh, so collider fits never scan vertices.
+    MeshBounds bounds;
+    // Baked at import and stored in the binary cache; shared with the colliders built from it.
+    std::shared_ptr<const physics::MeshShape> collisionShape;
     RenderMeshHandle gpuHandle{};
     std::uint64_t gpuHandleVersion = 0;
     bool placeholder = true;
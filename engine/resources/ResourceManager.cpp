@@ -1,6 +1,7 @@
 #include "ResourceManager.h"
 
 #include <chrono>
+#include <iterator>
 
 ResourceManager::ResourceManager()
 {
@@ -25,7 +26,10 @@ void ResourceManager::ClearAll()
     m_ShaderCache.clear();
     m_MaterialCache.clear();
     m_HotReloadWatches.clear();
+    m_HotReloadWatchIndex.clear();
+    m_HotReloadCursor = 0;
     m_PendingAsyncKeys.clear();
+    m_LoadedNotifications.clear();
 
     Logger::Get().Info(
         "ResourceManager: cleared all caches mesh=" + std::to_string(meshCount) +
@@ -34,31 +38,57 @@ void ResourceManager::ClearAll()
         " material=" + std::to_string(materialCount));
 }
 
-void ResourceManager::PollAsyncLoads()
+std::size_t ResourceManager::PollAsyncLoads()
 {
-    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
-
-    auto it = m_AsyncTasks.begin();
-    while (it != m_AsyncTasks.end())
+    AllocationScope allocationScope(AllocationTag::Resources, "ResourceManager::PollAsyncLoads");
+    std::size_t completed = 0;
+    std::vector<LoadedNotification> notifications;
+    std::vector<LoadedSubscription> listeners;
     {
-        if (it->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+        auto it = m_AsyncTasks.begin();
+        while (it != m_AsyncTasks.end())
         {
-            ++it;
-            continue;
+            if (it->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++it;
+                continue;
+            }
+
+            it->future.get();
+            it = m_AsyncTasks.erase(it);
+            ++completed;
         }
 
-        it->future.get();
-        it = m_AsyncTasks.erase(it);
+        notifications.swap(m_LoadedNotifications);
+        if (!notifications.empty())
+            listeners = m_LoadedListeners;
+    }
+
+    // Outside the lock, so listeners may load or query resources themselves.
+    for (const LoadedNotification& notification : notifications)
+    {
+        for (const LoadedSubscription& subscription : listeners)
+        {
+            if (subscription.kind == notification.kind)
+                subscription.listener(notification.key);
+        }
     }
+
+    return completed;
 }
 
-void ResourceManager::PollHotReload()
+bool ResourceManager::PollHotReload(std::size_t maxWatches)
 {
+    AllocationScope allocationScope(AllocationTag::Resources, "ResourceManager::PollHotReload");
     std::lock_guard<std::recursive_mutex> lock(m_Mutex);
 
-    for (auto& [watchKey, watch] : m_HotReloadWatches)
+    if (m_HotReloadCursor >= m_HotReloadWatches.size())
+        m_HotReloadCursor = 0;
+
+    for (std::size_t checked = 0; m_HotReloadCursor < m_HotReloadWatches.size() && checked < maxWatches; ++checked)
     {
-        (void)watchKey;
+        HotReloadWatch& watch = m_HotReloadWatches[m_HotReloadCursor++];
         if (watch.path.empty() || !std::filesystem::exists(watch.path))
             continue;
 
@@ -72,22 +102,31 @@ void ResourceManager::PollHotReload()
 
         watch.lastWriteTime = currentWriteTime;
         watch.fileSize = currentFileSize;
+
+        // Reloading may register new watches and grow the vector, so stop using the reference.
+        const std::string key = watch.key;
         switch (watch.kind)
         {
         case ResourceKind::Mesh:
-            (void)Reload<MeshResource>(watch.key);
+            (void)Reload<MeshResource>(key);
             break;
         case ResourceKind::Texture:
-            (void)Reload<TextureResource>(watch.key);
+            (void)Reload<TextureResource>(key);
             break;
         case ResourceKind::Shader:
-            (void)Reload<ShaderResource>(watch.key);
+            (void)Reload<ShaderResource>(key);
             break;
         case ResourceKind::Material:
-            (void)Reload<MaterialResource>(watch.key);
+            (void)Reload<MaterialResource>(key);
             break;
         }
 
-        Logger::Get().Info("ResourceManager: hot reload detected key=" + watch.key);
+        Logger::Get().Info("ResourceManager: hot reload detected key=" + key);
     }
+
+    if (m_HotReloadCursor < m_HotReloadWatches.size())
+        return false;
+
+    m_HotReloadCursor = 0;
+    return true;
 }
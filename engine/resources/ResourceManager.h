@@ -9,11 +9,14 @@
 #include "loaders/MeshLoader.h"
 #include "loaders/ShaderLoader.h"
 #include "loaders/TextureLoader.h"
+#include "../core/AllocationTracker.h"
 #include "../core/AssetPaths.h"
 #include "../core/Logger.h"
 
 #include <filesystem>
+#include <functional>
 #include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <cstdint>
@@ -22,6 +25,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 template <typename T>
 inline constexpr bool kUnsupportedResourceType = false;
@@ -40,12 +44,16 @@ public:
         std::uint64_t estimatedCpuBytes = 0;
     };
 
+    // Receives the key of a resource that finished loading or reloading, successfully or not.
+    using LoadedListener = std::function<void(const std::string& key)>;
+
     ResourceManager();
     ~ResourceManager() = default;
 
     template <typename T>
     ResourceHandle<T> Load(const std::filesystem::path& path)
     {
+        AllocationScope allocationScope(AllocationTag::Resources, "ResourceManager::Load");
         std::lock_guard<std::recursive_mutex> lock(m_Mutex);
         const std::string key = NormalizeKey<T>(path);
         if (key.empty())
@@ -72,12 +80,14 @@ public:
                 false);
 
             GetCache<T>()[key] = resource;
+            QueueLoadedNotification<T>(key);
             Logger::Get().Info("ResourceManager: loaded [" + ResourceTypeName<T>() + "] key=" + key);
             return resource;
         }
 
         auto fallback = CreateFallbackResource<T>(key, result.errorMessage);
         GetCache<T>()[key] = fallback;
+        QueueLoadedNotification<T>(key);
         Logger::Get().Warn(
             "ResourceManager: load failed [" + ResourceTypeName<T>() + "] key=" + key +
             " -> using default. " + result.errorMessage);
@@ -87,6 +97,7 @@ public:
     template <typename T>
     std::future<ResourceHandle<T>> LoadAsync(const std::filesystem::path& path)
     {
+        AllocationScope allocationScope(AllocationTag::Resources, "ResourceManager::LoadAsync");
         std::lock_guard<std::recursive_mutex> lock(m_Mutex);
         const std::string key = NormalizeKey<T>(path);
         if (key.empty())
@@ -166,6 +177,7 @@ public:
         const ResourceLoadResult<T> result = InvokeLoader<T>(key);
         auto& cache = GetCache<T>();
         auto existing = FindCachedResource<T>(key);
+        QueueLoadedNotification<T>(key);
         if (result.success)
         {
             if (existing)
@@ -214,11 +226,29 @@ public:
             std::filesystem::is_regular_file(resolvedPath)
                 ? std::filesystem::file_size(resolvedPath)
                 : 0;
-        m_HotReloadWatches[key + "#" + std::to_string(static_cast<int>(watch.kind))] = watch;
+
+        // Watches only ever get appended, so PollHotReload's cursor stays valid across frames.
+        const std::string watchId = key + "#" + std::to_string(static_cast<int>(watch.kind));
+        const auto [indexIt, inserted] = m_HotReloadWatchIndex.try_emplace(watchId, m_HotReloadWatches.size());
+        if (inserted)
+            m_HotReloadWatches.push_back(std::move(watch));
+        else
+            m_HotReloadWatches[indexIt->second] = std::move(watch);
     }
 
-    void PollHotReload();
-    void PollAsyncLoads();
+    // Checks up to maxWatches watched files, resuming where the previous call stopped.
+    // Returns true when the call reached the end of the watch list.
+    bool PollHotReload(std::size_t maxWatches = std::numeric_limits<std::size_t>::max());
+    // Collects finished async loads, then delivers the load notifications queued since the
+    // previous call. Listeners always run here, on the polling thread, never on a loader thread.
+    std::size_t PollAsyncLoads();
+
+    template <typename T>
+    void SubscribeLoaded(LoadedListener listener)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+        m_LoadedListeners.push_back(LoadedSubscription{ ResourceKindFor<T>(), std::move(listener) });
+    }
 
     ResourceStats GetStats() const
     {
@@ -270,6 +300,18 @@ private:
         std::future<void> future;
     };
 
+    struct LoadedSubscription
+    {
+        ResourceKind kind = ResourceKind::Mesh;
+        LoadedListener listener;
+    };
+
+    struct LoadedNotification
+    {
+        ResourceKind kind = ResourceKind::Mesh;
+        std::string key;
+    };
+
     template <typename T>
     CacheMap<T>& GetCache()
     {
@@ -325,6 +367,7 @@ private:
     template <typename T>
     ResourceLoadResult<T> InvokeLoader(const std::string& key) const
     {
+        AllocationScope allocationScope(AllocationTag::Resources, "ResourceManager::InvokeLoader");
         const std::filesystem::path resolvedPath = ResolvePathFromKey<T>(key);
 
         if constexpr (std::is_same_v<T, MeshResource>)
@@ -472,6 +515,12 @@ private:
             sizeof(resource.baseColor));
     }
 
+    template <typename T>
+    void QueueLoadedNotification(const std::string& key)
+    {
+        m_LoadedNotifications.push_back(LoadedNotification{ ResourceKindFor<T>(), key });
+    }
+
     template <typename T>
     std::string MakeAsyncToken(const std::string& key) const
     {
@@ -518,6 +567,7 @@ private:
                     if (error.empty() && result.success)
                     {
                         cached->ReplaceData(std::move(result.data), ResourceLoadState::Loaded, false);
+                        QueueLoadedNotification<T>(key);
                         Logger::Get().Info("ResourceManager: async load completed [" + ResourceTypeName<T>() + "] key=" + key);
 
                         if constexpr (std::is_same_v<T, MaterialResource>)
@@ -534,6 +584,7 @@ private:
                         const std::string finalError = error.empty() ? result.errorMessage : error;
                         T fallbackData = GetDefault<T>() != nullptr ? GetDefault<T>()->GetData() : T{};
                         cached->ReplaceData(std::move(fallbackData), ResourceLoadState::Failed, true, finalError);
+                        QueueLoadedNotification<T>(key);
                         Logger::Get().Warn(
                             "ResourceManager: async load failed [" + ResourceTypeName<T>() + "] key=" + key +
                             ". " + finalError);
@@ -549,9 +600,13 @@ private:
     CacheMap<TextureResource> m_TextureCache;
     CacheMap<ShaderResource> m_ShaderCache;
     CacheMap<MaterialResource> m_MaterialCache;
-    std::unordered_map<std::string, HotReloadWatch> m_HotReloadWatches;
+    std::vector<HotReloadWatch> m_HotReloadWatches;
+    std::unordered_map<std::string, std::size_t> m_HotReloadWatchIndex;
+    std::size_t m_HotReloadCursor = 0;
     std::vector<AsyncTask> m_AsyncTasks;
     std::unordered_set<std::string> m_PendingAsyncKeys;
+    std::vector<LoadedSubscription> m_LoadedListeners;
+    std::vector<LoadedNotification> m_LoadedNotifications;
 
     ResourceHandle<MeshResource> m_DefaultMesh;
     ResourceHandle<TextureResource> m_DefaultTexture;
@@ -7,17 +7,24 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 namespace
 {
 constexpr char kMeshCacheMagic[4] = { 'W', 'M', 'S', 'H' };
 // Version 2 flips imported OBJ UVs into the engine's top-left texture convention.
-constexpr std::uint32_t kMeshCacheVersion = 2;
+// Version 3 appends the baked collision shape (triangle BVH and convex hull).
+// Version 4 appends the mesh bounds (box and bounding sphere).
+constexpr std::uint32_t kMeshCacheVersion = 4;
+constexpr std::uint32_t kMaxCollisionArraySize = 1u << 26;
 
 std::filesystem::path BuildBinaryCachePath(const std::filesystem::path& sourcePath)
 {
@@ -47,6 +54,139 @@ bool ReadString(std::ifstream& stream, std::string& outValue)
     return stream.good();
 }
 
+template <typename T>
+void WriteArray(std::ofstream& stream, const std::vector<T>& values)
+{
+    const auto count = static_cast<std::uint32_t>(values.size());
+    stream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    if (count > 0)
+        stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(sizeof(T) * count));
+}
+
+template <typename T>
+bool ReadArray(std::ifstream& stream, std::vector<T>& outValues)
+{
+    std::uint32_t count = 0;
+    stream.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!stream.good() || count > kMaxCollisionArraySize)
+        return false;
+
+    outValues.resize(count);
+    if (count > 0)
+        stream.read(reinterpret_cast<char*>(outValues.data()), static_cast<std::streamsize>(sizeof(T) * count));
+    return stream.good();
+}
+
+void WriteCollisionShape(std::ofstream& stream, const physics::MeshShape& shape)
+{
+    stream.write(reinterpret_cast<const char*>(&shape.bounds), sizeof(shape.bounds));
+    WriteArray(stream, shape.triangles.vertices);
+    WriteArray(stream, shape.triangles.indices);
+    WriteArray(stream, shape.triangles.nodes);
+    WriteArray(stream, shape.hull.vertices);
+    WriteArray(stream, shape.hull.triangles);
+    WriteArray(stream, shape.hull.edges);
+}
+
+bool ReadCollisionShape(std::ifstream& stream, physics::MeshShape& outShape)
+{
+    stream.read(reinterpret_cast<char*>(&outShape.bounds), sizeof(outShape.bounds));
+    return stream.good() &&
+        ReadArray(stream, outShape.triangles.vertices) &&
+        ReadArray(stream, outShape.triangles.indices) &&
+        ReadArray(stream, outShape.triangles.nodes) &&
+        ReadArray(stream, outShape.hull.vertices) &&
+        ReadArray(stream, outShape.hull.triangles) &&
+        ReadArray(stream, outShape.hull.edges);
+}
+
+float DistanceSquared(const ecs::Vec3& a, const ecs::Vec3& b)
+{
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    const float dz = a.z - b.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+ecs::Vec3 VertexPosition(const MeshVertex& vertex)
+{
+    return ecs::Vec3{ vertex.position[0], vertex.position[1], vertex.position[2] };
+}
+
+std::shared_ptr<const physics::MeshShape> BakeCollisionShape(const MeshData& meshData)
+{
+    std::vector<ecs::Vec3> positions;
+    positions.reserve(meshData.vertices.size());
+    for (const MeshVertex& vertex : meshData.vertices)
+        positions.push_back(VertexPosition(vertex));
+    return std::make_shared<const physics::MeshShape>(physics::BuildMeshShape(positions, meshData.indices));
+}
+
+// Box of all vertices, and the smaller of two bounding spheres: Ritter's sphere and the one
+// around the box centre.
+MeshBounds ComputeMeshBounds(const MeshData& meshData)
+{
+    MeshBounds bounds;
+    if (meshData.vertices.empty())
+        return bounds;
+
+    const ecs::Vec3 first = VertexPosition(meshData.vertices.front());
+    bounds.box = physics::Aabb{ first, first };
+    for (const MeshVertex& vertex : meshData.vertices)
+    {
+        const ecs::Vec3 p = VertexPosition(vertex);
+        bounds.box.min = ecs::Vec3{ std::min(bounds.box.min.x, p.x), std::min(bounds.box.min.y, p.y), std::min(bounds.box.min.z, p.z) };
+        bounds.box.max = ecs::Vec3{ std::max(bounds.box.max.x, p.x), std::max(bounds.box.max.y, p.y), std::max(bounds.box.max.z, p.z) };
+    }
+
+    const ecs::Vec3 boxCenter{
+        (bounds.box.min.x + bounds.box.max.x) * 0.5f,
+        (bounds.box.min.y + bounds.box.max.y) * 0.5f,
+        (bounds.box.min.z + bounds.box.max.z) * 0.5f };
+    float boxRadiusSquared = 0.0f;
+    for (const MeshVertex& vertex : meshData.vertices)
+        boxRadiusSquared = std::max(boxRadiusSquared, DistanceSquared(boxCenter, VertexPosition(vertex)));
+
+    // Ritter: start from the span between the vertex farthest from an arbitrary one and the
+    // vertex farthest from that, then grow the sphere over every vertex still outside it.
+    const auto farthestFrom = [&](const ecs::Vec3& origin)
+    {
+        ecs::Vec3 farthest = origin;
+        float best = -1.0f;
+        for (const MeshVertex& vertex : meshData.vertices)
+        {
+            const ecs::Vec3 p = VertexPosition(vertex);
+            const float distance = DistanceSquared(origin, p);
+            if (distance > best)
+            {
+                best = distance;
+                farthest = p;
+            }
+        }
+        return farthest;
+    };
+    const ecs::Vec3 a = farthestFrom(first);
+    const ecs::Vec3 b = farthestFrom(a);
+    ecs::Vec3 center{ (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f };
+    float radius = std::sqrt(DistanceSquared(a, b)) * 0.5f;
+    for (const MeshVertex& vertex : meshData.vertices)
+    {
+        const ecs::Vec3 p = VertexPosition(vertex);
+        const float distance = std::sqrt(DistanceSquared(center, p));
+        if (distance <= radius)
+            continue;
+        const float grownRadius = (radius + distance) * 0.5f;
+        const float shift = (grownRadius - radius) / distance;
+        center = ecs::Vec3{ center.x + (p.x - center.x) * shift, center.y + (p.y - center.y) * shift, center.z + (p.z - center.z) * shift };
+        radius = grownRadius;
+    }
+
+    const float boxRadius = std::sqrt(boxRadiusSquared);
+    bounds.sphereCenter = radius < boxRadius ? center : boxCenter;
+    bounds.sphereRadius = std::min(radius, boxRadius);
+    return bounds;
+}
+
 bool LoadMeshBinaryCache(
     const std::filesystem::path& cachePath,
     const std::string& normalizedKey,
@@ -104,6 +244,12 @@ bool LoadMeshBinaryCache(
         }
     }
 
+    auto collisionShape = std::make_shared<physics::MeshShape>();
+    if (!ReadCollisionShape(stream, *collisionShape))
+        return false;
+    outMesh.collisionShape = std::move(collisionShape);
+    stream.read(reinterpret_cast<char*>(&outMesh.bounds), sizeof(outMesh.bounds));
+
     outMesh.name = cachePath.stem().stem().string();
     outMesh.sourcePath = normalizedKey;
     outMesh.placeholder = false;
@@ -147,6 +293,12 @@ void SaveMeshBinaryCache(const std::filesystem::path& cachePath, const MeshResou
         WriteString(stream, submesh.materialName);
         WriteString(stream, submesh.diffuseTexturePath);
     }
+
+    if (mesh.collisionShape != nullptr)
+        WriteCollisionShape(stream, *mesh.collisionShape);
+    else
+        WriteCollisionShape(stream, physics::MeshShape{});
+    stream.write(reinterpret_cast<const char*>(&mesh.bounds), sizeof(mesh.bounds));
 }
 }
 
@@ -305,11 +457,16 @@ ResourceLoadResult<MeshResource> MeshLoader::Load(const std::string& normalizedK
         return result;
     }
 
+    mesh.bounds = ComputeMeshBounds(mesh.meshData);
+    mesh.collisionShape = BakeCollisionShape(mesh.meshData);
+
     Logger::Get().Info(
         "MeshLoader: loaded key=" + normalizedKey +
         " vertices=" + std::to_string(totalVertices) +
         " indices=" + std::to_string(totalIndices) +
-        " submeshes=" + std::to_string(mesh.meshData.submeshes.size()));
+        " submeshes=" + std::to_string(mesh.meshData.submeshes.size()) +
+        " collisionTriangles=" + std::to_string(mesh.collisionShape->triangles.GetTriangleCount()) +
+        " hullVertices=" + std::to_string(mesh.collisionShape->hull.vertices.size()));
 
     SaveMeshBinaryCache(binaryCachePath, mesh);
 
@@ -345,6 +502,7 @@ MeshResource MeshLoader::CreateDefault()
             "defaults/texture"
         }
     };
+    mesh.bounds = ComputeMeshBounds(mesh.meshData);
 
     return mesh;
 }
@@ -43,6 +43,22 @@ void ReadVec3(const nlohmann::json& json, const char* key, ecs::Vec3& out)
     if (value.size() > 2) out.z = value[2].get<float>();
 }
 
+// Scene files name collider types the way EcsDemoEntityConfig::colliderType does.
+const char* ColliderTypeToString(ecs::ColliderType type)
+{
+    switch (type)
+    {
+    case ecs::ColliderType::Sphere:
+        return "sphere";
+    case ecs::ColliderType::TriangleMesh:
+        return "mesh";
+    case ecs::ColliderType::ConvexHull:
+        return "hull";
+    default:
+        return "box";
+    }
+}
+
 nlohmann::json EntityToJson(const EcsDemoEntityConfig& entity)
 {
     nlohmann::json json;
@@ -64,6 +80,14 @@ nlohmann::json EntityToJson(const EcsDemoEntityConfig& entity)
     json["simulatePhysics"] = entity.simulatePhysics;
     json["isStatic"] = entity.isStatic;
     json["useGravity"] = entity.useGravity;
+    json["continuousCollision"] = entity.continuousCollision;
+    // Only non-default filters are written, so ordinary scenes stay unchanged.
+    const EcsDemoEntityConfig defaults;
+    if (entity.collisionLayer != defaults.collisionLayer || entity.collisionMask != defaults.collisionMask)
+    {
+        json["collisionLayer"] = entity.collisionLayer;
+        json["collisionMask"] = entity.collisionMask;
+    }
     if (entity.colliderManual)
     {
         json["colliderHalfExtents"] = Vec3ToJson(entity.colliderHalfExtents);
@@ -101,6 +125,9 @@ EcsDemoEntityConfig EntityFromJson(const nlohmann::json& json)
     entity.simulatePhysics = json.value("simulatePhysics", true);
     entity.isStatic = json.value("isStatic", false);
     entity.useGravity = json.value("useGravity", true);
+    entity.continuousCollision = json.value("continuousCollision", false);
+    entity.collisionLayer = json.value("collisionLayer", entity.collisionLayer);
+    entity.collisionMask = json.value("collisionMask", entity.collisionMask);
     return entity;
 }
 }
@@ -210,13 +237,17 @@ bool SceneSerializer::SaveWorld(
                 config.isStatic = rigidbody->isStatic;
                 config.simulatePhysics = rigidbody->simulatePhysics;
                 config.useGravity = rigidbody->useGravity;
+                config.continuousCollision = rigidbody->continuousCollision;
             }
             if (const auto* collider = world.GetComponent<ecs::ColliderComponent>(entity))
             {
-                config.colliderManual = true;
-                config.colliderType = collider->type == ecs::ColliderType::Sphere ? "sphere" : "box";
+                // Auto-fit colliders are saved without extents and fitted again on load.
+                config.colliderManual = !collider->autoFitFromMesh;
+                config.colliderType = ColliderTypeToString(collider->type);
                 config.colliderHalfExtents = collider->halfExtents;
                 config.colliderOffset = collider->offset;
+                config.collisionLayer = collider->layer;
+                config.collisionMask = collider->mask;
             }
             entities.push_back(config);
         });